@@ -20,6 +20,7 @@
 // THE SOFTWARE.
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -112,7 +113,49 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
     throw bustub::Exception("should have at least 1 column");
   }
 
-  return std::make_unique<CreateStatement>(std::move(table), std::move(columns));
+  std::string format = "row";
+  std::vector<std::string> dictionary_columns;
+  if (pg_stmt->options != nullptr) {
+    for (auto c = pg_stmt->options->head; c != nullptr; c = lnext(c)) {
+      auto def = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(c->data.ptr_value);
+      auto arg = reinterpret_cast<duckdb_libpgquery::PGValue *>(def->arg);
+      auto name = std::string(def->defname);
+      if ((name != "format" && name != "dictionary") || arg == nullptr ||
+          arg->type != duckdb_libpgquery::T_PGString) {
+        throw NotImplementedException(fmt::format("table option {} is not supported", def->defname));
+      }
+      if (name == "format") {
+        format = StringUtil::Lower(arg->val.str);
+        continue;
+      }
+      // `dictionary = 'a, b'` 列出要字典编码的列
+      for (const auto &column_name : StringUtil::Split(arg->val.str, ',')) {
+        auto stripped = StringUtil::Strip(column_name, ' ');
+        auto column = std::find_if(columns.begin(), columns.end(),
+                                   [&](const Column &column) { return column.GetName() == stripped; });
+        if (column == columns.end()) {
+          throw bustub::Exception(fmt::format("dictionary column {} not found", stripped));
+        }
+        if (column->GetType() != TypeId::VARCHAR) {
+          throw NotImplementedException("only VARCHAR columns can be dictionary encoded");
+        }
+        dictionary_columns.push_back(stripped);
+      }
+    }
+  }
+  if (format != "row" && format != "pax") {
+    throw NotImplementedException(fmt::format("table format {} is not supported", format));
+  }
+  if (format == "pax") {
+    for (const auto &column : columns) {
+      if (!column.IsInlined()) {
+        throw NotImplementedException("PAX tables only support fixed-length columns");
+      }
+    }
+  }
+
+  return std::make_unique<CreateStatement>(std::move(table), std::move(columns), std::move(format),
+                                           std::move(dictionary_columns));
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
@@ -129,7 +172,36 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  std::string index_type = stmt->accessMethod;
+  if (index_type != "btree" && index_type != "hash" && index_type != "art") {
+    throw NotImplementedException(fmt::format("index type {} is not supported", index_type));
+  }
+
+  bool bloom_filter = false;
+  if (stmt->options != nullptr) {
+    for (auto c = stmt->options->head; c != nullptr; c = lnext(c)) {
+      auto def = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(c->data.ptr_value);
+      auto arg = reinterpret_cast<duckdb_libpgquery::PGValue *>(def->arg);
+      if (std::string(def->defname) != "bloom_filter" || arg == nullptr) {
+        throw NotImplementedException(fmt::format("index option {} is not supported", def->defname));
+      }
+      // `bloom_filter = true`，也接受 on 和非零整数
+      if (arg->type == duckdb_libpgquery::T_PGInteger) {
+        bloom_filter = arg->val.ival != 0;
+      } else if (arg->type == duckdb_libpgquery::T_PGString) {
+        auto flag = StringUtil::Lower(arg->val.str);
+        if (flag != "true" && flag != "on" && flag != "false" && flag != "off") {
+          throw bustub::Exception(fmt::format("invalid value {} for index option bloom_filter", arg->val.str));
+        }
+        bloom_filter = flag == "true" || flag == "on";
+      } else {
+        throw bustub::Exception("invalid value for index option bloom_filter");
+      }
+    }
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), std::move(index_type),
+                                          bloom_filter);
 }
 
 }  // namespace bustub
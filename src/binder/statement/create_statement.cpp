@@ -5,10 +5,22 @@
 
 namespace bustub {
 
-CreateStatement::CreateStatement(std::string table, std::vector<Column> columns)
-    : BoundStatement(StatementType::CREATE_STATEMENT), table_(std::move(table)), columns_(std::move(columns)) {}
+CreateStatement::CreateStatement(std::string table, std::vector<Column> columns, std::string format,
+                                 std::vector<std::string> dictionary_columns)
+    : BoundStatement(StatementType::CREATE_STATEMENT),
+      table_(std::move(table)),
+      columns_(std::move(columns)),
+      format_(std::move(format)),
+      dictionary_columns_(std::move(dictionary_columns)) {}
 
 auto CreateStatement::ToString() const -> std::string {
+  if (!dictionary_columns_.empty()) {
+    return fmt::format("BoundCreate {{\n  table={}\n  columns={}\n  format={}\n  dictionary={}\n}}", table_, columns_,
+                       format_, dictionary_columns_);
+  }
+  if (format_ != "row") {
+    return fmt::format("BoundCreate {{\n  table={}\n  columns={}\n  format={}\n}}", table_, columns_, format_);
+  }
   return fmt::format("BoundCreate {{\n  table={}\n  columns={}\n}}", table_, columns_);
 }
 
@@ -7,14 +7,22 @@
 namespace bustub {
 
 IndexStatement::IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                               std::vector<std::unique_ptr<BoundColumnRef>> cols)
+                               std::vector<std::unique_ptr<BoundColumnRef>> cols, std::string index_type,
+                               bool bloom_filter)
     : BoundStatement(StatementType::INDEX_STATEMENT),
       index_name_(std::move(index_name)),
       table_(std::move(table)),
-      cols_(std::move(cols)) {}
+      cols_(std::move(cols)),
+      index_type_(std::move(index_type)),
+      bloom_filter_(bloom_filter) {}
 
 auto IndexStatement::ToString() const -> std::string {
-  return fmt::format("BoundIndex {{ index_name={}, table={}, cols={} }}", index_name_, *table_, cols_);
+  if (bloom_filter_) {
+    return fmt::format("BoundIndex {{ index_name={}, table={}, cols={}, index_type={}, bloom_filter=true }}",
+                       index_name_, *table_, cols_, index_type_);
+  }
+  return fmt::format("BoundIndex {{ index_name={}, table={}, cols={}, index_type={} }}", index_name_, *table_, cols_,
+                     index_type_);
 }
 
 }  // namespace bustub
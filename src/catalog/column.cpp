@@ -29,7 +29,9 @@ auto Column::ToString(bool simplified) const -> std::string {
   os << "Column[" << column_name_ << ", " << Type::TypeIdToString(column_type_) << ", "
      << "Offset:" << column_offset_ << ", ";
 
-  if (IsInlined()) {
+  if (dictionary_ != nullptr) {
+    os << "Dictionary, FixedLength:" << fixed_length_;
+  } else if (IsInlined()) {
     os << "FixedLength:" << fixed_length_;
   } else {
     os << "VarLength:" << variable_length_;
@@ -1,6 +1,7 @@
 // DDL (Data Definition Language) statement handling in BusTub, including create table, create index, and set/show
 // variable.
 
+#include <algorithm>
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -36,13 +37,22 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "type/dictionary.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 void BustubInstance::HandleCreateStatement(Transaction *txn, const CreateStatement &stmt, ResultWriter &writer) {
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
-  auto info = catalog_->CreateTable(txn, stmt.table_, Schema(stmt.columns_));
+  auto format = stmt.format_ == "pax" ? TableFormat::Pax : TableFormat::Row;
+  auto columns = stmt.columns_;
+  for (auto &column : columns) {
+    if (std::find(stmt.dictionary_columns_.begin(), stmt.dictionary_columns_.end(), column.GetName()) !=
+        stmt.dictionary_columns_.end()) {
+      column = Column(column, std::make_shared<Dictionary>());
+    }
+  }
+  auto info = catalog_->CreateTable(txn, stmt.table_, Schema(columns), true, format);
   l.unlock();
 
   if (info == nullptr) {
@@ -71,10 +81,17 @@ void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement
     throw NotImplementedException("only support creating index with exactly one or two columns");
   }
 
+  auto index_type = IndexType::BPlusTreeIndex;
+  if (stmt.index_type_ == "hash") {
+    index_type = IndexType::HashTableIndex;
+  } else if (stmt.index_type_ == "art") {
+    index_type = IndexType::ARTIndex;
+  }
+
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
   auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
       txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
-      IntegerHashFunctionType{});
+      IntegerHashFunctionType{}, index_type, stmt.bloom_filter_);
   l.unlock();
 
   if (info == nullptr) {
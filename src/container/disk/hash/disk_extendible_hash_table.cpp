@@ -10,8 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -26,7 +28,16 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                          const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+  // 目录从global depth 0开始，只有一个桶
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(
+      buffer_pool_manager_->NewPage(&directory_page_id_)->GetData());
+  dir_page->SetPageId(directory_page_id_);
+  page_id_t bucket_page_id;
+  reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(buffer_pool_manager_->NewPage(&bucket_page_id)->GetData())->Init();
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  dir_page->SetLocalDepth(0, 0);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
 }
 
 /*****************************************************************************
@@ -46,22 +57,171 @@ auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+  return Hash(key) & dir_page->GetGlobalDepthMask();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+inline auto HASH_TABLE_TYPE::HashToDirectoryIndex(uint64_t hash, HashTableDirectoryPage *dir_page) -> uint32_t {
+  return static_cast<uint32_t>(hash) & dir_page->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
+  return reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+  return reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(buffer_pool_manager_->FetchPage(bucket_page_id)->GetData());
+}
+
+/*****************************************************************************
+ * OVERFLOW CHAINS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::ReleaseChainPage(page_id_t page_id, bool is_dirty) {
+  // INVALID_PAGE_ID代表链头，链头由调用者pin住并负责unpin
+  if (page_id != INVALID_PAGE_ID) {
+    buffer_pool_manager_->UnpinPage(page_id, is_dirty);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ChainGetValue(HASH_TABLE_BUCKET_TYPE *bucket_page, const KeyType &key, uint8_t fingerprint,
+                                    std::vector<ValueType> *result) -> bool {
+  bool found = false;
+  HASH_TABLE_BUCKET_TYPE *page = bucket_page;
+  page_id_t page_id = INVALID_PAGE_ID;
+  while (true) {
+    found = page->GetValue(key, fingerprint, comparator_, result) || found;
+    page_id_t next_page_id = page->GetNextPageId();
+    ReleaseChainPage(page_id, false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      return found;
+    }
+    page_id = next_page_id;
+    page = FetchBucketPage(page_id);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ChainInsert(HASH_TABLE_BUCKET_TYPE *bucket_page, const KeyType &key, const ValueType &value,
+                                  uint8_t fingerprint, bool grow) -> bool {
+  HASH_TABLE_BUCKET_TYPE *page = bucket_page;
+  page_id_t page_id = INVALID_PAGE_ID;
+  while (true) {
+    if (!page->IsFull()) {
+      page->Insert(key, value, fingerprint, comparator_);
+      ReleaseChainPage(page_id, true);
+      return true;
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      if (!grow) {
+        ReleaseChainPage(page_id, false);
+        return false;
+      }
+      auto *next_page =
+          reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(buffer_pool_manager_->NewPage(&next_page_id)->GetData());
+      next_page->Init();
+      next_page->Insert(key, value, fingerprint, comparator_);
+      page->SetNextPageId(next_page_id);
+      buffer_pool_manager_->UnpinPage(next_page_id, true);
+      ReleaseChainPage(page_id, true);
+      return true;
+    }
+    ReleaseChainPage(page_id, false);
+    page_id = next_page_id;
+    page = FetchBucketPage(page_id);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ChainRemove(HASH_TABLE_BUCKET_TYPE *bucket_page, const KeyType &key, const ValueType &value,
+                                  uint8_t fingerprint) -> bool {
+  HASH_TABLE_BUCKET_TYPE *prev_page = nullptr;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  HASH_TABLE_BUCKET_TYPE *page = bucket_page;
+  page_id_t page_id = INVALID_PAGE_ID;
+  while (true) {
+    bool removed = page->Remove(key, value, fingerprint, comparator_);
+    if (removed && prev_page != nullptr && page->IsEmpty()) {
+      // 空了的溢出页从链上摘掉
+      prev_page->SetNextPageId(page->GetNextPageId());
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      ReleaseChainPage(prev_page_id, true);
+      return true;
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    if (removed || next_page_id == INVALID_PAGE_ID) {
+      ReleaseChainPage(page_id, removed);
+      if (prev_page != nullptr) {
+        ReleaseChainPage(prev_page_id, false);
+      }
+      return removed;
+    }
+    if (prev_page != nullptr) {
+      ReleaseChainPage(prev_page_id, false);
+    }
+    prev_page = page;
+    prev_page_id = page_id;
+    page_id = next_page_id;
+    page = FetchBucketPage(page_id);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ChainHasSingleHash(HASH_TABLE_BUCKET_TYPE *bucket_page, uint32_t hash) -> bool {
+  HASH_TABLE_BUCKET_TYPE *page = bucket_page;
+  page_id_t page_id = INVALID_PAGE_ID;
+  while (true) {
+    for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE && page->IsOccupied(slot); slot++) {
+      if (page->IsReadable(slot) && Hash(page->KeyAt(slot)) != hash) {
+        ReleaseChainPage(page_id, false);
+        return false;
+      }
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    ReleaseChainPage(page_id, false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      return true;
+    }
+    page_id = next_page_id;
+    page = FetchBucketPage(page_id);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::DrainChain(HASH_TABLE_BUCKET_TYPE *bucket_page)
+    -> std::vector<std::tuple<KeyType, ValueType, uint8_t>> {
+  std::vector<std::tuple<KeyType, ValueType, uint8_t>> entries;
+  HASH_TABLE_BUCKET_TYPE *page = bucket_page;
+  page_id_t page_id = INVALID_PAGE_ID;
+  while (true) {
+    for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE && page->IsOccupied(slot); slot++) {
+      if (page->IsReadable(slot)) {
+        entries.emplace_back(page->KeyAt(slot), page->ValueAt(slot), page->FingerprintAt(slot));
+      }
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    if (page_id != INVALID_PAGE_ID) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    if (next_page_id == INVALID_PAGE_ID) {
+      break;
+    }
+    page_id = next_page_id;
+    page = FetchBucketPage(page_id);
+  }
+  bucket_page->Init();
+  return entries;
 }
 
 /*****************************************************************************
@@ -69,7 +229,20 @@ auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BU
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  page_id_t bucket_page_id = dir_page->GetBucketPageId(HashToDirectoryIndex(hash, dir_page));
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  // 溢出页由链头的latch保护
+  page->RLatch();
+  auto *bucket_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  bool found = ChainGetValue(bucket_page, key, HASH_TABLE_BUCKET_TYPE::Fingerprint(hash), result);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return found;
 }
 
 /*****************************************************************************
@@ -77,12 +250,93 @@ auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  // 桶链上还有空位时只需要目录的读锁和链头的写锁
+  uint64_t hash = hash_fn_.GetHash(key);
+  uint8_t fingerprint = HASH_TABLE_BUCKET_TYPE::Fingerprint(hash);
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  page_id_t bucket_page_id = dir_page->GetBucketPageId(HashToDirectoryIndex(hash, dir_page));
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  page->WLatch();
+  auto *bucket_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  std::vector<ValueType> values;
+  ChainGetValue(bucket_page, key, fingerprint, &values);
+  bool duplicate = std::find(values.begin(), values.end(), value) != values.end();
+  bool inserted = !duplicate && ChainInsert(bucket_page, key, value, fingerprint, false);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (duplicate || inserted) {
+    return inserted;
+  }
+  return SplitInsert(transaction, key, value, hash);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value, uint64_t hash)
+    -> bool {
+  table_latch_.WLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  uint8_t fingerprint = HASH_TABLE_BUCKET_TYPE::Fingerprint(hash);
+  bool dir_dirty = false;
+  bool inserted = false;
+  while (true) {
+    uint32_t bucket_idx = HashToDirectoryIndex(hash, dir_page);
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    HASH_TABLE_BUCKET_TYPE *bucket_page = FetchBucketPage(bucket_page_id);
+    std::vector<ValueType> values;
+    ChainGetValue(bucket_page, key, fingerprint, &values);
+    if (std::find(values.begin(), values.end(), value) != values.end()) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      break;
+    }
+    // 拿写锁之前可能已经有别人分裂过了
+    if (ChainInsert(bucket_page, key, value, fingerprint, false)) {
+      inserted = true;
+      buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+      break;
+    }
+
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    bool dir_full = local_depth == dir_page->GetGlobalDepth() && dir_page->Size() * 2 > DIRECTORY_ARRAY_SIZE;
+    if (dir_full || ChainHasSingleHash(bucket_page, static_cast<uint32_t>(hash))) {
+      // 目录不能再扩展，或者桶里的key哈希全相同、分裂也分不开，挂一个溢出页
+      inserted = ChainInsert(bucket_page, key, value, fingerprint, true);
+      buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+      break;
+    }
+    if (local_depth == dir_page->GetGlobalDepth()) {
+      dir_page->IncrGlobalDepth();
+    }
+
+    page_id_t image_page_id;
+    auto *image_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(
+        buffer_pool_manager_->NewPage(&image_page_id)->GetData());
+    image_page->Init();
+    // 所有指向旧桶的目录项local depth加一，新增的那一位为1的指向分裂出来的桶
+    uint32_t high_bit = 1U << local_depth;
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      if (dir_page->GetBucketPageId(idx) == bucket_page_id) {
+        dir_page->SetLocalDepth(idx, local_depth + 1);
+        if ((idx & high_bit) != 0) {
+          dir_page->SetBucketPageId(idx, image_page_id);
+        }
+      }
+    }
+    dir_dirty = true;
+
+    // 整条链的内容重新分到两个桶里
+    for (const auto &[slot_key, slot_value, slot_fingerprint] : DrainChain(bucket_page)) {
+      auto *target_page = KeyToPageId(slot_key, dir_page) == image_page_id ? image_page : bucket_page;
+      ChainInsert(target_page, slot_key, slot_value, slot_fingerprint, true);
+    }
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+  table_latch_.WUnlock();
+  return inserted;
 }
 
 /*****************************************************************************
@@ -90,14 +344,77 @@ auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  page_id_t bucket_page_id = dir_page->GetBucketPageId(HashToDirectoryIndex(hash, dir_page));
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  page->WLatch();
+  auto *bucket_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  bool removed = ChainRemove(bucket_page, key, value, HASH_TABLE_BUCKET_TYPE::Fingerprint(hash));
+  bool empty = bucket_page->IsEmpty() && bucket_page->GetNextPageId() == INVALID_PAGE_ID;
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, removed);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (removed && empty) {
+    Merge(transaction, key, value);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  bool dir_dirty = false;
+  while (true) {
+    uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == 0) {
+      break;
+    }
+    uint32_t image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    if (dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    HASH_TABLE_BUCKET_TYPE *bucket_page = FetchBucketPage(bucket_page_id);
+    bool empty = bucket_page->IsEmpty() && bucket_page->GetNextPageId() == INVALID_PAGE_ID;
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    if (!empty) {
+      // 拿写锁之前又被插入了
+      break;
+    }
+    // 空桶并入它的split image，指向两者的目录项local depth都减一
+    page_id_t image_page_id = dir_page->GetBucketPageId(image_idx);
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      page_id_t page_id = dir_page->GetBucketPageId(idx);
+      if (page_id == bucket_page_id || page_id == image_page_id) {
+        dir_page->SetBucketPageId(idx, image_page_id);
+        dir_page->SetLocalDepth(idx, local_depth - 1);
+      }
+    }
+    buffer_pool_manager_->DeletePage(bucket_page_id);
+    while (dir_page->CanShrink()) {
+      dir_page->DecrGlobalDepth();
+    }
+    dir_dirty = true;
+
+    // 合并后的桶如果也是空的，继续往上合并
+    HASH_TABLE_BUCKET_TYPE *merged_page = FetchBucketPage(image_page_id);
+    empty = merged_page->IsEmpty() && merged_page->GetNextPageId() == INVALID_PAGE_ID;
+    buffer_pool_manager_->UnpinPage(image_page_id, false);
+    if (!empty) {
+      break;
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+  table_latch_.WUnlock();
+}
 
 /*****************************************************************************
  * GETGLOBALDEPTH - DO NOT TOUCH
@@ -10,13 +10,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "common/rid.h"
 #include "container/disk/hash/linear_probe_hash_table.h"
 
@@ -26,21 +29,190 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  header_page_id_ = NewTable(num_buckets);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetHeaderPage(page_id_t header_page_id) -> HashTableHeaderPage * {
+  return reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id)->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE * {
+  return reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(buffer_pool_manager_->FetchPage(block_page_id)->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::BlockSpan(size_t num_blocks) -> size_t {
+  size_t span = 1;
+  while (span * HashTableHeaderPage::MaxBlocks() < num_blocks) {
+    span *= HashTableHeaderPage::MaxBlocks();
+  }
+  return span;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetBlockPageId(HashTableHeaderPage *header_page, size_t block_idx) -> page_id_t {
+  // 块太多时header page存的是下一层header page，每个覆盖span个块
+  size_t span = BlockSpan(header_page->GetSize() / BLOCK_ARRAY_SIZE);
+  page_id_t page_id = header_page->GetBlockPageId(block_idx / span);
+  while (span > 1) {
+    block_idx %= span;
+    span /= HashTableHeaderPage::MaxBlocks();
+    page_id_t child_page_id = GetHeaderPage(page_id)->GetBlockPageId(block_idx / span);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = child_page_id;
+  }
+  return page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+auto HASH_TABLE_TYPE::Probe(HashTableHeaderPage *header_page, const KeyType &key, Visitor &&visit, bool *matched)
+    -> size_t {
+  *matched = false;
+  size_t size = header_page->GetSize();
+  size_t start = hash_fn_.GetHash(key) % size;
+  page_id_t block_page_id = INVALID_PAGE_ID;
+  HASH_TABLE_BLOCK_TYPE *block_page = nullptr;
+  size_t stop = size;
+  for (size_t i = 0; i < size; i++) {
+    size_t slot = (start + i) % size;
+    slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+    if (block_page == nullptr || offset == 0) {
+      if (block_page != nullptr) {
+        buffer_pool_manager_->UnpinPage(block_page_id, false);
+      }
+      block_page_id = GetBlockPageId(header_page, slot / BLOCK_ARRAY_SIZE);
+      block_page = GetBlockPage(block_page_id);
+    }
+    // 从未被占用过的槽位是探测链的终点，墓碑要继续往后找
+    if (!block_page->IsOccupied(offset)) {
+      stop = slot;
+      break;
+    }
+    if (block_page->IsReadable(offset) && comparator_(block_page->KeyAt(offset), key) == 0 &&
+        visit(block_page->ValueAt(offset))) {
+      *matched = true;
+      stop = slot;
+      break;
+    }
+  }
+  if (block_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+  }
+  return stop;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::InsertInto(HashTableHeaderPage *header_page, size_t slot, const KeyType &key,
+                                 const ValueType &value) -> bool {
+  if (slot >= header_page->GetSize()) {
+    return false;
+  }
+  page_id_t block_page_id = GetBlockPageId(header_page, slot / BLOCK_ARRAY_SIZE);
+  auto *block_page = GetBlockPage(block_page_id);
+  bool inserted = block_page->Insert(slot % BLOCK_ARRAY_SIZE, key, value);
+  buffer_pool_manager_->UnpinPage(block_page_id, inserted);
+  if (inserted) {
+    num_occupied_++;
+  }
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::RemoveFrom(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> bool {
+  auto *header_page = GetHeaderPage(header_page_id);
+  bool matched;
+  size_t slot = Probe(
+      header_page, key, [&value](const ValueType &v) { return v == value; }, &matched);
+  if (matched) {
+    page_id_t block_page_id = GetBlockPageId(header_page, slot / BLOCK_ARRAY_SIZE);
+    GetBlockPage(block_page_id)->Remove(slot % BLOCK_ARRAY_SIZE);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  return matched;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ContainsPair(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> bool {
+  auto *header_page = GetHeaderPage(header_page_id);
+  bool matched;
+  Probe(
+      header_page, key, [&value](const ValueType &v) { return v == value; }, &matched);
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  return matched;
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  size_t found = result->size();
+  auto collect = [result](const ValueType &v) {
+    result->push_back(v);
+    return false;
+  };
+  bool matched;
+  // 迁移中的表项要么还在旧表，要么已经搬到新表，两边都要查
+  for (page_id_t header_page_id : {old_header_page_id_, header_page_id_}) {
+    if (header_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    Probe(GetHeaderPage(header_page_id), key, collect, &matched);
+    buffer_pool_manager_->UnpinPage(header_page_id, false);
+  }
+  table_latch_.RUnlock();
+  return result->size() > found;
 }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  MigrateSlots(migrate_step_);
+  if (old_header_page_id_ != INVALID_PAGE_ID && ContainsPair(old_header_page_id_, key, value)) {
+    table_latch_.WUnlock();
+    return false;
+  }
+
+  auto *header_page = GetHeaderPage(header_page_id_);
+  size_t size = header_page->GetSize();
+  bool matched;
+  size_t slot = Probe(
+      header_page, key, [&value](const ValueType &v) { return v == value; }, &matched);
+  if (matched) {
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    table_latch_.WUnlock();
+    return false;
+  }
+
+  // 装载因子(包括墓碑)超过3/4就扩容
+  if ((num_occupied_ + 1) * 4 > size * 3 || slot == size) {
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    // 迁移步长保证旧表此时已经搬空；有效表项不到一半时只重建同样大小的表，用来清理墓碑
+    StartResize(num_items_ * 2 >= size ? size * 2 : size);
+    header_page = GetHeaderPage(header_page_id_);
+    slot = Probe(
+        header_page, key, [](const ValueType &v) { return false; }, &matched);
+  }
+
+  bool inserted = InsertInto(header_page, slot, key, value);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (inserted) {
+    num_items_++;
+  }
+  table_latch_.WUnlock();
+  return inserted;
 }
 
 /*****************************************************************************
@@ -48,21 +220,164 @@ auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  MigrateSlots(migrate_step_);
+  bool removed = (old_header_page_id_ != INVALID_PAGE_ID && RemoveFrom(old_header_page_id_, key, value)) ||
+                 RemoveFrom(header_page_id_, key, value);
+  if (removed) {
+    num_items_--;
+  }
+  table_latch_.WUnlock();
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  MigrateSlots(std::numeric_limits<size_t>::max());
+  StartResize(initial_size * 2);
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::NewTable(size_t num_slots) -> page_id_t {
+  size_t num_blocks = std::max<size_t>((num_slots + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE, 1);
+  return NewHeaderPage(num_blocks, BlockSpan(num_blocks));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::NewHeaderPage(size_t num_blocks, size_t span) -> page_id_t {
+  page_id_t header_page_id;
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->NewPage(&header_page_id)->GetData());
+  header_page->SetPageId(header_page_id);
+  header_page->SetSize(num_blocks * BLOCK_ARRAY_SIZE);
+  if (span == 1) {
+    CreateNewBlockPages(header_page, num_blocks);
+  } else {
+    for (size_t first = 0; first < num_blocks; first += span) {
+      header_page->AddBlockPageId(
+          NewHeaderPage(std::min(span, num_blocks - first), span / HashTableHeaderPage::MaxBlocks()));
+    }
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, true);
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks) {
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    buffer_pool_manager_->NewPage(&block_page_id);
+    header_page->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::DeleteTable(page_id_t header_page_id, size_t span) {
+  auto *header_page = GetHeaderPage(header_page_id);
+  for (size_t i = 0; i < header_page->NumBlocks(); i++) {
+    if (span == 1) {
+      buffer_pool_manager_->DeletePage(header_page->GetBlockPageId(i));
+    } else {
+      DeleteTable(header_page->GetBlockPageId(i), span / HashTableHeaderPage::MaxBlocks());
+    }
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  buffer_pool_manager_->DeletePage(header_page_id);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::StartResize(size_t num_slots) {
+  BUSTUB_ASSERT(old_header_page_id_ == INVALID_PAGE_ID, "previous resize must be finished");
+  auto *old_header_page = GetHeaderPage(header_page_id_);
+  size_t old_size = old_header_page->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  old_header_page_id_ = header_page_id_;
+  header_page_id_ = NewTable(num_slots);
+  migrate_cursor_ = 0;
+  num_occupied_ = 0;
+  // 旧表全部搬过来后，新表离扩容阈值还能再插入headroom个表项。每次写操作搬的槽位数
+  // 要保证用掉一半余量之前旧表就搬空了，这样下一次扩容时不会还有没结束的迁移
+  size_t threshold = (num_slots + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE * BLOCK_ARRAY_SIZE * 3 / 4;
+  size_t ops = std::max<size_t>((threshold - std::min(num_items_, threshold)) / 2, 1);
+  migrate_step_ = std::max(LINEAR_PROBE_MIGRATE_SLOTS, (old_size + ops - 1) / ops);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MigrateSlots(size_t max_slots) {
+  if (old_header_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  auto *old_header_page = GetHeaderPage(old_header_page_id_);
+  auto *header_page = GetHeaderPage(header_page_id_);
+  size_t old_size = old_header_page->GetSize();
+  size_t end = old_size - migrate_cursor_ <= max_slots ? old_size : migrate_cursor_ + max_slots;
+
+  page_id_t block_page_id = INVALID_PAGE_ID;
+  HASH_TABLE_BLOCK_TYPE *block_page = nullptr;
+  bool dirty = false;
+  bool matched;
+  for (; migrate_cursor_ < end; migrate_cursor_++) {
+    slot_offset_t offset = migrate_cursor_ % BLOCK_ARRAY_SIZE;
+    if (block_page == nullptr || offset == 0) {
+      if (block_page != nullptr) {
+        buffer_pool_manager_->UnpinPage(block_page_id, dirty);
+      }
+      block_page_id = GetBlockPageId(old_header_page, migrate_cursor_ / BLOCK_ARRAY_SIZE);
+      block_page = GetBlockPage(block_page_id);
+      dirty = false;
+    }
+    if (!block_page->IsReadable(offset)) {
+      continue;
+    }
+    KeyType key = block_page->KeyAt(offset);
+    ValueType value = block_page->ValueAt(offset);
+    size_t slot = Probe(
+        header_page, key, [](const ValueType &v) { return false; }, &matched);
+    bool inserted = InsertInto(header_page, slot, key, value);
+    BUSTUB_ASSERT(inserted, "new table must have room for the migrated entries");
+    // 搬走的表项从旧表删掉，查询两张表时才不会重复
+    block_page->Remove(offset);
+    dirty = true;
+  }
+  if (block_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(block_page_id, dirty);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+
+  if (migrate_cursor_ < old_size) {
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+    return;
+  }
+  buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  DeleteTable(old_header_page_id_, BlockSpan(old_size / BLOCK_ARRAY_SIZE));
+  old_header_page_id_ = INVALID_PAGE_ID;
+  migrate_cursor_ = 0;
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetSize() -> size_t {
-  return 0;
+  table_latch_.RLock();
+  auto *header_page = GetHeaderPage(header_page_id_);
+  size_t size = header_page->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::IsMigrating() -> bool {
+  table_latch_.RLock();
+  bool migrating = old_header_page_id_ != INVALID_PAGE_ID;
+  table_latch_.RUnlock();
+  return migrating;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.cpp
+//
+// Identification: src/container/hash/bloom_filter.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/bloom_filter.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+BlockedBloomFilter::BlockedBloomFilter(size_t expected_keys)
+    : blocks_(std::max<size_t>(1, (expected_keys * BITS_PER_KEY + sizeof(Block) * 8 - 1) / (sizeof(Block) * 8)),
+              Block{}) {}
+
+KeyBloomFilter::KeyBloomFilter(size_t expected_keys) : capacity_(std::max<size_t>(expected_keys, 1024)) {
+  filters_.emplace_back(capacity_);
+}
+
+auto KeyBloomFilter::KeyHash(const Tuple &key, const Schema &key_schema) -> hash_t {
+  hash_t hash = 0;
+  for (uint32_t i = 0; i < key_schema.GetColumnCount(); i++) {
+    auto value = key.GetValue(&key_schema, i);
+    if (value.IsNull()) {
+      continue;
+    }
+    // HashUtil::HashValue 对相近的整数冲突很多，整数直接按 BIGINT 的值混合
+    hash_t column_hash;
+    switch (value.GetTypeId()) {
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT:
+        column_hash = static_cast<hash_t>(value.CastAs(TypeId::BIGINT).GetAs<int64_t>());
+        break;
+      default:
+        column_hash = HashUtil::HashValue(&value);
+    }
+    hash = BlockedBloomFilter::Mix(hash + column_hash);
+  }
+  return hash;
+}
+
+void KeyBloomFilter::Insert(const Tuple &key, const Schema &key_schema) {
+  auto hash = KeyHash(key, key_schema);
+  latch_.WLock();
+  if (size_ == capacity_) {
+    capacity_ *= 2;
+    size_ = 0;
+    filters_.emplace_back(capacity_);
+  }
+  filters_.back().Insert(hash);
+  size_++;
+  latch_.WUnlock();
+}
+
+auto KeyBloomFilter::MayContain(const Tuple &key, const Schema &key_schema) const -> bool {
+  auto hash = KeyHash(key, key_schema);
+  latch_.RLock();
+  bool found = std::any_of(filters_.begin(), filters_.end(),
+                           [hash](const BlockedBloomFilter &filter) { return filter.MayContain(hash); });
+  latch_.RUnlock();
+  return found;
+}
+
+}  // namespace bustub
@@ -37,28 +37,24 @@ void AggregationExecutor::Init() {
   std::vector<AbstractExpressionRef> aggregates = plan_->GetAggregates();
   std::vector<AbstractExpressionRef> group_bys = plan_->GetGroupBys();
   std::vector<AggregationType> arr_types = plan_->GetAggregateTypes();
-  Tuple produce_tuple;
-  RID produce_rid;
   AggregateKey key;
   AggregateValue val;
   aht_.Clear();
   child_executor_->Init();
-  while (child_executor_->Next(&produce_tuple, &produce_rid)) {
-    for (auto &it : group_bys) {
-      key.group_bys_.push_back(it->Evaluate(&produce_tuple, child_executor_->GetOutputSchema()));
+  // 按批从子节点取，每行不再需要一次虚调用和一个Tuple
+  VectorBatch batch;
+  while (child_executor_->NextBatch(&batch)) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      for (auto &it : group_bys) {
+        key.group_bys_.push_back(it->EvaluateBatch(batch, i));
+      }
+      for (auto &it : aggregates) {
+        val.aggregates_.push_back(it->EvaluateBatch(batch, i));
+      }
+      aht_.InsertCombine(key, val);
+      key.group_bys_.clear();
+      val.aggregates_.clear();
     }
-    for (auto &it : aggregates) {
-      val.aggregates_.push_back(it->Evaluate(&produce_tuple, child_executor_->GetOutputSchema()));
-    }
-    // for(auto i : key.group_bys_){
-    //   fmt::print("The key is: {}\n", i);
-    // }
-    // for(auto i : val.aggregates_){
-    //   fmt::print("The val is: {}\n", i);
-    // }
-    aht_.InsertCombine(key, val);
-    key.group_bys_.clear();
-    val.aggregates_.clear();
   }
   if (aht_.Begin() == aht_.End() && group_bys.empty()) {
     key.group_bys_.clear();
@@ -91,6 +87,18 @@ auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   return false;
 }
 
+auto AggregationExecutor::NextBatch(VectorBatch *batch) -> bool {
+  batch->Reset(GetOutputSchema());
+  std::vector<Value> values;
+  for (; aht_iterator_ != aht_.End() && !batch->IsFull(); ++aht_iterator_) {
+    values = aht_iterator_.Key().group_bys_;
+    const auto &aggregates = aht_iterator_.Val().aggregates_;
+    values.insert(values.end(), aggregates.begin(), aggregates.end());
+    batch->AppendRow(values, RID{});
+  }
+  return batch->Size() > 0;
+}
+
 auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_executor_.get(); }
 
 }  // namespace bustub
@@ -31,4 +31,21 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
 }
 
+auto FilterExecutor::NextBatch(VectorBatch *batch) -> bool {
+  auto filter_expr = plan_->GetPredicate();
+  batch->Reset(GetOutputSchema());
+  while (batch->Size() == 0) {
+    if (!child_executor_->NextBatch(&child_batch_)) {
+      return false;
+    }
+    for (size_t i = 0; i < child_batch_.Size(); i++) {
+      auto value = filter_expr->EvaluateBatch(child_batch_, i);
+      if (!value.IsNull() && value.GetAs<bool>()) {
+        batch->AppendRowFrom(child_batch_, i);
+      }
+    }
+  }
+  return true;
+}
+
 }  // namespace bustub
@@ -31,77 +31,59 @@ void HashJoinExecutor::Init() {
   //  throw NotImplementedException("HashJoinExecutor is not implemented");
   std::vector<AbstractExpressionRef> left_expr = plan_->left_key_expressions_;
   std::vector<AbstractExpressionRef> right_expr = plan_->right_key_expressions_;
-  uint32_t right_count = plan_->GetRightPlan()->OutputSchema().GetColumnCount();
-  uint32_t left_count = plan_->GetLeftPlan()->OutputSchema().GetColumnCount();
+  const auto &left_schema = plan_->GetLeftPlan()->OutputSchema();
+  const auto &right_schema = plan_->GetRightPlan()->OutputSchema();
   left_child_->Init();
   right_child_->Init();
-  Tuple produce_tuple;
-  RID produce_rid;
+  ht_.clear();
+  output_.clear();
+  // 两边都按批读，键在批上求值
+  VectorBatch batch;
   HashJoinKey key;
-  HashJoinValue value;
-  while (right_child_->Next(&produce_tuple, &produce_rid)) {
-    for (auto &it : right_expr) {
-      // fmt::print("The Evaluate is: {}\n", it);
-      key.keys_.emplace_back(it->Evaluate(&produce_tuple, plan_->GetRightPlan()->OutputSchema()));
-      // fmt::print("The Evaluate is: {}\n", key.keys_.back());
-      // for (uint32_t i = 0; i < right_count; i++) {
-      //   fmt::print("The GetValue is: {}\n", produce_tuple.GetValue(&plan_->GetRightPlan()->OutputSchema(), i));
-      // }
-      // fmt::print("The right_expr is: {}\n", it);
-    }
-    if (ht_.find(key) == ht_.end()) {
-      ht_[key] = std::vector<Tuple>{produce_tuple};
-    } else {
-      ht_[key].push_back(produce_tuple);
+  while (right_child_->NextBatch(&batch)) {
+    for (size_t row = 0; row < batch.Size(); row++) {
+      key.keys_.clear();
+      for (auto &it : right_expr) {
+        key.keys_.emplace_back(it->EvaluateBatch(batch, row));
+      }
+      ht_[key].push_back(batch.GetTuple(row, right_schema));
     }
-    key.keys_.clear();
   }
-  if (plan_->GetJoinType() == JoinType::LEFT) {
-    while (left_child_->Next(&produce_tuple, &produce_rid)) {
+  // 探测大多落空时，先查缓存行大小的布隆过滤器比查哈希表便宜
+  filter_.emplace(ht_.size());
+  for (const auto &[build_key, tuples] : ht_) {
+    filter_->Insert(std::hash<HashJoinKey>{}(build_key));
+  }
+  std::vector<Value> values;
+  while (left_child_->NextBatch(&batch)) {
+    for (size_t row = 0; row < batch.Size(); row++) {
       key.keys_.clear();
       for (auto &it : left_expr) {
-        key.keys_.emplace_back(it->Evaluate(&produce_tuple, plan_->GetLeftPlan()->OutputSchema()));
+        key.keys_.emplace_back(it->EvaluateBatch(batch, row));
       }
-      if (ht_.find(key) == ht_.end()) {
-        std::vector<Value> values;
-        for (uint32_t i = 0; i < left_count; i++) {
-          values.push_back(produce_tuple.GetValue(&plan_->GetLeftPlan()->OutputSchema(), i));
-        }
-        for (uint32_t i = 0; i < right_count; i++) {
-          values.push_back(
-              ValueFactory::GetNullValueByType(plan_->GetRightPlan()->OutputSchema().GetColumn(i).GetType()));
-        }
-        output_.emplace_back(values, &GetOutputSchema());
-      } else {
-        for (auto &it : ht_[key]) {
-          std::vector<Value> values;
-          for (uint32_t j = 0; j < left_count; j++) {
-            values.push_back(produce_tuple.GetValue(&plan_->GetLeftPlan()->OutputSchema(), j));
+      auto match = filter_->MayContain(std::hash<HashJoinKey>{}(key)) ? ht_.find(key) : ht_.end();
+      if (match == ht_.end()) {
+        if (plan_->GetJoinType() == JoinType::LEFT) {
+          values.clear();
+          for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+            values.push_back(batch.GetValue(i, row));
           }
-          for (uint32_t j = 0; j < right_count; j++) {
-            values.push_back(it.GetValue(&plan_->GetRightPlan()->OutputSchema(), j));
+          for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+            values.push_back(ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
           }
           output_.emplace_back(values, &GetOutputSchema());
         }
+        continue;
       }
-    }
-  } else if (plan_->GetJoinType() == JoinType::INNER) {
-    while (left_child_->Next(&produce_tuple, &produce_rid)) {
-      key.keys_.clear();
-      for (auto &it : left_expr) {
-        key.keys_.emplace_back(it->Evaluate(&produce_tuple, plan_->GetLeftPlan()->OutputSchema()));
-      }
-      if (ht_.find(key) != ht_.end()) {
-        for (const auto &tuple : ht_[key]) {
-          std::vector<Value> values;
-          for (uint32_t j = 0; j < left_count; j++) {
-            values.push_back(produce_tuple.GetValue(&plan_->GetLeftPlan()->OutputSchema(), j));
-          }
-          for (uint32_t j = 0; j < right_count; j++) {
-            values.push_back(tuple.GetValue(&plan_->GetRightPlan()->OutputSchema(), j));
-          }
-          output_.emplace_back(values, &GetOutputSchema());
+      for (const auto &tuple : match->second) {
+        values.clear();
+        for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+          values.push_back(batch.GetValue(i, row));
+        }
+        for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+          values.push_back(tuple.GetValue(&right_schema, i));
         }
+        output_.emplace_back(values, &GetOutputSchema());
       }
     }
   }
@@ -117,4 +99,12 @@ auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   return true;
 }
 
+auto HashJoinExecutor::NextBatch(VectorBatch *batch) -> bool {
+  batch->Reset(GetOutputSchema());
+  for (; iterator_ != output_.end() && !batch->IsFull(); ++iterator_) {
+    batch->AppendTuple(*iterator_, GetOutputSchema());
+  }
+  return batch->Size() > 0;
+}
+
 }  // namespace bustub
@@ -22,13 +22,40 @@ void IndexScanExecutor::Init() {
   index_oid_t index_id = plan_->GetIndexOid();
   index_info_ = exec_ctx_->GetCatalog()->GetIndex(index_id);
   table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_);
+  if (plan_->pred_key_ != nullptr) {
+    // 点查，任何类型的索引都可以
+    Value key_value = plan_->pred_key_->Evaluate(nullptr, GetOutputSchema());
+    Tuple key({key_value}, &index_info_->key_schema_);
+    rids_.clear();
+    rid_index_ = 0;
+    if (index_info_->MayContain(key)) {
+      index_info_->index_->ScanKey(key, &rids_, exec_ctx_->GetTransaction());
+    }
+    return;
+  }
   tree_ = dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(index_info_->index_.get());
+  delete iterator_;
   iterator_ = new IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>(tree_->GetBeginIterator());
 }
 
 auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   TupleMeta meta;
+  if (plan_->pred_key_ != nullptr) {
+    while (rid_index_ < rids_.size()) {
+      *rid = rids_[rid_index_++];
+      auto [tuple_meta, table_tuple] = table_info_->table_->GetTuple(*rid);
+      if (!tuple_meta.is_deleted_) {
+        *tuple = table_tuple;
+        return true;
+      }
+    }
+    return false;
+  }
 
+  // 扫完时迭代器已经释放了，NextBatch可能还会再调用一次
+  if (iterator_ == nullptr) {
+    return false;
+  }
   while (!iterator_->IsEnd()) {
     *rid = iterator_->operator*().second;
     meta = table_info_->table_->GetTupleMeta(*rid);
@@ -40,6 +67,7 @@ auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
   if (iterator_->IsEnd()) {
     delete iterator_;
+    iterator_ = nullptr;
     return false;
   }
   *tuple = table_info_->table_->GetTuple(*rid).second;
@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "execution/executors/insert_executor.h"
 
@@ -24,6 +26,9 @@ void InsertExecutor::Init() {
   table_id_ = plan_->TableOid();
   table_info_ = exec_ctx_->GetCatalog()->GetTable(table_id_);
   index_list_ = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
+  const auto &columns = table_info_->schema_.GetColumns();
+  encode_rows_ = std::any_of(columns.begin(), columns.end(),
+                             [](const Column &column) { return column.GetDictionary() != nullptr; });
 
   if (!exec_ctx_->GetLockManager()->LockTable(exec_ctx_->GetTransaction(), LockManager::LockMode::INTENTION_EXCLUSIVE,
                                               table_id_)) {
@@ -48,15 +53,24 @@ auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
     if (!status) {
       break;
     }
+    if (encode_rows_) {
+      const auto &child_schema = child_executor_->GetOutputSchema();
+      std::vector<Value> values;
+      values.reserve(child_schema.GetColumnCount());
+      for (uint32_t i = 0; i < child_schema.GetColumnCount(); i++) {
+        values.push_back(produce_tuple.GetValue(&child_schema, i));
+      }
+      produce_tuple = Tuple(values, &table_info_->schema_);
+    }
     // InsertTuple会自动对row加锁
     std::optional<RID> rid_tmp = table_info_->table_->InsertTuple(meta, produce_tuple, exec_ctx_->GetLockManager(),
                                                                   exec_ctx_->GetTransaction(), table_id_);
     count++;
     if (!index_list_.empty()) {
       for (auto &index_info : index_list_) {
-        index_info->index_->InsertEntry(produce_tuple.KeyFromTuple(table_info_->schema_, index_info->key_schema_,
-                                                                   index_info->index_->GetKeyAttrs()),
-                                        rid_tmp.value(), exec_ctx_->GetTransaction());
+        index_info->InsertEntry(produce_tuple.KeyFromTuple(table_info_->schema_, index_info->key_schema_,
+                                                           index_info->index_->GetKeyAttrs()),
+                                rid_tmp.value(), exec_ctx_->GetTransaction());
       }
     }
   }
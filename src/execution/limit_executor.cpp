@@ -32,4 +32,13 @@ auto LimitExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   return child_executor_->Next(tuple, rid);
 }
 
+auto LimitExecutor::NextBatch(VectorBatch *batch) -> bool {
+  if (cursor_ == plan_->GetLimit() || !child_executor_->NextBatch(batch)) {
+    return false;
+  }
+  batch->Truncate(plan_->GetLimit() - cursor_);
+  cursor_ += batch->Size();
+  return true;
+}
+
 }  // namespace bustub
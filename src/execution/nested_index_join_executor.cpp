@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "execution/executors/nested_index_join_executor.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -21,10 +22,67 @@ NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const Ne
     // Note for 2023 Spring: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
+  plan_ = plan;
+  child_executor_ = std::move(child_executor);
 }
 
-void NestIndexJoinExecutor::Init() { throw NotImplementedException("NestIndexJoinExecutor is not implemented"); }
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid());
+  pending_.clear();
+  pending_index_ = 0;
+}
+
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  const auto &inner_schema = plan_->InnerTableSchema();
+  Tuple outer_tuple;
+  RID outer_rid;
+  while (pending_index_ == pending_.size()) {
+    if (!child_executor_->Next(&outer_tuple, &outer_rid)) {
+      return false;
+    }
+    pending_.clear();
+    pending_index_ = 0;
+
+    std::vector<Value> outer_values;
+    for (uint32_t i = 0; i < outer_schema.GetColumnCount(); i++) {
+      outer_values.push_back(outer_tuple.GetValue(&outer_schema, i));
+    }
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+    // 用外表的值在内表索引上点查
+    Value key_value = plan_->KeyPredicate()->Evaluate(&outer_tuple, outer_schema);
+    std::vector<RID> rids;
+    if (!key_value.IsNull()) {
+      Tuple key({key_value}, &index_info_->key_schema_);
+      // 布隆过滤器判定不存在的键不用查索引
+      if (index_info_->MayContain(key)) {
+        index_info_->index_->ScanKey(key, &rids, exec_ctx_->GetTransaction());
+      }
+    }
+    for (const auto &inner_rid : rids) {
+      auto [meta, inner_tuple] = table_info_->table_->GetTuple(inner_rid);
+      if (meta.is_deleted_) {
+        continue;
+      }
+      std::vector<Value> values = outer_values;
+      for (uint32_t i = 0; i < inner_schema.GetColumnCount(); i++) {
+        values.push_back(inner_tuple.GetValue(&inner_schema, i));
+      }
+      pending_.emplace_back(values, &GetOutputSchema());
+    }
+
+    if (pending_.empty() && plan_->GetJoinType() == JoinType::LEFT) {
+      std::vector<Value> values = outer_values;
+      for (uint32_t i = 0; i < inner_schema.GetColumnCount(); i++) {
+        values.push_back(ValueFactory::GetNullValueByType(inner_schema.GetColumn(i).GetType()));
+      }
+      pending_.emplace_back(values, &GetOutputSchema());
+    }
+  }
+  *tuple = pending_[pending_index_++];
+  return true;
+}
 
 }  // namespace bustub
@@ -33,4 +33,23 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
 
   return true;
 }
+
+auto ProjectionExecutor::NextBatch(VectorBatch *batch) -> bool {
+  batch->Reset(GetOutputSchema());
+  if (!child_executor_->NextBatch(&child_batch_)) {
+    return false;
+  }
+  const auto &exprs = plan_->GetExpressions();
+  for (uint32_t i = 0; i < exprs.size(); i++) {
+    auto &column = batch->GetColumn(i);
+    for (size_t j = 0; j < child_batch_.Size(); j++) {
+      column.Append(exprs[i]->EvaluateBatch(child_batch_, j));
+    }
+  }
+  for (size_t j = 0; j < child_batch_.Size(); j++) {
+    batch->AppendRid(child_batch_.GetRid(j));
+  }
+  return true;
+}
+
 }  // namespace bustub
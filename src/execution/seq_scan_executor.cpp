@@ -10,54 +10,292 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "execution/executors/seq_scan_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "type/dictionary.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
+namespace {
+
+auto IsNumeric(TypeId type) -> bool {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT ||
+         type == TypeId::DECIMAL;
+}
+
+// 过滤条件里用AND连接的"列 比较 常量"可以用zone map剪枝，其他条件只在行上算
+void CollectZoneRanges(const AbstractExpression *expr, const Schema &schema, const ZoneMap &zone_map,
+                       std::vector<ZoneRange> *ranges) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr); logic != nullptr) {
+    if (logic->logic_type_ == LogicType::And) {
+      CollectZoneRanges(logic->GetChildAt(0).get(), schema, zone_map, ranges);
+      CollectZoneRanges(logic->GetChildAt(1).get(), schema, zone_map, ranges);
+    }
+    return;
+  }
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(expr);
+  if (comparison == nullptr) {
+    return;
+  }
+  auto comp_type = comparison->comp_type_;
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+  if (column == nullptr || constant == nullptr) {
+    // 常量在左边，把比较方向反过来
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+    switch (comp_type) {
+      case ComparisonType::LessThan:
+        comp_type = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        comp_type = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        comp_type = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        comp_type = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  if (column == nullptr || constant == nullptr || !zone_map.IsTracked(column->GetColIdx()) ||
+      constant->val_.IsNull()) {
+    return;
+  }
+  auto column_type = schema.GetColumn(column->GetColIdx()).GetType();
+  auto constant_type = constant->val_.GetTypeId();
+  if (column_type != constant_type && !(IsNumeric(column_type) && IsNumeric(constant_type))) {
+    return;
+  }
+  ZoneRange range{column->GetColIdx(), std::nullopt, true, std::nullopt, true};
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      range.lower_ = constant->val_;
+      range.upper_ = constant->val_;
+      break;
+    case ComparisonType::LessThan:
+      range.upper_ = constant->val_;
+      range.upper_inclusive_ = false;
+      break;
+    case ComparisonType::LessThanOrEqual:
+      range.upper_ = constant->val_;
+      break;
+    case ComparisonType::GreaterThan:
+      range.lower_ = constant->val_;
+      range.lower_inclusive_ = false;
+      break;
+    case ComparisonType::GreaterThanOrEqual:
+      range.lower_ = constant->val_;
+      break;
+    case ComparisonType::NotEqual:
+      return;
+  }
+  ranges->push_back(std::move(range));
+}
+
+// 和字典编码列做等值比较的字符串常量换成从字典解码出来的值，这样每行只比较编码
+auto EncodeDictionaryConstants(const AbstractExpressionRef &expr, const Schema &schema) -> AbstractExpressionRef {
+  if (const auto *comparison = dynamic_cast<const ComparisonExpression *>(expr.get()); comparison != nullptr) {
+    if (comparison->comp_type_ != ComparisonType::Equal && comparison->comp_type_ != ComparisonType::NotEqual) {
+      return expr;
+    }
+    size_t constant_idx = 1;
+    const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+    const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+    if (column == nullptr) {
+      constant_idx = 0;
+      column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+      constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+    }
+    if (column == nullptr || constant == nullptr || constant->val_.GetTypeId() != TypeId::VARCHAR ||
+        constant->val_.IsNull()) {
+      return expr;
+    }
+    auto *dictionary = schema.GetColumn(column->GetColIdx()).GetDictionary();
+    if (dictionary == nullptr) {
+      return expr;
+    }
+    auto code = dictionary->Lookup(constant->val_);
+    if (!code.has_value()) {
+      return expr;
+    }
+    auto children = comparison->GetChildren();
+    children[constant_idx] = std::make_shared<ConstantValueExpression>(dictionary->Decode(*code));
+    return comparison->CloneWithChildren(std::move(children));
+  }
+  std::vector<AbstractExpressionRef> children;
+  bool changed = false;
+  for (const auto &child : expr->GetChildren()) {
+    children.push_back(EncodeDictionaryConstants(child, schema));
+    changed = changed || children.back() != child;
+  }
+  return changed ? expr->CloneWithChildren(std::move(children)) : expr;
+}
+
+}  // namespace
+
 SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
     : AbstractExecutor(exec_ctx), plan_(plan) {}
 
 void SeqScanExecutor::Init() {
   table_oid_t tid = plan_->GetTableOid();
   table_info_ = exec_ctx_->GetCatalog()->GetTable(tid);
+  predicate_ = plan_->filter_predicate_ == nullptr
+                   ? nullptr
+                   : EncodeDictionaryConstants(plan_->filter_predicate_, table_info_->schema_);
   if (exec_ctx_->GetTransaction()->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED &&
       !exec_ctx_->GetLockManager()->LockTable(exec_ctx_->GetTransaction(), LockManager::LockMode::INTENTION_SHARED,
                                               table_info_->oid_)) {
     throw ExecutionException("lock table share failed");
   }
+  if (plan_->columns_.has_value() && table_info_->table_->GetFormat() == TableFormat::Pax) {
+    column_iterator_ = std::make_unique<ColumnIterator>(table_info_->table_->MakeColumnIterator(*plan_->columns_));
+    batch_ = ColumnBatch{};
+    batch_pos_ = 0;
+    row_.clear();
+    for (const auto &column : table_info_->schema_.GetColumns()) {
+      row_.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+    }
+    return;
+  }
   iterator_ = std::make_unique<TableIterator>(table_info_->table_->MakeEagerIterator());
+  if (const auto *zone_map = table_info_->table_->GetZoneMap();
+      plan_->filter_predicate_ != nullptr && zone_map != nullptr) {
+    std::vector<ZoneRange> ranges;
+    CollectZoneRanges(plan_->filter_predicate_.get(), table_info_->schema_, *zone_map, &ranges);
+    iterator_->SetZoneRanges(std::move(ranges));
+  }
+  tuple_batch_.Release();
+  num_rows_ = 0;
+  row_pos_ = 0;
 }
 
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  std::pair<TupleMeta, Tuple> tup;
-  while (!iterator_->IsEnd()) {
-    if (tup.first.is_deleted_) {
-      ++(*iterator_);
-      continue;
+auto SeqScanExecutor::Matches(const TupleView &tuple) const -> bool {
+  if (predicate_ == nullptr) {
+    return true;
+  }
+  auto value = predicate_->EvaluateView(tuple, table_info_->schema_);
+  return !value.IsNull() && value.GetAs<bool>();
+}
+
+void SeqScanExecutor::UnlockRow(const RID &rid) {
+  auto *txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() == IsolationLevel::READ_COMMITTED &&
+      !exec_ctx_->GetLockManager()->UnlockRow(txn, table_info_->oid_, rid)) {
+    throw ExecutionException("unlock row share failed");
+  }
+}
+
+auto SeqScanExecutor::NextFromColumns(Tuple *tuple, RID *rid) -> bool {
+  auto *txn = exec_ctx_->GetTransaction();
+  while (true) {
+    while (batch_pos_ == batch_.rids_.size()) {
+      if (!column_iterator_->Next(&batch_)) {
+        return false;
+      }
+      batch_pos_ = 0;
     }
-    if (exec_ctx_->GetTransaction()->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED &&
-        !exec_ctx_->GetLockManager()->LockRow(exec_ctx_->GetTransaction(), LockManager::LockMode::SHARED,
-                                              exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())->oid_,
-                                              iterator_->GetRID())) {
+    *rid = batch_.rids_[batch_pos_];
+    if (txn->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED &&
+        !exec_ctx_->GetLockManager()->LockRow(txn, LockManager::LockMode::SHARED, table_info_->oid_, *rid)) {
       throw ExecutionException("lock row intention share failed");
     }
-    tup = iterator_->GetTuple();
-    *tuple = tup.second;
-    *rid = iterator_->GetRID();
-    if (!exec_ctx_->GetTransaction()->GetSharedRowLockSet()->empty()) {
-      if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED &&
-          !exec_ctx_->GetLockManager()->UnlockRow(
-              exec_ctx_->GetTransaction(), exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())->oid_, iterator_->GetRID())) {
-        throw ExecutionException("unlock row share failed");
-      }
+    const auto &columns = *plan_->columns_;
+    for (size_t i = 0; i < columns.size(); i++) {
+      row_[columns[i]] = batch_.columns_[i][batch_pos_];
+    }
+    batch_pos_++;
+    *tuple = Tuple(row_, &table_info_->schema_);
+    UnlockRow(*rid);
+    if (Matches(tuple->AsView())) {
+      return true;
     }
-    break;
   }
-  if (iterator_->IsEnd()) {
+}
+
+auto SeqScanExecutor::FillRows() -> bool {
+  auto *txn = exec_ctx_->GetTransaction();
+  bool lock_rows = txn->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED;
+  if (!iterator_->NextBatch(&tuple_batch_, lock_rows ? txn : nullptr, exec_ctx_->GetLockManager(),
+                            table_info_->oid_)) {
     return false;
   }
-  ++(*iterator_);
+  num_rows_ = 0;
+  row_pos_ = 0;
+  // 过滤直接在页面上做，只有返回的行才拷贝出来
+  for (size_t i = 0; i < tuple_batch_.Size(); i++) {
+    const auto &view = tuple_batch_.GetTuple(i);
+    if (tuple_batch_.GetMeta(i).is_deleted_ || !Matches(view)) {
+      continue;
+    }
+    if (num_rows_ == rows_.size()) {
+      rows_.emplace_back();
+    }
+    rows_[num_rows_++].CopyFrom(view);
+  }
+  for (size_t i = 0; i < tuple_batch_.Size(); i++) {
+    UnlockRow(tuple_batch_.GetTuple(i).GetRid());
+  }
+  // 页latch要在返回之前放掉，上层的update/delete会写同一页
+  tuple_batch_.Release();
+  return true;
+}
+
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (column_iterator_ != nullptr) {
+    return NextFromColumns(tuple, rid);
+  }
+  while (row_pos_ == num_rows_) {
+    if (!FillRows()) {
+      return false;
+    }
+  }
+  // 交换而不是拷贝，调用者的旧tuple留下来给下一页复用
+  std::swap(*tuple, rows_[row_pos_++]);
+  *rid = tuple->GetRid();
   return true;
 }
 
+auto SeqScanExecutor::NextBatch(VectorBatch *batch) -> bool {
+  if (column_iterator_ != nullptr) {
+    return AbstractExecutor::NextBatch(batch);
+  }
+  batch->Reset(GetOutputSchema());
+  // 先交出Next读了一半的页
+  while (row_pos_ < num_rows_) {
+    batch->AppendTuple(rows_[row_pos_++], table_info_->schema_);
+  }
+  auto *txn = exec_ctx_->GetTransaction();
+  bool lock_rows = txn->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED;
+  while (!batch->IsFull()) {
+    if (!iterator_->NextBatch(&tuple_batch_, lock_rows ? txn : nullptr, exec_ctx_->GetLockManager(),
+                              table_info_->oid_)) {
+      break;
+    }
+    // 通过过滤的行直接从页面解码到列里，不经过Tuple
+    for (size_t i = 0; i < tuple_batch_.Size(); i++) {
+      const auto &view = tuple_batch_.GetTuple(i);
+      if (!tuple_batch_.GetMeta(i).is_deleted_ && Matches(view)) {
+        batch->AppendView(view, table_info_->schema_);
+      }
+    }
+    for (size_t i = 0; i < tuple_batch_.Size(); i++) {
+      UnlockRow(tuple_batch_.GetTuple(i).GetRid());
+    }
+    tuple_batch_.Release();
+  }
+  return batch->Size() > 0;
+}
+
 }  // namespace bustub
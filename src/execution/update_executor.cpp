@@ -9,6 +9,7 @@
 // Copyright (c) 2015-2021, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+#include <cstring>
 #include <memory>
 
 #include "execution/executors/update_executor.h"
@@ -40,17 +41,21 @@ auto UpdateExecutor::Next(Tuple *tuple, RID *rid) -> bool {
     }
     Tuple new_tuple = Tuple(values, &table_info_->schema_);
     auto new_tuplemeta = TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false};
-    table_info_->table_->UpdateTupleInPlaceUnsafe(new_tuplemeta, new_tuple, *rid);
+    table_info_->table_->UpdateTuple(new_tuplemeta, new_tuple, *rid);
     nums++;
 
+    // RID不变，键没变的索引不用动
     for (auto &x : index_list_) {
       Tuple partial_tuple =
           tuple->KeyFromTuple(table_info_->schema_, *(x->index_->GetKeySchema()), x->index_->GetKeyAttrs());
-      x->index_->DeleteEntry(partial_tuple, *rid, exec_ctx_->GetTransaction());
-
       Tuple partial_new_tuple =
           new_tuple.KeyFromTuple(table_info_->schema_, *(x->index_->GetKeySchema()), x->index_->GetKeyAttrs());
-      x->index_->InsertEntry(partial_new_tuple, *rid, exec_ctx_->GetTransaction());
+      if (partial_tuple.GetLength() == partial_new_tuple.GetLength() &&
+          memcmp(partial_tuple.GetData(), partial_new_tuple.GetData(), partial_tuple.GetLength()) == 0) {
+        continue;
+      }
+      x->index_->DeleteEntry(partial_tuple, *rid, exec_ctx_->GetTransaction());
+      x->InsertEntry(partial_new_tuple, *rid, exec_ctx_->GetTransaction());
     }
   }
 
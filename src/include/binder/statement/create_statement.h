@@ -21,10 +21,15 @@ namespace bustub {
 
 class CreateStatement : public BoundStatement {
  public:
-  explicit CreateStatement(std::string table, std::vector<Column> columns);
+  explicit CreateStatement(std::string table, std::vector<Column> columns, std::string format = "row",
+                           std::vector<std::string> dictionary_columns = {});
 
   std::string table_;
   std::vector<Column> columns_;
+  /** The page format from `WITH (format = '...')`, "row" or "pax" */
+  std::string format_;
+  /** The columns from `WITH (dictionary = 'a, b')`, stored as codes of a per-column dictionary */
+  std::vector<std::string> dictionary_columns_;
 
   auto ToString() const -> std::string override;
 };
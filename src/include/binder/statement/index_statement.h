@@ -21,7 +21,8 @@ namespace bustub {
 class IndexStatement : public BoundStatement {
  public:
   explicit IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                          std::vector<std::unique_ptr<BoundColumnRef>> cols);
+                          std::vector<std::unique_ptr<BoundColumnRef>> cols, std::string index_type,
+                          bool bloom_filter = false);
 
   /** Name of the index */
   std::string index_name_;
@@ -32,6 +33,12 @@ class IndexStatement : public BoundStatement {
   /** Name of the columns */
   std::vector<std::unique_ptr<BoundColumnRef>> cols_;
 
+  /** Access method from the USING clause: btree, hash or art */
+  std::string index_type_;
+
+  /** Whether the index keeps a Bloom filter of its keys, from WITH (bloom_filter = true) */
+  bool bloom_filter_;
+
   auto ToString() const -> std::string override;
 };
 
@@ -20,7 +20,9 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "container/hash/bloom_filter.h"
 #include "container/hash/hash_function.h"
+#include "storage/index/art_index.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
@@ -58,6 +60,9 @@ struct TableInfo {
   const table_oid_t oid_;
 };
 
+/** The data structure backing an index, chosen with CREATE INDEX ... USING <type>. */
+enum class IndexType { BPlusTreeIndex, HashTableIndex, ARTIndex };
+
 /**
  * The IndexInfo class maintains metadata about a index.
  */
@@ -70,15 +75,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The data structure backing the index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,6 +98,23 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The data structure backing the index */
+  const IndexType index_type_;
+  /** The keys of the index, set if the index was created WITH (bloom_filter = true) */
+  std::unique_ptr<KeyBloomFilter> bloom_filter_;
+
+  /** Insert an entry into the index and its Bloom filter */
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *txn) -> bool {
+    if (bloom_filter_ != nullptr) {
+      bloom_filter_->Insert(key, key_schema_);
+    }
+    return index_->InsertEntry(key, rid, txn);
+  }
+
+  /** @return false if no entry of the index has the key, true if one may have it */
+  auto MayContain(const Tuple &key) const -> bool {
+    return bloom_filter_ == nullptr || bloom_filter_->MayContain(key, key_schema_);
+  }
 };
 
 /**
@@ -121,10 +145,11 @@ class Catalog {
    * @param table_name The name of the new table, note that all tables beginning with `__` are reserved for the system.
    * @param schema The schema of the new table
    * @param create_table_heap whether to create a table heap for the new table
+   * @param format the page format of the table heap
    * @return A (non-owning) pointer to the metadata for the table
    */
-  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true)
-      -> TableInfo * {
+  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true,
+                   TableFormat format = TableFormat::Row) -> TableInfo * {
     if (table_names_.count(table_name) != 0) {
       return NULL_TABLE_INFO;
     }
@@ -136,7 +161,7 @@ class Catalog {
     // When create_table_heap == false, it means that we're running binder tests (where no txn will be provided) or
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
-      table = std::make_unique<TableHeap>(bpm_);
+      table = std::make_unique<TableHeap>(bpm_, &schema, format);
     }
 
     // Fetch the table OID for the new table
@@ -196,12 +221,15 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param index_type The data structure backing the index
+   * @param bloom_filter Whether the index keeps a Bloom filter of its keys
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, IndexType index_type = IndexType::BPlusTreeIndex,
+                   bool bloom_filter = false) -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -221,27 +249,46 @@ class Catalog {
     auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
 
     // Construct the index, take ownership of metadata
-    // TODO(Kyle): We should update the API for CreateIndex
-    // to allow specification of the index type itself, not
-    // just the key, value, and comparator types
-
-    // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+    std::unique_ptr<Index> index;
+    switch (index_type) {
+      case IndexType::BPlusTreeIndex:
+        index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+        break;
+      case IndexType::HashTableIndex:
+        index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                             hash_function);
+        break;
+      case IndexType::ARTIndex:
+        index = std::make_unique<ARTIndex<KeyType, ValueType, KeyComparator>>(std::move(meta));
+        break;
+    }
 
     // Populate the index with all tuples in table heap
     auto *table_meta = GetTable(table_name);
+    std::vector<Tuple> keys;
     for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
       auto [meta, tuple] = iter.GetTuple();
-      index->InsertEntry(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid(), txn);
+      if (meta.is_deleted_) {
+        continue;
+      }
+      keys.push_back(tuple.KeyFromTuple(schema, key_schema, key_attrs));
+      index->InsertEntry(keys.back(), tuple.GetRid(), txn);
     }
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
 
     // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
     auto *tmp = index_info.get();
+    if (bloom_filter) {
+      // 按现有的行数留出一倍的余量
+      index_info->bloom_filter_ = std::make_unique<KeyBloomFilter>(keys.size() * 2);
+      for (const auto &key : keys) {
+        index_info->bloom_filter_->Insert(key, key_schema);
+      }
+    }
 
     // Update internal tracking
     indexes_.emplace(index_oid, std::move(index_info));
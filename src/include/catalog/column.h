@@ -25,6 +25,7 @@
 
 namespace bustub {
 class AbstractExpression;
+class Dictionary;
 
 class Column {
   friend class Schema;
@@ -65,14 +66,30 @@ class Column {
         column_type_(column.column_type_),
         fixed_length_(column.fixed_length_),
         variable_length_(column.variable_length_),
-        column_offset_(column.column_offset_) {}
+        column_offset_(column.column_offset_),
+        dictionary_(column.dictionary_) {}
+
+  /**
+   * Replicate a VARCHAR Column whose values are stored as codes of a dictionary.
+   * @param column the original column
+   * @param dictionary the dictionary of the column, shared by every copy of the column
+   */
+  Column(const Column &column, std::shared_ptr<Dictionary> dictionary)
+      : column_name_(column.column_name_),
+        column_type_(column.column_type_),
+        fixed_length_(sizeof(uint32_t)),
+        variable_length_(column.variable_length_),
+        column_offset_(column.column_offset_),
+        dictionary_(std::move(dictionary)) {
+    BUSTUB_ASSERT(column_type_ == TypeId::VARCHAR, "Only VARCHAR columns can be dictionary encoded.");
+  }
 
   /** @return column name */
   auto GetName() const -> std::string { return column_name_; }
 
   /** @return column length */
   auto GetLength() const -> uint32_t {
-    if (IsInlined()) {
+    if (column_type_ != TypeId::VARCHAR) {
       return fixed_length_;
     }
     return variable_length_;
@@ -90,8 +107,11 @@ class Column {
   /** @return column type */
   auto GetType() const -> TypeId { return column_type_; }
 
-  /** @return true if column is inlined, false otherwise */
-  auto IsInlined() const -> bool { return column_type_ != TypeId::VARCHAR; }
+  /** @return true if column is inlined, false otherwise. A dictionary encoded column inlines its codes */
+  auto IsInlined() const -> bool { return column_type_ != TypeId::VARCHAR || dictionary_ != nullptr; }
+
+  /** @return the dictionary of a dictionary encoded column, nullptr otherwise */
+  auto GetDictionary() const -> Dictionary * { return dictionary_.get(); }
 
   /** @return a string representation of this column */
   auto ToString(bool simplified = true) const -> std::string;
@@ -138,6 +158,9 @@ class Column {
 
   /** Column offset in the tuple. */
   uint32_t column_offset_{0};
+
+  /** For a dictionary encoded column, the dictionary of its values. */
+  std::shared_ptr<Dictionary> dictionary_;
 };
 
 }  // namespace bustub
@@ -21,6 +21,9 @@ namespace bustub {
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
+/** With lazy merging enabled, underfull B+ tree pages are compacted every B_PLUS_TREE_MERGE_INTERVAL milliseconds. */
+extern std::chrono::milliseconds b_plus_tree_merge_interval;
+
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
@@ -18,6 +18,7 @@
 #include <string>
 
 #include "common/macros.h"
+#include "type/dictionary.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -87,6 +88,9 @@ class HashUtil {
         return Hash<double>(&raw);
       }
       case TypeId::VARCHAR: {
+        if (val->GetDictionaryId() != 0) {
+          return Dictionary::CachedHash(*val);
+        }
         auto raw = val->GetData();
         auto len = val->GetLength();
         return HashBytes(raw, len);
@@ -14,6 +14,7 @@
 
 #include <queue>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -29,7 +30,9 @@ namespace bustub {
 /**
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
- * table grows/shrinks dynamically as buckets become full/empty.
+ * table grows/shrinks dynamically as buckets become full/empty. Entries that
+ * cannot be separated by splitting (one key with many values, or a full
+ * directory) go to overflow pages chained behind the bucket.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class DiskExtendibleHashTable {
@@ -112,6 +115,11 @@ class DiskExtendibleHashTable {
    */
   auto KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t;
 
+  /**
+   * Maps a hash computed by hash_fn_ to a directory index, same as KeyToDirectoryIndex.
+   */
+  auto HashToDirectoryIndex(uint64_t hash, HashTableDirectoryPage *dir_page) -> uint32_t;
+
   /**
    * Get the bucket page_id corresponding to a key.
    *
@@ -136,15 +144,41 @@ class DiskExtendibleHashTable {
    */
   auto FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE *;
 
+  /** Unpin an overflow page of a chain, INVALID_PAGE_ID stands for the head that the caller keeps pinned */
+  void ReleaseChainPage(page_id_t page_id, bool is_dirty);
+
+  /** GetValue over a bucket and its overflow pages */
+  auto ChainGetValue(HASH_TABLE_BUCKET_TYPE *bucket_page, const KeyType &key, uint8_t fingerprint,
+                     std::vector<ValueType> *result) -> bool;
+
+  /**
+   * Insert into the first page of the chain that has room.
+   * @param grow whether to append an overflow page when the whole chain is full
+   * @return false if the chain is full and grow is false
+   */
+  auto ChainInsert(HASH_TABLE_BUCKET_TYPE *bucket_page, const KeyType &key, const ValueType &value,
+                   uint8_t fingerprint, bool grow) -> bool;
+
+  /** Remove from a bucket and its overflow pages, an overflow page that becomes empty is unlinked and deleted */
+  auto ChainRemove(HASH_TABLE_BUCKET_TYPE *bucket_page, const KeyType &key, const ValueType &value,
+                   uint8_t fingerprint) -> bool;
+
+  /** @return whether every key in the chain has the given 32-bit hash, so splitting cannot separate them */
+  auto ChainHasSingleHash(HASH_TABLE_BUCKET_TYPE *bucket_page, uint32_t hash) -> bool;
+
+  /** Take every entry out of the chain, delete its overflow pages and leave the head empty */
+  auto DrainChain(HASH_TABLE_BUCKET_TYPE *bucket_page) -> std::vector<std::tuple<KeyType, ValueType, uint8_t>>;
+
   /**
    * Performs insertion with an optional bucket splitting.
    *
    * @param transaction a pointer to the current transaction
    * @param key the key to insert
    * @param value the value to insert
+   * @param hash the hash of key, computed once by Insert
    * @return whether or not the insertion was successful
    */
-  auto SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
+  auto SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value, uint64_t hash) -> bool;
 
   /**
    * Optionally merges an empty bucket into it's pair.  This is called by Remove,
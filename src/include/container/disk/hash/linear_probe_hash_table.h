@@ -26,10 +26,23 @@ namespace bustub {
 
 #define HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
 
+/** Minimum number of old-table slots migrated by each insert or remove while a resize is in progress. */
+static constexpr size_t LINEAR_PROBE_MIGRATE_SLOTS = 16;
+
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Growing is incremental: a resize only allocates the new block pages, and the
+ * old table is kept next to it until every slot has been moved. Each insert and
+ * remove moves a bounded number of old slots, chosen so that the migration ends
+ * before the new table fills up, and lookups probe both tables while a migration
+ * is in progress.
+ *
+ * A header page lists the block pages of a table. Once a table needs more blocks
+ * than one header page holds, the header page lists further header pages instead,
+ * so the table can keep growing.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable {
@@ -73,7 +86,9 @@ class LinearProbeHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Resizes the table to at least twice the initial size provided. Only the new
+   * block pages are allocated here, the entries are moved by later inserts and
+   * removes.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
@@ -84,20 +99,62 @@ class LinearProbeHashTable {
    */
   auto GetSize() -> size_t;
 
+  /**
+   * @return whether a resize is still moving entries out of the old table
+   */
+  auto IsMigrating() -> bool;
+
  private:
-  auto GetHeaderPage() -> HashTableHeaderPage *;
+  auto GetHeaderPage(page_id_t header_page_id) -> HashTableHeaderPage *;
   auto GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE *;
-  void ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value);
-  void DeleteBlockPages(HashTableHeaderPage *old_header_page);
+
+  /** @return the number of blocks below each entry of the top header page of a table with num_blocks blocks */
+  static auto BlockSpan(size_t num_blocks) -> size_t;
+  /** @return the page id of the block_idx-th block, walking down the header pages of the table */
+  auto GetBlockPageId(HashTableHeaderPage *header_page, size_t block_idx) -> page_id_t;
+
+  /**
+   * Linear probe a table from the home slot of key. visit is called on every
+   * readable slot holding key and stops the probe by returning true.
+   * @param[out] matched whether visit stopped the probe
+   * @return the slot the probe stopped at, the table size if it wrapped around
+   */
+  template <typename Visitor>
+  auto Probe(HashTableHeaderPage *header_page, const KeyType &key, Visitor &&visit, bool *matched) -> size_t;
+
+  // 在指定表中插入(不查重)，返回false表示表满
+  auto InsertInto(HashTableHeaderPage *header_page, size_t slot, const KeyType &key, const ValueType &value) -> bool;
+  auto RemoveFrom(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> bool;
+  auto ContainsPair(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> bool;
+
+  // 新建一张至少num_slots个槽位的空表，返回header page id
+  auto NewTable(size_t num_slots) -> page_id_t;
+  // 新建覆盖num_blocks个块的header page，span大于1时下面挂的是每个覆盖span个块的header page
+  auto NewHeaderPage(size_t num_blocks, size_t span) -> page_id_t;
+  // 新建一张表并开始迁移，旧表由之后的写操作逐步搬空
+  void StartResize(size_t num_slots);
+  // 搬迁至多max_slots个旧表槽位，搬完后释放旧表
+  void MigrateSlots(size_t max_slots);
+  void DeleteTable(page_id_t header_page_id, size_t span);
   void CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks);
-  auto GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // table being drained by an incremental resize, INVALID_PAGE_ID when there is none
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  // next slot of the old table to migrate
+  size_t migrate_cursor_{0};
+  // old slots migrated by each insert or remove
+  size_t migrate_step_{LINEAR_PROBE_MIGRATE_SLOTS};
+  // occupied slots (including tombstones) of the current table
+  size_t num_occupied_{0};
+  // readable entries in both tables
+  size_t num_items_{0};
+
+  // Readers are lookups, inserts and removes are writers since they also move entries of an ongoing resize
   ReaderWriterLatch table_latch_;
 
   // Hash function
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/container/hash/bloom_filter.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rwlatch.h"
+#include "common/util/hash_util.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * BlockedBloomFilter is a Bloom filter whose bits for one key all lie in a single cache line. The high half of a hash
+ * picks the block, the low half sets one bit in each of the eight 64-bit words of the block, so a probe touches one
+ * cache line and checks all eight bits at once without branches. With the default 16 bits per key about 0.1% of the
+ * absent keys pass. Keys can not be removed. Not thread-safe.
+ */
+class BlockedBloomFilter {
+ public:
+  static constexpr size_t BITS_PER_KEY = 16;
+
+  /** @param expected_keys the number of keys the filter is sized for, more keys raise the false positive rate */
+  explicit BlockedBloomFilter(size_t expected_keys);
+
+  void Insert(hash_t hash) {
+    hash = Mix(hash);
+    auto &block = blocks_[BlockIndex(hash)];
+    auto key = static_cast<uint32_t>(hash);
+    for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+      block.words_[i] |= BitMask(key, i);
+    }
+  }
+
+  /** @return false if the key of the hash was never inserted, true if it may have been */
+  auto MayContain(hash_t hash) const -> bool {
+    hash = Mix(hash);
+    const auto &block = blocks_[BlockIndex(hash)];
+    auto key = static_cast<uint32_t>(hash);
+    // 不提前退出，八个字一起比较，编译器可以向量化
+    uint64_t missing = 0;
+    for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+      missing |= ~block.words_[i] & BitMask(key, i);
+    }
+    return missing == 0;
+  }
+
+  auto GetNumBlocks() const -> size_t { return blocks_.size(); }
+
+  /** The hashes of HashUtil leave the high bits poorly mixed, so they go through the murmur3 finalizer first */
+  static auto Mix(hash_t hash) -> hash_t {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+ private:
+  static constexpr size_t WORDS_PER_BLOCK = 8;
+  /** Odd constants that spread a 32-bit key over the words of a block, one per word */
+  static constexpr uint32_t SALTS[WORDS_PER_BLOCK] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                      0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+  struct alignas(64) Block {
+    uint64_t words_[WORDS_PER_BLOCK];
+  };
+
+  static auto BitMask(uint32_t key, size_t word) -> uint64_t { return uint64_t{1} << ((key * SALTS[word]) >> 26); }
+
+  auto BlockIndex(hash_t hash) const -> size_t { return ((hash >> 32) * blocks_.size()) >> 32; }
+
+  std::vector<Block> blocks_;
+};
+
+/**
+ * KeyBloomFilter keeps the keys of an index in blocked Bloom filters, so that a lookup of an absent key can skip the
+ * index. When the keys outgrow a filter, a filter twice its size is added instead of rebuilding; a lookup probes each
+ * of them. Deleted keys stay in the filter and only cost a false positive. Thread-safe.
+ */
+class KeyBloomFilter {
+ public:
+  explicit KeyBloomFilter(size_t expected_keys);
+
+  void Insert(const Tuple &key, const Schema &key_schema);
+
+  /** @return false if the key was never inserted, true if it may have been */
+  auto MayContain(const Tuple &key, const Schema &key_schema) const -> bool;
+
+  /** @return the hash of an index key, the same for equal keys of any representation */
+  static auto KeyHash(const Tuple &key, const Schema &key_schema) -> hash_t;
+
+ private:
+  std::vector<BlockedBloomFilter> filters_;
+  /** The number of keys the last filter is sized for, and the number it holds */
+  size_t capacity_;
+  size_t size_{0};
+  mutable ReaderWriterLatch latch_;
+};
+
+}  // namespace bustub
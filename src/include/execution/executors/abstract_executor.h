@@ -14,6 +14,7 @@
 
 #include "execution/executor_context.h"
 #include "storage/table/tuple.h"
+#include "storage/table/vector_batch.h"
 
 namespace bustub {
 class ExecutorContext;
@@ -21,6 +22,8 @@ class ExecutorContext;
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
+ * Executors can also be pulled a batch of tuples at a time with NextBatch, a
+ * parent uses either Next or NextBatch on a child, never both.
  */
 class AbstractExecutor {
  public:
@@ -47,6 +50,23 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid) -> bool = 0;
 
+  /**
+   * Yield the next batch of tuples from this executor. The default implementation fills the batch by calling Next(),
+   * executors that can produce a batch at once override it.
+   * @param[out] batch The batch, reset to the output schema and filled with up to about VectorBatch::CAPACITY tuples
+   * @return `true` if the batch holds at least one tuple, `false` if there are no more tuples
+   */
+  virtual auto NextBatch(VectorBatch *batch) -> bool {
+    batch->Reset(GetOutputSchema());
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      tuple.SetRid(rid);
+      batch->AppendTuple(tuple, GetOutputSchema());
+    }
+    return batch->Size() > 0;
+  }
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
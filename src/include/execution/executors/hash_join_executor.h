@@ -14,11 +14,13 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "common/util/hash_util.h"
+#include "container/hash/bloom_filter.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/hash_join_plan.h"
@@ -96,6 +98,9 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /** Yield the next joined tuples */
+  auto NextBatch(VectorBatch *batch) -> bool override;
+
   /** @return The output schema for the join */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
@@ -105,6 +110,8 @@ class HashJoinExecutor : public AbstractExecutor {
   std::unique_ptr<AbstractExecutor> left_child_;
   std::unique_ptr<AbstractExecutor> right_child_;
   std::unordered_map<HashJoinKey, std::vector<Tuple>> ht_{};
+  /** The keys of the build side, probed before the hash table */
+  std::optional<BlockedBloomFilter> filter_;
   std::vector<Tuple> output_;
   std::vector<Tuple>::iterator iterator_;
 };
@@ -47,6 +47,9 @@ class IndexScanExecutor : public AbstractExecutor {
   IndexInfo *index_info_;
   TableInfo *table_info_;
   BPlusTreeIndexForTwoIntegerColumn *tree_;
-  IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType> *iterator_;
+  IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType> *iterator_{nullptr};
+  /** Matches of a point lookup, used instead of iterator_ when the plan has a pred_key_ */
+  std::vector<RID> rids_;
+  size_t rid_index_{0};
 };
 }  // namespace bustub
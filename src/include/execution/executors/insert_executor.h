@@ -62,6 +62,8 @@ class InsertExecutor : public AbstractExecutor {
   table_oid_t table_id_;
   TableInfo *table_info_;
   std::vector<IndexInfo *> index_list_;
+  /** Whether the table has dictionary encoded columns, whose codes the child's rows do not hold */
+  bool encode_rows_{false};
 };
 
 }  // namespace bustub
@@ -18,6 +18,7 @@
 #include <utility>
 #include <vector>
 
+#include "catalog/catalog.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
@@ -50,5 +51,12 @@ class NestIndexJoinExecutor : public AbstractExecutor {
  private:
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  /** The outer table */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  const IndexInfo *index_info_;
+  const TableInfo *table_info_;
+  /** Joined tuples of the current outer tuple not yet emitted, an index may return several matches */
+  std::vector<Tuple> pending_;
+  size_t pending_index_{0};
 };
 }  // namespace bustub
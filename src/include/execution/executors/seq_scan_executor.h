@@ -18,6 +18,7 @@
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/column_iterator.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -45,13 +46,42 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /** Yield the rows of whole pages until the batch is full, decoding them straight from the pages */
+  auto NextBatch(VectorBatch *batch) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** Yield the next row of a PAX table, reading only the columns in plan_->columns_ */
+  auto NextFromColumns(Tuple *tuple, RID *rid) -> bool;
+
+  /** Read the next page and copy its rows that pass the filter into rows_, @return false at the end of the table */
+  auto FillRows() -> bool;
+
+  /** @return whether a row passes the filter predicate of the plan */
+  auto Matches(const TupleView &tuple) const -> bool;
+
+  /** Release the row lock of a READ_COMMITTED transaction once the row has been read */
+  void UnlockRow(const RID &rid);
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** The filter predicate of the plan, string constants compared with dictionary encoded columns are encoded */
+  AbstractExpressionRef predicate_;
   std::unique_ptr<TableIterator> iterator_;
+  /** The tuples of the current page, only released between calls of FillRows */
+  TupleBatch tuple_batch_;
+  /** The rows of the current page that passed the filter, the tuples are reused across pages */
+  std::vector<Tuple> rows_;
+  size_t num_rows_{0};
+  size_t row_pos_{0};
   TableInfo *table_info_;
+  /** Set instead of iterator_ when only some columns of a PAX table are read */
+  std::unique_ptr<ColumnIterator> column_iterator_;
+  ColumnBatch batch_;
+  size_t batch_pos_{0};
+  /** The values of the current row, the columns that are not read stay NULL */
+  std::vector<Value> row_;
 };
 }  // namespace bustub
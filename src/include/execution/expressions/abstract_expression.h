@@ -20,6 +20,7 @@
 #include "catalog/schema.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
+#include "storage/table/vector_batch.h"
 
 #define BUSTUB_EXPR_CLONE_WITH_CHILDREN(cname)                                                                   \
   auto CloneWithChildren(std::vector<AbstractExpressionRef> children) const->std::unique_ptr<AbstractExpression> \
@@ -54,6 +55,15 @@ class AbstractExpression {
   /** @return The value obtained by evaluating the tuple with the given schema */
   virtual auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value = 0;
 
+  /**
+   * @return The value obtained by evaluating a tuple viewed in place, e.g. in a pinned table page. VARCHAR values may
+   * point into the viewed bytes, so the result must not outlive the view.
+   */
+  virtual auto EvaluateView(const TupleView &tuple, const Schema &schema) const -> Value = 0;
+
+  /** @return The value obtained by evaluating a row of a batch, column indexes refer to the columns of the batch */
+  virtual auto EvaluateBatch(const VectorBatch &batch, size_t row) const -> Value = 0;
+
   /**
    * Returns the value obtained by evaluating a JOIN.
    * @param left_tuple The left tuple
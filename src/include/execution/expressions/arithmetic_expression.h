@@ -47,22 +47,26 @@ class ArithmeticExpression : public AbstractExpression {
   auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
     Value lhs = GetChildAt(0)->Evaluate(tuple, schema);
     Value rhs = GetChildAt(1)->Evaluate(tuple, schema);
-    auto res = PerformComputation(lhs, rhs);
-    if (res == std::nullopt) {
-      return ValueFactory::GetNullValueByType(TypeId::INTEGER);
-    }
-    return ValueFactory::GetIntegerValue(*res);
+    return FromChildren(lhs, rhs);
+  }
+
+  auto EvaluateView(const TupleView &tuple, const Schema &schema) const -> Value override {
+    Value lhs = GetChildAt(0)->EvaluateView(tuple, schema);
+    Value rhs = GetChildAt(1)->EvaluateView(tuple, schema);
+    return FromChildren(lhs, rhs);
+  }
+
+  auto EvaluateBatch(const VectorBatch &batch, size_t row) const -> Value override {
+    Value lhs = GetChildAt(0)->EvaluateBatch(batch, row);
+    Value rhs = GetChildAt(1)->EvaluateBatch(batch, row);
+    return FromChildren(lhs, rhs);
   }
 
   auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                     const Schema &right_schema) const -> Value override {
     Value lhs = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
     Value rhs = GetChildAt(1)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
-    auto res = PerformComputation(lhs, rhs);
-    if (res == std::nullopt) {
-      return ValueFactory::GetNullValueByType(TypeId::INTEGER);
-    }
-    return ValueFactory::GetIntegerValue(*res);
+    return FromChildren(lhs, rhs);
   }
 
   /** @return the string representation of the expression node and its children */
@@ -75,6 +79,15 @@ class ArithmeticExpression : public AbstractExpression {
   ArithmeticType compute_type_;
 
  private:
+  /** @return the value of this node given the values of its children, shared by all Evaluate variants */
+  auto FromChildren(const Value &lhs, const Value &rhs) const -> Value {
+    auto res = PerformComputation(lhs, rhs);
+    if (res == std::nullopt) {
+      return ValueFactory::GetNullValueByType(TypeId::INTEGER);
+    }
+    return ValueFactory::GetIntegerValue(*res);
+  }
+
   auto PerformComputation(const Value &lhs, const Value &rhs) const -> std::optional<int32_t> {
     if (lhs.IsNull() || rhs.IsNull()) {
       return std::nullopt;
@@ -39,6 +39,14 @@ class ColumnValueExpression : public AbstractExpression {
     return tuple->GetValue(&schema, col_idx_);
   }
 
+  auto EvaluateView(const TupleView &tuple, const Schema &schema) const -> Value override {
+    return tuple.GetValueRef(&schema, col_idx_);
+  }
+
+  auto EvaluateBatch(const VectorBatch &batch, size_t row) const -> Value override {
+    return batch.GetValue(col_idx_, row);
+  }
+
   auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                     const Schema &right_schema) const -> Value override {
     return tuple_idx_ == 0 ? left_tuple->GetValue(&left_schema, col_idx_)
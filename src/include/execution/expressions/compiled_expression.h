@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression.h
+//
+// Identification: src/include/execution/expressions/compiled_expression.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "storage/table/tuple.h"
+#include "storage/table/vector_batch.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * CompiledExpression flattens an expression tree once, when an executor is built from its plan, into a list of
+ * instructions that each compute one node for all rows of a batch, so evaluating it does not walk the tree with a
+ * virtual call and a Value per node and row. Nodes of INTEGER-like, DECIMAL and BOOLEAN type keep their values in typed
+ * registers with a NULL flag per row. A subtree that has no such fast path is evaluated through its own Evaluate or
+ * EvaluateBatch and its values are loaded into a register. The registers are reused across calls, so a compiled
+ * expression must not be evaluated by two threads at once.
+ */
+class CompiledExpression {
+ public:
+  explicit CompiledExpression(AbstractExpressionRef expr);
+
+  /** @return the value of the expression on a tuple, the same as AbstractExpression::Evaluate */
+  auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value;
+
+  /** Evaluate the expression on every row of the batch and append the values to column */
+  void EvaluateBatch(const VectorBatch &batch, ColumnVector *column) const;
+
+  /** @return whether a predicate is true, not false or NULL, on a tuple */
+  auto Matches(const Tuple *tuple, const Schema &schema) const -> bool;
+
+  /** Set matches[i] to 1 if a predicate is true on the i-th row of the batch, and to 0 otherwise */
+  void MatchBatch(const VectorBatch &batch, std::vector<uint8_t> *matches) const;
+
+  /** @return the number of nodes that are evaluated through the expression tree instead of a fast path */
+  auto GetNumFallbacks() const -> size_t;
+
+ private:
+  /** How the values of a register are stored: as int64_t, double, 0/1 in int64_t, or as Values */
+  enum class RegisterKind : uint8_t { Integer, Decimal, Boolean, Value };
+
+  enum class OpCode : uint8_t { LoadColumn, LoadConstant, Arithmetic, Compare, Logic, Fallback };
+
+  /** The values of one node for each row of the input, nulls_[i] is nonzero if the i-th value is NULL */
+  struct Register {
+    std::vector<int64_t> ints_;
+    std::vector<double> decimals_;
+    std::vector<uint8_t> nulls_;
+    std::vector<Value> values_;
+  };
+
+  /** One node of the tree. The result goes to the register with the index of the instruction. */
+  struct Instruction {
+    OpCode op_{OpCode::Fallback};
+    RegisterKind kind_{RegisterKind::Value};
+    /** The type of the values of the node */
+    TypeId type_{TypeId::INVALID};
+    uint32_t lhs_{0};
+    uint32_t rhs_{0};
+    uint32_t column_idx_{0};
+    ComparisonType comp_type_{ComparisonType::Equal};
+    ArithmeticType arith_type_{ArithmeticType::Plus};
+    LogicType logic_type_{LogicType::And};
+    Value constant_;
+    /** The node itself, evaluated row by row by a Fallback */
+    const AbstractExpression *expr_{nullptr};
+  };
+
+  class BatchInput;
+  class TupleInput;
+
+  static auto KindOf(TypeId type) -> RegisterKind;
+
+  /** Append the instructions of a subtree, @return the register of its root */
+  auto Compile(const AbstractExpression *expr) -> uint32_t;
+
+  /** Run the program on the first rows of an input */
+  template <class Input>
+  void Run(const Input &input, size_t rows) const;
+
+  /** Store a value computed by the expression tree into the row of a register */
+  static void Store(const Value &value, RegisterKind kind, Register *reg, size_t row);
+
+  /** @return the value of the root of the program at a row */
+  auto ResultAt(size_t row) const -> Value;
+
+  /** @return whether the root of the program is true at a row */
+  auto MatchesAt(size_t row) const -> bool;
+
+  /** Keeps the nodes the fallbacks point to alive */
+  AbstractExpressionRef expr_;
+  std::vector<Instruction> instructions_;
+  mutable std::vector<Register> registers_;
+};
+
+}  // namespace bustub
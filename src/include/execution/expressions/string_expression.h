@@ -62,15 +62,23 @@ class StringExpression : public AbstractExpression {
 
   auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
     Value val = GetChildAt(0)->Evaluate(tuple, schema);
-    auto str = val.GetAs<char *>();
-    return ValueFactory::GetVarcharValue(Compute(str));
+    return FromChildren(val);
+  }
+
+  auto EvaluateView(const TupleView &tuple, const Schema &schema) const -> Value override {
+    Value val = GetChildAt(0)->EvaluateView(tuple, schema);
+    return FromChildren(val);
+  }
+
+  auto EvaluateBatch(const VectorBatch &batch, size_t row) const -> Value override {
+    Value val = GetChildAt(0)->EvaluateBatch(batch, row);
+    return FromChildren(val);
   }
 
   auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                     const Schema &right_schema) const -> Value override {
     Value val = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
-    auto str = val.GetAs<char *>();
-    return ValueFactory::GetVarcharValue(Compute(str));
+    return FromChildren(val);
   }
 
   /** @return the string representation of the expression node and its children */
@@ -81,6 +89,11 @@ class StringExpression : public AbstractExpression {
   StringExpressionType expr_type_;
 
  private:
+  /** @return the value of this node given the value of its child, shared by all Evaluate variants */
+  auto FromChildren(const Value &val) const -> Value {
+    const char *str = val.GetData();
+    return ValueFactory::GetVarcharValue(Compute(str));
+  }
 };
 }  // namespace bustub
 
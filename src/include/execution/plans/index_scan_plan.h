@@ -33,6 +33,15 @@ class IndexScanPlanNode : public AbstractPlanNode {
   IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
       : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
 
+  /**
+   * Creates a new index point lookup plan node.
+   * @param output the output format of this scan plan node
+   * @param index_oid the identifier of the index to probe
+   * @param pred_key the constant the indexed column has to be equal to
+   */
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, AbstractExpressionRef pred_key)
+      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid), pred_key_(std::move(pred_key)) {}
+
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
   /** @return the identifier of the table that should be scanned */
@@ -43,10 +52,14 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** Key of a point lookup, nullptr for a full scan in key order. */
+  AbstractExpressionRef pred_key_;
 
  protected:
   auto PlanNodeToString() const -> std::string override {
+    if (pred_key_ != nullptr) {
+      return fmt::format("IndexScan {{ index_oid={}, pred_key={} }}", index_oid_, pred_key_);
+    }
     return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
   }
 };
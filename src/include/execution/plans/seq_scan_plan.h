@@ -13,14 +13,17 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "binder/table_ref/bound_base_table_ref.h"
 #include "catalog/catalog.h"
 #include "catalog/schema.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "fmt/ranges.h"
 
 namespace bustub {
 
@@ -62,12 +65,20 @@ class SeqScanPlanNode : public AbstractPlanNode {
   */
   AbstractExpressionRef filter_predicate_;
 
+  /** The columns the parent reads, std::nullopt for all of them. Set by the PruneScanColumns rule on PAX tables, the
+      other columns of the output tuples are NULL then. */
+  std::optional<std::vector<uint32_t>> columns_;
+
  protected:
   auto PlanNodeToString() const -> std::string override {
+    std::string columns;
+    if (columns_.has_value()) {
+      columns = fmt::format(", columns=[{}]", fmt::join(*columns_, ", "));
+    }
     if (filter_predicate_) {
-      return fmt::format("SeqScan {{ table={}, filter={} }}", table_name_, filter_predicate_);
+      return fmt::format("SeqScan {{ table={}, filter={}{} }}", table_name_, filter_predicate_, columns);
     }
-    return fmt::format("SeqScan {{ table={} }}", table_name_);
+    return fmt::format("SeqScan {{ table={}{} }}", table_name_, columns);
   }
 };
 
@@ -83,10 +83,21 @@ class Optimizer {
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
-  /** @brief check if the index can be matched */
+  /**
+   * @brief optimize a filter of the form `column = constant` over a seq scan as a point lookup on an index
+   */
+  auto OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /** @brief check if the index can be matched, hash indexes are preferred since the match is used for equality */
   auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
 
+  /**
+   * @brief mark the columns an aggregation reads on the seq scan of a PAX table below it, so the scan only reads
+   * their minipages
+   */
+  auto OptimizePruneScanColumns(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /**
    * @brief optimize sort + limit as top N
    */
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/trie_node_page.h"
+
+namespace bustub {
+
+class DiskTrie;
+
+// A read-only view of a DiskTrie as of one commit. The pages reachable from the snapshot's root are not freed until
+// the snapshot is destroyed, so it can be read while later commits go on.
+class DiskTrieSnapshot {
+ public:
+  DiskTrieSnapshot(const DiskTrieSnapshot &) = delete;
+  auto operator=(const DiskTrieSnapshot &) -> DiskTrieSnapshot & = delete;
+  DiskTrieSnapshot(DiskTrieSnapshot &&that) noexcept;
+  ~DiskTrieSnapshot();
+
+  // Get the value of a key, std::nullopt if the key does not exist.
+  auto Get(std::string_view key) const -> std::optional<std::string>;
+
+  // Return at most `limit` key-value pairs whose key starts with `prefix`, in key order (keys compare as unsigned
+  // bytes).
+  auto ScanPrefix(std::string_view prefix, size_t limit = SIZE_MAX) const
+      -> std::vector<std::pair<std::string, std::string>>;
+
+ private:
+  friend class DiskTrie;
+
+  DiskTrieSnapshot(DiskTrie *trie, page_id_t root_page_id, uint64_t version)
+      : trie_(trie), root_page_id_(root_page_id), version_(version) {}
+
+  DiskTrie *trie_;
+  page_id_t root_page_id_;
+  uint64_t version_;
+};
+
+// A group of writes that DiskTrie::Commit applies atomically. Later writes to the same key win.
+class DiskTrieWriteBatch {
+ public:
+  void Put(std::string_view key, std::string_view value);
+
+  void Remove(std::string_view key);
+
+ private:
+  friend class DiskTrie;
+
+  std::vector<std::pair<std::string, std::optional<std::string>>> writes_;
+};
+
+// A persistent trie of string keys and string values stored in buffer pool pages. Each node is one TrieNodePage and
+// chains of single-child nodes are compressed into the child's prefix, like the in-memory Trie.
+//
+// Writes are copy-on-write: a commit writes new pages for every node it changes, flushes them, and then publishes
+// the new root by flushing the header page. Since a single page write is atomic, a crash leaves the header pointing
+// at either the old or the new root, and reopening the trie only has to read the header. Pages replaced by a commit
+// are deleted once no snapshot taken before it is alive; pages of a commit that crashed before publishing are
+// leaked.
+//
+// Commits are serialized by a latch, reads run concurrently with them.
+class DiskTrie {
+ public:
+  // Open the trie whose header lives in `header_page_id`. A header page that was never used (e.g. straight from
+  // NewPage) is initialized to an empty trie.
+  DiskTrie(BufferPoolManager *bpm, page_id_t header_page_id);
+
+  auto GetSnapshot() -> DiskTrieSnapshot;
+
+  auto Get(std::string_view key) -> std::optional<std::string>;
+
+  auto ScanPrefix(std::string_view prefix, size_t limit = SIZE_MAX) -> std::vector<std::pair<std::string, std::string>>;
+
+  // Insert or overwrite a key. Throws if the key or value is longer than DISK_TRIE_MAX_KEY_SIZE or
+  // DISK_TRIE_MAX_VALUE_SIZE.
+  void Put(std::string_view key, std::string_view value);
+
+  void Remove(std::string_view key);
+
+  // Apply all writes in the batch as a single commit.
+  void Commit(const DiskTrieWriteBatch &batch);
+
+  auto GetRootPageId() -> page_id_t;
+
+ private:
+  friend class DiskTrieSnapshot;
+
+  // A node decoded from its page.
+  struct Node {
+    std::string prefix_;
+    std::optional<std::string> value_;
+    // sorted as unsigned bytes
+    std::vector<std::pair<char, page_id_t>> children_;
+
+    auto Find(char c) const -> page_id_t;
+    void Set(char c, page_id_t child);
+    void Erase(char c);
+  };
+
+  // Pages written and replaced by the commit in progress.
+  struct CommitContext {
+    std::unordered_set<page_id_t> fresh_;
+    std::vector<page_id_t> retired_;
+  };
+
+  auto ReadNode(page_id_t page_id) -> Node;
+
+  auto WriteNode(const Node &node, CommitContext *ctx) -> page_id_t;
+
+  // Write a changed copy of the node at page_id. Pages created by this commit are not visible to anyone else and
+  // are overwritten in place.
+  auto RewriteNode(page_id_t page_id, const Node &node, CommitContext *ctx) -> page_id_t;
+
+  void RetireNode(page_id_t page_id, CommitContext *ctx);
+
+  // `rest` is the part of the key below the node, after its prefix. Return the new page of the node.
+  auto PutAt(page_id_t page_id, std::string_view rest, std::string_view value, CommitContext *ctx) -> page_id_t;
+
+  // `rest` includes the node's prefix. Return the new page of the node, INVALID_PAGE_ID if it was removed, or
+  // page_id if nothing changed.
+  auto RemoveAt(page_id_t page_id, std::string_view rest, bool is_root, CommitContext *ctx) -> page_id_t;
+
+  auto Lookup(page_id_t root_page_id, std::string_view key) -> std::optional<std::string>;
+
+  auto Scan(page_id_t root_page_id, std::string_view prefix, size_t limit)
+      -> std::vector<std::pair<std::string, std::string>>;
+
+  void ScanFrom(page_id_t page_id, std::string *key, size_t limit,
+                std::vector<std::pair<std::string, std::string>> *result);
+
+  void ReleaseSnapshot(uint64_t version);
+
+  // Delete retired pages no live snapshot can reach, latch_ must be held.
+  void ReclaimPages();
+
+  BufferPoolManager *bpm_;
+  page_id_t header_page_id_;
+  // serializes commits
+  std::mutex write_latch_;
+  // protects the fields below
+  std::mutex latch_;
+  page_id_t root_page_id_;
+  uint64_t version_{0};
+  // version -> number of live snapshots of it
+  std::map<uint64_t, size_t> snapshots_;
+  // pages replaced by the commit after each version
+  std::deque<std::pair<uint64_t, std::vector<page_id_t>>> retired_;
+};
+
+}  // namespace bustub
@@ -1,17 +1,21 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <future>  // NOLINT
-#include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "primer/trie_node_pool.h"
+
 namespace bustub {
 
 /// A special type that will block the move constructor and move assignment operator. Used in TrieStore tests.
@@ -40,6 +44,67 @@ class MoveBlocked {
   std::future<int> wait_;
 };
 
+class TrieNode;
+
+// Node4-style sparse children are used up to this many children, above it a node switches to a 256-entry array.
+static constexpr size_t TRIE_SPARSE_MAX_CHILDREN = 16;
+// A dense node falls back to the sparse array once it has this many children or fewer.
+static constexpr size_t TRIE_DENSE_MIN_CHILDREN = 8;
+
+// The children of a TrieNode, keyed by the next byte of the key. Nodes with few children keep them in a small
+// array sorted by byte, so cloning a node along a Put path copies a handful of pointers instead of a red-black
+// tree. Dense nodes use a 256-entry array indexed by the byte.
+class TrieChildren {
+ public:
+  TrieChildren() = default;
+  TrieChildren(const TrieChildren &that);
+  TrieChildren(TrieChildren &&that) noexcept = default;
+  auto operator=(const TrieChildren &that) -> TrieChildren &;
+  auto operator=(TrieChildren &&that) noexcept -> TrieChildren & = default;
+  ~TrieChildren() = default;
+
+  // Return the child for byte c, nullptr if there is none.
+  auto Find(char c) const -> const std::shared_ptr<const TrieNode> *;
+
+  // Add or replace the child for byte c.
+  void Set(char c, std::shared_ptr<const TrieNode> child);
+
+  // Remove the child for byte c if there is one.
+  void Erase(char c);
+
+  auto Size() const -> size_t { return dense_ != nullptr ? dense_size_ : sparse_.size(); }
+
+  auto Empty() const -> bool { return Size() == 0; }
+
+  auto IsDense() const -> bool { return dense_ != nullptr; }
+
+  // Return the child with the smallest byte not below `from` (as unsigned, 0 to 256) and store that byte in *c,
+  // nullptr if there is none.
+  auto LowerBound(size_t from, char *c) const -> const std::shared_ptr<const TrieNode> *;
+
+  // Call f(c, child) for every child in ascending (unsigned) byte order.
+  template <class F>
+  void ForEach(F &&f) const {
+    if (dense_ != nullptr) {
+      for (size_t i = 0; i < dense_->size(); i++) {
+        if ((*dense_)[i] != nullptr) {
+          f(static_cast<char>(i), (*dense_)[i]);
+        }
+      }
+      return;
+    }
+    for (const auto &[c, child] : sparse_) {
+      f(c, child);
+    }
+  }
+
+ private:
+  using Entry = std::pair<char, std::shared_ptr<const TrieNode>>;
+  std::vector<Entry, TrieNodeAllocator<Entry>> sparse_;
+  std::unique_ptr<std::array<std::shared_ptr<const TrieNode>, 256>> dense_;
+  size_t dense_size_{0};
+};
+
 // A TrieNode is a node in a Trie.
 class TrieNode {
  public:
@@ -47,27 +112,27 @@ class TrieNode {
   TrieNode() = default;
 
   // Create a TrieNode with some children.
-  explicit TrieNode(std::map<char, std::shared_ptr<const TrieNode>> children) : children_(std::move(children)) {}
+  explicit TrieNode(TrieChildren children, std::string prefix = "")
+      : children_(std::move(children)), prefix_(std::move(prefix)) {}
 
   virtual ~TrieNode() = default;
 
-  // Clone returns a copy of this TrieNode. If the TrieNode has a value, the value is copied. The return
-  // type of this function is a unique_ptr to a TrieNode.
+  // Clone returns a copy of this TrieNode. If the TrieNode has a value, the value is copied. The copy is allocated
+  // from TrieNodePool together with its control block.
   //
   // You cannot use the copy constructor to clone the node because it doesn't know whether a `TrieNode`
   // contains a value or not.
-  //
-  // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
-  virtual auto Clone() const -> std::unique_ptr<TrieNode> { return std::make_unique<TrieNode>(children_); }
+  virtual auto Clone() const -> std::shared_ptr<TrieNode> { return MakePooled<TrieNode>(children_, prefix_); }
+
+  // The children, where the key is the next character in the key, and the value is the next TrieNode.
+  TrieChildren children_;
 
-  // A map of children, where the key is the next character in the key, and the value is the next TrieNode.
-  std::map<char, std::shared_ptr<const TrieNode>> children_;
+  // Path compression: the characters following the child byte on the edge from the parent to this node. A chain
+  // of nodes with a single child and no value is collapsed into one node. Always empty for the root.
+  std::string prefix_;
 
   // Indicates if the node is the terminal node.
   bool is_value_node_{false};
-
-  // You can add additional fields and methods here. But in general, you don't need to add extra fields to
-  // complete this project.
 };
 
 // A TrieNodeWithValue is a TrieNode that also has a value of type T associated with it.
@@ -75,25 +140,75 @@ template <class T>
 class TrieNodeWithValue : public TrieNode {
  public:
   // Create a trie node with no children and a value.
-  explicit TrieNodeWithValue(std::shared_ptr<T> value) : value_(std::move(value)) { this->is_value_node_ = true; }
+  explicit TrieNodeWithValue(std::shared_ptr<T> value, std::string prefix = "") : value_(std::move(value)) {
+    this->prefix_ = std::move(prefix);
+    this->is_value_node_ = true;
+  }
 
   // Create a trie node with children and a value.
-  TrieNodeWithValue(std::map<char, std::shared_ptr<const TrieNode>> children, std::shared_ptr<T> value)
-      : TrieNode(std::move(children)), value_(std::move(value)) {
+  TrieNodeWithValue(TrieChildren children, std::shared_ptr<T> value, std::string prefix = "")
+      : TrieNode(std::move(children), std::move(prefix)), value_(std::move(value)) {
     this->is_value_node_ = true;
   }
 
   // Override the Clone method to also clone the value.
-  //
-  // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
-  auto Clone() const -> std::unique_ptr<TrieNode> override {
-    return std::make_unique<TrieNodeWithValue<T>>(children_, value_);
+  auto Clone() const -> std::shared_ptr<TrieNode> override {
+    return MakePooled<TrieNodeWithValue<T>>(children_, value_, prefix_);
   }
 
   // The value associated with this trie node.
   std::shared_ptr<T> value_;
 };
 
+// Iterates the keys of a trie snapshot in ascending (unsigned byte) order, optionally only those under a prefix.
+// Nodes are visited depth first with an explicit stack, so matches are produced one at a time and nothing is
+// materialized. The iterator keeps the root alive, later Puts and Removes do not affect it.
+class TrieIterator {
+ public:
+  // Create an end iterator.
+  TrieIterator() = default;
+
+  auto IsEnd() const -> bool { return stack_.empty(); }
+
+  // The key at the current position.
+  auto Key() const -> const std::string & { return key_; }
+
+  // The value at the current position, nullptr if the value is not of type T.
+  template <class T>
+  auto Value() const -> const T * {
+    const auto *node = dynamic_cast<const TrieNodeWithValue<T> *>(stack_.back().node_);
+    return node != nullptr ? node->value_.get() : nullptr;
+  }
+
+  auto operator++() -> TrieIterator &;
+
+  auto operator==(const TrieIterator &itr) const -> bool;
+
+  auto operator!=(const TrieIterator &itr) const -> bool { return !(*this == itr); }
+
+ private:
+  friend class Trie;
+
+  // Iterate at most `limit` keys in the subtree of start, whose key is `key`.
+  TrieIterator(std::shared_ptr<const TrieNode> root, const TrieNode *start, std::string key, size_t limit);
+
+  // Move to the next value node in depth first order, or to the end.
+  void Advance();
+
+  struct Frame {
+    const TrieNode *node_;
+    // the smallest child byte not visited yet, 256 once all children are done
+    size_t next_;
+    // length of the key up to and including this node
+    size_t key_size_;
+  };
+
+  std::shared_ptr<const TrieNode> root_;
+  std::vector<Frame> stack_;
+  std::string key_;
+  size_t remaining_{0};
+};
+
 // A Trie is a data structure that maps strings to values of type T. All operations on a Trie should not
 // modify the trie itself. It should reuse the existing nodes as much as possible, and create new nodes to
 // represent the new trie.
@@ -105,10 +220,28 @@ class Trie {
   // Create a new trie with the given root.
   explicit Trie(std::shared_ptr<const TrieNode> root) : root_(std::move(root)) {}
 
+  // TrieStore publishes new roots with an atomic compare-and-swap on root_.
+  friend class TrieStore;
+
+  // Put value under rest, where rest is what is left of the key below node. Returns the new copy of node.
+  template <class T>
+  static auto PutAt(const std::shared_ptr<const TrieNode> &node, std::string_view rest, std::shared_ptr<T> value)
+      -> std::shared_ptr<const TrieNode>;
+
+  // Remove rest below node. Returns node itself if nothing changed, nullptr if node is no longer needed.
+  static auto RemoveAt(const std::shared_ptr<const TrieNode> &node, std::string_view rest, bool is_root)
+      -> std::shared_ptr<const TrieNode>;
+
+  // Merge a node without value and with a single child into that child.
+  static auto MergeWithChild(const TrieNode &node) -> std::shared_ptr<const TrieNode>;
+
  public:
   // Create an empty trie.
   Trie() = default;
 
+  // Get the root of the trie, nullptr for an empty trie.
+  auto GetRoot() const -> std::shared_ptr<const TrieNode> { return root_; }
+
   // Get the value associated with the given key.
   // 1. If the key is not in the trie, return nullptr.
   // 2. If the key is in the trie but the type is mismatched, return nullptr.
@@ -120,11 +253,23 @@ class Trie {
   // Returns the new trie.
   template <class T>
   auto Put(std::string_view key, T value) const -> Trie;
-  auto Dfs(const std::shared_ptr<const TrieNode> &root, std::string_view key, size_t index) const
-      -> std::shared_ptr<const TrieNode>;
+
+  // Same as Put, but takes an already allocated value, so that a writer can retry the put on a newer root
+  // without moving the value again.
+  template <class T>
+  auto PutShared(std::string_view key, std::shared_ptr<T> value) const -> Trie;
+
   // Remove the key from the trie. If the key does not exist, return the original trie.
   // Otherwise, returns the new trie.
   auto Remove(std::string_view key) const -> Trie;
+
+  // Iterate all keys in order.
+  auto Begin() const -> TrieIterator { return PrefixScan(""); }
+
+  auto End() const -> TrieIterator { return {}; }
+
+  // Iterate at most `limit` keys starting with `prefix`, in order.
+  auto PrefixScan(std::string_view prefix, size_t limit = SIZE_MAX) const -> TrieIterator;
 };
 
 }  // namespace bustub
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace bustub {
+
+// Size classes of the pool are multiples of TRIE_POOL_GRANULARITY bytes up to TRIE_POOL_MAX_BLOCK, larger requests
+// go to operator new.
+static constexpr size_t TRIE_POOL_GRANULARITY = 16;
+static constexpr size_t TRIE_POOL_MAX_BLOCK = 512;
+// Every refill of a thread cache carves a slab of this many bytes.
+static constexpr size_t TRIE_POOL_SLAB_SIZE = 64 * 1024;
+// Number of blocks moved between a thread cache and the shared free lists at once.
+static constexpr size_t TRIE_POOL_BATCH = 64;
+
+// A pool of fixed-size blocks for trie nodes, their values and child arrays. Each thread allocates from and frees
+// into its own free lists without locking; a thread that frees much more than it allocates hands blocks back to the
+// shared free lists in batches, and a thread returns its whole cache when it exits. Slabs are never given back to
+// the operating system, the memory of released snapshots is reused by later Puts.
+class TrieNodePool {
+ public:
+  static auto Allocate(size_t size) -> void *;
+
+  static void Deallocate(void *ptr, size_t size);
+
+  // Number of slabs carved so far, for tests and benchmarks.
+  static auto SlabCount() -> size_t;
+};
+
+// A std allocator drawing from TrieNodePool, used with std::allocate_shared so that a node and its control block
+// are a single pooled block.
+template <class T>
+class TrieNodeAllocator {
+ public:
+  using value_type = T;
+
+  TrieNodeAllocator() = default;
+
+  template <class U>
+  TrieNodeAllocator(const TrieNodeAllocator<U> & /*unused*/) noexcept {}  // NOLINT
+
+  auto allocate(size_t n) -> T * { return static_cast<T *>(TrieNodePool::Allocate(n * sizeof(T))); }  // NOLINT
+
+  void deallocate(T *ptr, size_t n) { TrieNodePool::Deallocate(ptr, n * sizeof(T)); }  // NOLINT
+
+  template <class U>
+  auto operator==(const TrieNodeAllocator<U> & /*unused*/) const -> bool {
+    return true;
+  }
+
+  template <class U>
+  auto operator!=(const TrieNodeAllocator<U> & /*unused*/) const -> bool {
+    return false;
+  }
+};
+
+// make_shared on the trie node pool.
+template <class T, class... Args>
+auto MakePooled(Args &&...args) -> std::shared_ptr<T> {
+  return std::allocate_shared<T>(TrieNodeAllocator<std::remove_const_t<T>>(), std::forward<Args>(args)...);
+}
+
+}  // namespace bustub
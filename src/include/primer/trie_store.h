@@ -1,7 +1,7 @@
 #pragma once
 
 #include <optional>
-#include <shared_mutex>
+#include <memory>
 #include <utility>
 
 #include "primer/trie.h"
@@ -22,7 +22,9 @@ class ValueGuard {
 };
 
 // This class is a thread-safe wrapper around the Trie class. It provides a simple interface for
-// accessing the trie. It should allow concurrent reads and a single write operation at the same
+// accessing the trie. It takes no locks: readers load the current root and keep it alive through
+// the ValueGuard, and writers publish a new root with a compare-and-swap, retrying on the newer
+// root when another writer got there first. Reads and any number of writes can run at the same
 // time.
 class TrieStore {
  public:
@@ -40,15 +42,11 @@ class TrieStore {
   void Remove(std::string_view key);
 
  private:
-  // This mutex protects the root. Everytime you want to access the trie root or modify it, you
-  // will need to take this lock.
-  std::mutex root_lock_;
-
-  // This mutex sequences all writes operations and allows only one write operation at a time.
-  std::mutex write_lock_;
-
-  // Stores the current root for the trie.
-  Trie root_;
+  // Stores the current root for the trie. It is only read with std::atomic_load and replaced with
+  // std::atomic_compare_exchange_strong, so readers never block and writers build their new trie
+  // concurrently. A writer whose compare-and-swap loses to another writer redoes its update on the
+  // newer root.
+  std::shared_ptr<const TrieNode> root_;
 };
 
 }  // namespace bustub
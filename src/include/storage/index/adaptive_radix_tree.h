@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.h
+//
+// Identification: src/include/storage/index/adaptive_radix_tree.h
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * adaptive_radix_tree.h
+ *
+ * In-memory Adaptive Radix Tree (Leis et al., ICDE 2013). Inner nodes grow
+ * and shrink between Node4, Node16, Node48 and Node256 with their fan-out,
+ * and chains of single-child nodes are collapsed into a compressed prefix.
+ * (1) Keys are fixed-length byte strings, so no key is a prefix of another
+ * (2) We only support unique key
+ * (3) Leaves store the full key; prefixes longer than ART_MAX_PREFIX_LEN are
+ *     checked optimistically and verified against the leaf
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace bustub {
+
+static constexpr uint32_t ART_MAX_PREFIX_LEN = 8;
+
+enum class ArtNodeType : uint8_t { LEAF = 0, NODE4, NODE16, NODE48, NODE256 };
+
+template <typename ValueType>
+class AdaptiveRadixTree {
+ public:
+  explicit AdaptiveRadixTree(size_t key_size);
+
+  /**
+   * Insert a key-value pair.
+   * @return false if the key already exists
+   */
+  auto Insert(const uint8_t *key, const ValueType &value) -> bool;
+
+  /**
+   * Remove a key and its value.
+   * @return false if the key does not exist
+   */
+  auto Remove(const uint8_t *key) -> bool;
+
+  /**
+   * Point lookup.
+   * @return true and fill value if the key exists
+   */
+  auto GetValue(const uint8_t *key, ValueType *value) const -> bool;
+
+  auto Size() const -> size_t { return size_; }
+
+  auto IsEmpty() const -> bool { return size_ == 0; }
+
+ private:
+  struct Node {
+    explicit Node(ArtNodeType type) : type_(type) {}
+    virtual ~Node() = default;
+
+    ArtNodeType type_;
+    uint16_t num_children_{0};
+    // length of the compressed path, only the first ART_MAX_PREFIX_LEN bytes are stored
+    uint32_t prefix_len_{0};
+    std::array<uint8_t, ART_MAX_PREFIX_LEN> prefix_{};
+  };
+
+  struct Leaf : public Node {
+    Leaf(const uint8_t *key, size_t key_size, const ValueType &value)
+        : Node(ArtNodeType::LEAF), key_(key, key + key_size), value_(value) {}
+
+    std::vector<uint8_t> key_;
+    ValueType value_;
+  };
+
+  // Node4 and Node16 keep key bytes sorted with children at the same position
+  struct Node4 : public Node {
+    Node4() : Node(ArtNodeType::NODE4) {}
+
+    std::array<uint8_t, 4> keys_{};
+    std::array<std::unique_ptr<Node>, 4> children_;
+  };
+
+  struct Node16 : public Node {
+    Node16() : Node(ArtNodeType::NODE16) {}
+
+    std::array<uint8_t, 16> keys_{};
+    std::array<std::unique_ptr<Node>, 16> children_;
+  };
+
+  // Node48 maps a key byte to slot + 1 in children_, 0 means no child
+  struct Node48 : public Node {
+    Node48() : Node(ArtNodeType::NODE48) {}
+
+    std::array<uint8_t, 256> child_index_{};
+    std::array<std::unique_ptr<Node>, 48> children_;
+  };
+
+  struct Node256 : public Node {
+    Node256() : Node(ArtNodeType::NODE256) {}
+
+    std::array<std::unique_ptr<Node>, 256> children_;
+  };
+
+  auto InsertAt(std::unique_ptr<Node> &node_ref, const uint8_t *key, size_t depth, const ValueType &value) -> bool;
+
+  auto RemoveAt(std::unique_ptr<Node> &node_ref, const uint8_t *key, size_t depth) -> bool;
+
+  // return the slot holding the child for byte, nullptr if there is none
+  static auto FindChild(Node *node, uint8_t byte) -> std::unique_ptr<Node> *;
+
+  // add a child, growing node_ref into the next node type when it is full
+  static void AddChild(std::unique_ptr<Node> &node_ref, uint8_t byte, std::unique_ptr<Node> child);
+
+  // remove a child, shrinking node_ref into the previous node type when it gets sparse
+  static void RemoveChild(std::unique_ptr<Node> &node_ref, uint8_t byte);
+
+  // number of prefix bytes of node matching key from depth, only looks at the stored bytes
+  auto CheckPrefix(const Node *node, const uint8_t *key, size_t depth) const -> uint32_t;
+
+  // number of prefix bytes of node matching key from depth, recovers unstored bytes from a leaf
+  auto PrefixMismatch(const Node *node, const uint8_t *key, size_t depth) const -> uint32_t;
+
+  static auto Minimum(const Node *node) -> const Leaf *;
+
+  // copy the compressed prefix when a node changes type
+  static void CopyPrefix(Node *dst, const Node *src);
+
+  auto LeafMatches(const Node *node, const uint8_t *key) const -> bool;
+
+  size_t key_size_;
+  size_t size_{0};
+  std::unique_ptr<Node> root_;
+};
+
+}  // namespace bustub
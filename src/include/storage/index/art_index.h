@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.h
+//
+// Identification: src/include/storage/index/art_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include "storage/index/adaptive_radix_tree.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+#define ART_INDEX_TYPE ARTIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * Memory-resident index backed by an adaptive radix tree over the raw key bytes. It does not go through the
+ * buffer pool, so it is meant for small, hot tables, and only supports point lookups (no ordered iteration).
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ARTIndex : public Index {
+ public:
+  explicit ARTIndex(std::unique_ptr<IndexMetadata> &&metadata);
+
+  ~ARTIndex() override = default;
+
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ protected:
+  // the tree itself is not thread-safe: lookups share it, modifications take it exclusively
+  std::shared_mutex latch_;
+  // container
+  AdaptiveRadixTree<ValueType> container_;
+};
+
+}  // namespace bustub
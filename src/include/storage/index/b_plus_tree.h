@@ -11,12 +11,16 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
 #include <deque>
 #include <iostream>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <queue>
 #include <shared_mutex>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
@@ -54,6 +58,7 @@ class Context {
   // You may want to use this when getting value, but not necessary.
   std::deque<ReadPageGuard> read_set_;
 
+  // Page ids of the internal pages on the path from the root to the current page.
   std::deque<page_id_t> access_set_;
 
   auto IsRootPage(page_id_t page_id) -> bool { return page_id == root_page_id_; }
@@ -75,6 +80,8 @@ class BPlusTree {
                      const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
                      int internal_max_size = INTERNAL_PAGE_SIZE);
 
+  ~BPlusTree();
+
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
 
@@ -87,15 +94,29 @@ class BPlusTree {
 
   void ReplaceKeyAt(BPlusTree::InternalPage *page, const KeyType &src, const KeyType &dst, Context &ctx);
 
-  auto InsertGetKeyAt(const KeyType &key, const KeyComparator &comparator, Context &ctx) -> page_id_t;
-
   auto DeleteGetKeyAt(const KeyType &key, const KeyComparator &comparator, Context &ctx) -> page_id_t;
   // Remove Entry From leaf page or internal page
   void RemoveEntry(page_id_t basic_page_id, const KeyType &key, Context &ctx);
 
+  // Shrink the root, or merge / redistribute an underfull page after entries were removed from it
+  void RebalancePage(WritePageGuard basic_page_guard, page_id_t basic_page_id, const KeyType &key, Context &ctx);
+
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *txn);
 
+  /**
+   * Defer merges: Remove() only takes keys out of the leaf, and a background thread merges the
+   * leaves that dropped below merge_threshold entries (capped at the leaf min size). Does nothing
+   * if the background thread is already running.
+   */
+  void StartLazyMerge(int merge_threshold);
+
+  // Stop the background merge thread and compact whatever it left behind.
+  void StopLazyMerge();
+
+  // Merge or redistribute the leaves recorded as underfull by lazy deletes.
+  void CompactUnderfullPages();
+
   // Return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
 
@@ -138,7 +159,7 @@ class BPlusTree {
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *txn = nullptr);
 
-  void InsertInParent(page_id_t leaf_page_left_id, KeyType key, page_id_t leaf_page_right_id, Context &ctx);
+  void InsertInParent(WritePageGuard &&left_page_guard, const KeyType &key, page_id_t right_page_id, Context &ctx);
 
   auto GetParentPageId(page_id_t child, Context &ctx) -> page_id_t;
 
@@ -148,8 +169,11 @@ class BPlusTree {
 
   void PrintTree(page_id_t page_id, const BPlusTreePage *page);
 
-  // return the leaf page of key
-  auto GetKeyAt(const KeyType &key, const KeyComparator &comparator, Context &ctx) -> page_id_t;
+  // return the page on the given level (0 for leaves) whose key range covers key
+  auto FindPageAtLevel(const KeyType &key, int level, Context &ctx) -> page_id_t;
+
+  // background merge loop, runs every b_plus_tree_merge_interval
+  void RunLazyMerge();
 
   /**
    * @brief Convert A B+ tree into a Printable B+ tree
@@ -167,6 +191,18 @@ class BPlusTree {
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+  // Inserts, lookups and leaf-only deletes share the tree and rely on right links to get past concurrent splits.
+  // Deletes that merge or redistribute pages take it exclusively, since they free pages readers may be heading to.
+  std::shared_mutex structure_latch_;
+
+  std::atomic<bool> enable_lazy_merge_{false};
+  std::atomic<int> merge_threshold_{0};
+  std::thread *merge_thread_{nullptr};
+  // Keys removed from leaves that were left underfull, one per lazy delete.
+  std::mutex underfull_latch_;
+  std::vector<KeyType> underfull_keys_;
+  // Wakes the merge thread early when lazy merging is stopped.
+  std::condition_variable merge_cv_;
 };
 
 /**
@@ -15,6 +15,7 @@
 #include <cstring>
 
 #include "storage/table/tuple.h"
+#include "type/dictionary.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -46,6 +47,9 @@ class GenericKey {
     const auto &col = schema->GetColumn(column_idx);
     const TypeId column_type = col.GetType();
     const bool is_inlined = col.IsInlined();
+    if (col.GetDictionary() != nullptr) {
+      return col.GetDictionary()->Decode(*reinterpret_cast<const uint32_t *>(data_ + col.GetOffset()));
+    }
     if (is_inlined) {
       data_ptr = (data_ + col.GetOffset());
     } else {
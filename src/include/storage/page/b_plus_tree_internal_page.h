@@ -18,7 +18,7 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 12
+#define INTERNAL_PAGE_HEADER_SIZE (20 + sizeof(KeyType))
 #define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
@@ -32,6 +32,13 @@ namespace bustub {
  *  --------------------------------------------------------------------------
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ * Besides the common header, an internal page keeps a right link to its right
+ * sibling on the same level and a high key, the exclusive upper bound of the keys
+ * in its subtree (only meaningful when the right link is valid):
+ *  --------------------------------------------------------------------------
+ * | Common Header (16) | RightPageId (4) | HighKey (key size) |
+ *  --------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -50,6 +57,21 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   void SetValueAt(int index, const ValueType &value);
   void InsertFirstOf(const page_id_t &value);
 
+  auto GetRightPageId() const -> page_id_t;
+  void SetRightPageId(page_id_t right_page_id);
+  auto GetHighKey() const -> KeyType;
+  void SetHighKey(const KeyType &high_key);
+
+  /**
+   * @return true if key is not covered by this page and the search must follow the right link
+   */
+  auto NeedMoveRight(const KeyType &key, const KeyComparator &comparator) const -> bool;
+
+  /**
+   * @return the child page whose subtree covers key
+   */
+  auto ChildFor(const KeyType &key, const KeyComparator &comparator) const -> ValueType;
+
   /**
    * @param index The index of the key to get. Index must be non-zero.
    * @return Key at index
@@ -113,6 +135,8 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   }
 
  private:
+  page_id_t right_page_id_;
+  KeyType high_key_;
   // Flexible array member for page data.
   MappingType array_[0];
 };
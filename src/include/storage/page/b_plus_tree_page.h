@@ -33,10 +33,14 @@ enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
  * It actually serves as a header part for each B+ tree page and
  * contains information shared by both leaf page and internal page.
  *
- * Header format (size in byte, 12 bytes in total):
+ * Header format (size in byte, 16 bytes in total):
  * ----------------------------------------------------------------------------
- * | PageType (4) | CurrentSize (4) | MaxSize (4) |
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | Level (4) |
  * ----------------------------------------------------------------------------
+ *
+ * Level is 0 for leaf pages and grows by one towards the root. Together with
+ * the right link and high key kept by leaf and internal pages it lets the tree
+ * find the parent level of a split without holding latches on the ancestors.
  */
 class BPlusTreePage {
  public:
@@ -56,11 +60,15 @@ class BPlusTreePage {
   void SetMaxSize(int max_size);
   auto GetMinSize() const -> int;
 
+  auto GetLevel() const -> int;
+  void SetLevel(int level);
+
  private:
   // member variable, attributes that both internal and leaf page share
   IndexPageType page_type_;
   int size_;
   int max_size_;
+  int level_;
 };
 
 }  // namespace bustub
@@ -33,6 +33,14 @@ namespace bustub {
  *  The above format omits the space required for the occupied_ and
  *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
  *
+ *  Each slot also has a one-byte fingerprint (the top byte of the key's hash)
+ *  in fingerprints_. Lookups compare the fingerprints 16 at a time and only
+ *  read the full key of slots whose fingerprint matches.
+ *
+ *  A bucket whose keys cannot be told apart by splitting, e.g. many values of
+ *  one key, continues in a chain of overflow bucket pages linked by
+ *  next_page_id_. The directory only points to the first page of a chain.
+ *
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBucketPage {
@@ -40,12 +48,25 @@ class HashTableBucketPage {
   // Delete all constructor / destructor to ensure memory safety
   HashTableBucketPage() = delete;
 
+  /**
+   * Make a new page an empty bucket without an overflow page.
+   */
+  void Init();
+
+  /**
+   * @return the next overflow page of this bucket, INVALID_PAGE_ID if this is the last page of the chain
+   */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
   /**
    * Scan the bucket and collect values that have the matching key
    *
+   * @param fingerprint Fingerprint() of the key's hash
    * @return true if at least one key matched
    */
-  auto GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool;
+  auto GetValue(KeyType key, uint8_t fingerprint, KeyComparator cmp, std::vector<ValueType> *result) -> bool;
 
   /**
    * Attempts to insert a key and value in the bucket.  Uses the occupied_
@@ -53,16 +74,18 @@ class HashTableBucketPage {
    *
    * @param key key to insert
    * @param value value to insert
+   * @param fingerprint Fingerprint() of the key's hash
    * @return true if inserted, false if duplicate KV pair or bucket is full
    */
-  auto Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool;
+  auto Insert(KeyType key, ValueType value, uint8_t fingerprint, KeyComparator cmp) -> bool;
 
   /**
    * Removes a key and value.
    *
+   * @param fingerprint Fingerprint() of the key's hash
    * @return true if removed, false if not found
    */
-  auto Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool;
+  auto Remove(KeyType key, ValueType value, uint8_t fingerprint, KeyComparator cmp) -> bool;
 
   /**
    * Gets the key at an index in the bucket.
@@ -80,6 +103,11 @@ class HashTableBucketPage {
    */
   auto ValueAt(uint32_t bucket_idx) const -> ValueType;
 
+  /**
+   * Gets the fingerprint stored for the key at an index in the bucket.
+   */
+  auto FingerprintAt(uint32_t bucket_idx) const -> uint8_t;
+
   /**
    * Remove the KV pair at bucket_idx
    */
@@ -137,11 +165,29 @@ class HashTableBucketPage {
    */
   void PrintBucket();
 
+  /**
+   * @return the fingerprint stored for a key with the given hash. The directory uses the low bits of the hash, the
+   * fingerprint is its top byte, so the table hashes each key once per operation.
+   */
+  static auto Fingerprint(uint64_t hash) -> uint8_t { return static_cast<uint8_t>(hash >> 56); }
+
  private:
+  /**
+   * @return the number of occupied slots, occupied slots always form a prefix of the bucket
+   */
+  auto NumOccupied() const -> uint32_t;
+
+  /**
+   * @return bit i is set if slot base + i is readable and its fingerprint equals fingerprint, base is a multiple of 16
+   */
+  auto MatchFingerprint(uint8_t fingerprint, uint32_t base) const -> uint32_t;
+
+  page_id_t next_page_id_;
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
   char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
   char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  uint8_t fingerprints_[BUCKET_ARRAY_SIZE];
   // Flexible array member for page data.
   MappingType array_[1];
 };
@@ -14,6 +14,7 @@
 
 #include <cassert>
 #include <climits>
+#include <cstddef>
 #include <cstdlib>
 #include <string>
 
@@ -24,7 +25,8 @@ namespace bustub {
 
 /**
  *
- * Header Page for linear probing hash table.
+ * Header Page for linear probing hash table. A table with more blocks than
+ * MaxBlocks() keeps the page ids of further header pages here instead of blocks.
  *
  * Header format (size in byte, 16 bytes in total):
  * -------------------------------------------------------------
@@ -89,13 +91,18 @@ class HashTableHeaderPage {
    */
   auto NumBlocks() -> size_t;
 
+  /**
+   * @return the number of block page_ids that fit in a header page
+   */
+  static auto MaxBlocks() -> size_t;
+
  private:
-  __attribute__((unused)) lsn_t lsn_;
-  __attribute__((unused)) size_t size_;
-  __attribute__((unused)) page_id_t page_id_;
-  __attribute__((unused)) size_t next_ind_;
+  lsn_t lsn_;
+  size_t size_;
+  page_id_t page_id_;
+  size_t next_ind_;
   // Flexible array member for page data.
-  __attribute__((unused)) page_id_t block_page_ids_[1];
+  page_id_t block_page_ids_[1];
 };
 
 }  // namespace bustub
@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_page.h
+//
+// Identification: src/include/storage/page/overflow_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+static constexpr uint64_t OVERFLOW_PAGE_HEADER_SIZE = 8;
+static constexpr uint64_t OVERFLOW_PAGE_DATA_SIZE = BUSTUB_PAGE_SIZE - OVERFLOW_PAGE_HEADER_SIZE;
+
+/**
+ * One page of a value stored out of line. Large values are split over a chain of overflow pages.
+ *
+ * Header format (size in byte, 8 bytes in total):
+ * ----------------------------------------
+ * | NextPageId (4) | DataSize (4) | Data |
+ * ----------------------------------------
+ */
+class OverflowPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  OverflowPage() = delete;
+  OverflowPage(const OverflowPage &other) = delete;
+
+  void Init(page_id_t next_page_id, uint32_t data_size) {
+    next_page_id_ = next_page_id;
+    data_size_ = data_size;
+  }
+
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  auto GetDataSize() const -> uint32_t { return data_size_; }
+
+  auto GetData() const -> const char * { return data_; }
+
+  auto GetData() -> char * { return data_; }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t data_size_;
+  char data_[0];
+};
+
+static_assert(sizeof(OverflowPage) == OVERFLOW_PAGE_HEADER_SIZE);
+
+}  // namespace bustub
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.h
+//
+// Identification: src/include/storage/page/pax_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+static constexpr uint64_t PAX_PAGE_HEADER_SIZE = 8;
+
+/**
+ * PAX (partition attributes across) page format. The page holds up to Capacity rows, each column in its own
+ * minipage, so reading one column of every row only touches that column's bytes. Only schemas of fixed-length
+ * columns can be stored this way.
+ *
+ *  Header format (size in bytes):
+ *  ----------------------------------------------------
+ *  | NextPageId (4) | NumTuples (2) | Capacity (2) |
+ *  ----------------------------------------------------
+ *  -----------------------------------------------------------------------------------------------
+ *  | TupleMeta x Capacity | Column 0 x Capacity | Column 1 x Capacity | ... | Column N x Capacity |
+ *  -----------------------------------------------------------------------------------------------
+ *
+ * The minipage of a column starts at HEADER + Capacity * (TUPLE_META_SIZE + column offset in the schema), since the
+ * column offsets of a fixed-length schema are the sums of the lengths of the columns before it.
+ */
+class PaxPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  PaxPage() = delete;
+  PaxPage(const PaxPage &other) = delete;
+
+  /** @return whether tuples of the schema can be stored in PAX pages */
+  static auto SupportsSchema(const Schema &schema) -> bool;
+
+  /** @return the number of rows of the schema a page holds */
+  static auto Capacity(const Schema &schema) -> uint16_t;
+
+  /** Initialize an empty page for tuples of the schema. */
+  void Init(const Schema &schema);
+
+  /** @return number of tuples in this page */
+  auto GetNumTuples() const -> uint32_t { return num_tuples_; }
+
+  /** @return the page ID of the next table page */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** Set the page id of the next page in the table. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /**
+   * Insert a tuple.
+   * @return the slot of the tuple, std::nullopt if the page is full
+   */
+  auto InsertTuple(const Schema &schema, const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t>;
+
+  /** Read a tuple, assembling its row from every minipage. */
+  auto GetTuple(const Schema &schema, const RID &rid) const -> std::pair<TupleMeta, Tuple>;
+
+  auto GetTupleMeta(const RID &rid) const -> TupleMeta;
+
+  void UpdateTupleMeta(const TupleMeta &meta, const RID &rid);
+
+  /** Overwrite a tuple, all tuples of a schema have the same size. */
+  void UpdateTuple(const Schema &schema, const TupleMeta &meta, const Tuple &tuple, const RID &rid);
+
+  /**
+   * Append the values of one column of the live tuples to out, reading only that column's minipage.
+   */
+  void ReadColumn(const Schema &schema, uint32_t column_idx, std::vector<Value> *out) const;
+
+ private:
+  auto ColumnData(const Schema &schema, uint32_t column_idx) const -> const char *;
+
+  auto ColumnData(const Schema &schema, uint32_t column_idx) -> char *;
+
+  auto Metas() const -> const TupleMeta * { return reinterpret_cast<const TupleMeta *>(data_); }
+
+  auto Metas() -> TupleMeta * { return reinterpret_cast<TupleMeta *>(data_); }
+
+  page_id_t next_page_id_;
+  uint16_t num_tuples_;
+  uint16_t capacity_;
+  char data_[0];
+};
+
+static_assert(sizeof(PaxPage) == PAX_PAGE_HEADER_SIZE);
+
+}  // namespace bustub
@@ -27,7 +27,12 @@
 
 namespace bustub {
 
-static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = 8;
+static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = 12;
+/** The slot holds the RID of the tuple's current location instead of the tuple. */
+static constexpr uint16_t TUPLE_FORWARDED = 0x8000;
+/** The slot holds the body of a tuple forwarded from another slot, scans skip it. */
+static constexpr uint16_t TUPLE_MOVED = 0x4000;
+static constexpr uint16_t TUPLE_SIZE_MASK = 0x3FFF;
 
 /**
  * Slotted page format:
@@ -38,15 +43,24 @@ static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = 8;
  *                                free space pointer
  *
  *  Header format (size in bytes):
- *  ----------------------------------------------------------------------------
- *  | NextPageId (4)| NumTuples(2) | NumDeletedTuples(2) |
- *  ----------------------------------------------------------------------------
+ *  ----------------------------------------------------------------------------------------------
+ *  | NextPageId (4)| NumTuples(2) | NumDeletedTuples(2) | TupleStart(2) | NumFreeSlots(2) |
+ *  ----------------------------------------------------------------------------------------------
  *  ----------------------------------------------------------------
  *  | Tuple_1 offset+size (4) | Tuple_2 offset+size (4) | ... |
  *  ----------------------------------------------------------------
  *
  * Tuple format:
  * | meta | data |
+ *
+ * Tuples are packed downwards from the end of the page to TupleStart. Vacuum turns the slots of deleted tuples into
+ * free slots (size 0, marked deleted) and packs the remaining tuples together; later inserts reuse free slots before
+ * appending new ones, so the RIDs of live tuples never change.
+ *
+ * An update that changes the tuple size is done in place: a smaller tuple overwrites the old one, a larger one is
+ * moved within the page, packing the other tuples if needed. When it does not fit in the page at all, the table heap
+ * stores it in another page as a moved tuple (TUPLE_MOVED) and the home slot keeps the meta and the RID of the moved
+ * tuple as its data (TUPLE_FORWARDED). The two flags live in the top bits of the size field.
  */
 
 class TablePage {
@@ -59,6 +73,19 @@ class TablePage {
   /** @return number of tuples in this page */
   auto GetNumTuples() const -> uint32_t { return num_tuples_; }
 
+  /** @return number of deleted tuples whose space has not been reclaimed by Vacuum yet */
+  auto GetNumDeletedTuples() const -> uint32_t { return num_deleted_tuples_; }
+
+  /** @return the size of the largest tuple that can still be inserted into this page */
+  auto GetFreeSpace() const -> uint32_t;
+
+  /**
+   * Reclaim the space of deleted tuples: their slots become free slots for later inserts and the remaining tuples
+   * are packed at the end of the page. Must only be called once no running transaction can roll the deletes back.
+   * @return the number of slots freed
+   */
+  auto Vacuum() -> uint32_t;
+
   /** @return the page ID of the next table page */
   auto GetNextPageId() const -> page_id_t { return next_page_id_; }
 
@@ -71,9 +98,10 @@ class TablePage {
   /**
    * Insert a tuple into the table.
    * @param tuple tuple to insert
+   * @param is_moved whether the tuple is the body of a forwarded tuple
    * @return true if the insert is successful (i.e. there is enough space)
    */
-  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t>;
+  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple, bool is_moved = false) -> std::optional<uint16_t>;
 
   /**
    * Update a tuple.
@@ -85,6 +113,11 @@ class TablePage {
    */
   auto GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Read a tuple without copying it out of the page, the view is only valid while the page is latched.
+   */
+  auto GetTupleView(const RID &rid) const -> std::pair<TupleMeta, TupleView>;
+
   /**
    * Read a tuple meta from a table.
    */
@@ -95,6 +128,24 @@ class TablePage {
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /**
+   * Replace a tuple with one of any size, keeping its slot. Clears the forwarding of the slot.
+   * @return false if the new tuple does not fit in this page, the page is left unchanged then
+   */
+  auto UpdateTupleInPlace(const TupleMeta &meta, const Tuple &tuple, const RID &rid) -> bool;
+
+  /** @return where the tuple in the slot lives now, std::nullopt if the slot is not forwarded */
+  auto GetForward(const RID &rid) const -> std::optional<RID>;
+
+  /**
+   * Forward the slot to a tuple moved to another location. Needs sizeof(RID) bytes in the page if the old tuple is
+   * smaller than that.
+   */
+  void SetForward(const TupleMeta &meta, const RID &rid, const RID &target);
+
+  /** @return whether the slot holds the body of a forwarded tuple */
+  auto IsMovedTuple(uint32_t tuple_id) const -> bool;
+
   static_assert(sizeof(page_id_t) == 4);
 
  private:
@@ -103,10 +154,29 @@ class TablePage {
   page_id_t next_page_id_;
   uint16_t num_tuples_;
   uint16_t num_deleted_tuples_;
+  uint16_t tuple_start_;
+  uint16_t num_free_slots_;
   TupleInfo tuple_info_[0];
 
   static constexpr size_t TUPLE_INFO_SIZE = 16;
   static_assert(sizeof(TupleInfo) == TUPLE_INFO_SIZE);
+
+  static auto IsFreeSlot(const TupleInfo &info) -> bool {
+    return std::get<1>(info) == 0 && std::get<2>(info).is_deleted_;
+  }
+
+  /** Bytes between the slot array and the tuple data. */
+  auto ContiguousFreeSpace() const -> size_t;
+
+  /**
+   * Make room for len bytes of tuple data, packing the tuples at the end of the page if the contiguous free space is
+   * too small. The data of skip_id, if given, is dropped.
+   * @return the offset to write the data at, std::nullopt if the page cannot hold it
+   */
+  auto Allocate(size_t len, std::optional<uint16_t> skip_id) -> std::optional<uint16_t>;
+
+  /** Pack the data of all slots at the end of the page. */
+  void Compact();
 };
 
 static_assert(sizeof(TablePage) == TABLE_PAGE_HEADER_SIZE);
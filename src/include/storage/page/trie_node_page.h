@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// trie_node_page.h
+//
+// Identification: src/include/storage/page/trie_node_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+static constexpr uint32_t DISK_TRIE_MAGIC = 0x54524945;
+static constexpr uint32_t DISK_TRIE_MAX_KEY_SIZE = 1024;
+static constexpr uint32_t DISK_TRIE_MAX_VALUE_SIZE = 1024;
+
+/**
+ * Header page of a DiskTrie. A commit is published by overwriting the root page id here.
+ *
+ * Header format (size in byte, 8 bytes in total):
+ * ----------------------------------
+ * | Magic (4) | RootPageId (4) |
+ * ----------------------------------
+ */
+class DiskTrieHeaderPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  DiskTrieHeaderPage() = delete;
+  DiskTrieHeaderPage(const DiskTrieHeaderPage &other) = delete;
+
+  uint32_t magic_;
+  page_id_t root_page_id_;
+};
+
+/**
+ * One node of a DiskTrie. Pages are written once and never modified after the commit that created them is
+ * published, an update writes new pages for the whole path instead.
+ *
+ * Node format (keys are sorted as unsigned bytes, children_[i] is the child for keys_[i]):
+ * ---------------------------------------------------------------------------------------------------
+ * | HasValue (1) | Unused (1) | NumChildren (2) | PrefixLen (2) | ValueLen (2) | Keys (256) | Children (1024) |
+ * ---------------------------------------------------------------------------------------------------
+ * | Prefix | Value |
+ * ------------------
+ */
+class TrieNodePage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  TrieNodePage() = delete;
+  TrieNodePage(const TrieNodePage &other) = delete;
+
+  /**
+   * Write a whole node into the page.
+   * @param value nullptr if the node has no value
+   * @param children (key byte, child page id) pairs sorted as unsigned bytes
+   */
+  void Init(std::string_view prefix, const std::string_view *value,
+            const std::vector<std::pair<char, page_id_t>> &children);
+
+  /** @return the compressed path above this node, always empty for the root */
+  auto GetPrefix() const -> std::string_view;
+
+  auto HasValue() const -> bool;
+
+  auto GetValue() const -> std::string_view;
+
+  auto GetNumChildren() const -> uint32_t;
+
+  auto KeyAt(uint32_t index) const -> char;
+
+  auto ChildAt(uint32_t index) const -> page_id_t;
+
+  /** @return the child for key byte c, INVALID_PAGE_ID if there is none */
+  auto FindChild(char c) const -> page_id_t;
+
+ private:
+  uint8_t has_value_;
+  uint8_t unused_;
+  uint16_t num_children_;
+  uint16_t prefix_len_;
+  uint16_t value_len_;
+  char keys_[256];
+  page_id_t children_[256];
+  // Flexible array member for prefix and value bytes
+  char data_[0];
+};
+
+static_assert(sizeof(TrieNodePage) + DISK_TRIE_MAX_KEY_SIZE + DISK_TRIE_MAX_VALUE_SIZE <= BUSTUB_PAGE_SIZE,
+              "a trie node with the largest prefix and value must fit in a page");
+
+}  // namespace bustub
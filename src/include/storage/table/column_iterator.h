@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_iterator.h
+//
+// Identification: src/include/storage/table/column_iterator.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rid.h"
+#include "type/value.h"
+
+namespace bustub {
+
+class TableHeap;
+
+/**
+ * The live rows of one page of a PAX table, with one vector per requested column. columns_[i][j] is the value of the
+ * i-th requested column in the row rids_[j].
+ */
+struct ColumnBatch {
+  std::vector<RID> rids_;
+  std::vector<std::vector<Value>> columns_;
+};
+
+/**
+ * ColumnIterator reads a PAX table a page at a time, touching only the minipages of the requested columns.
+ */
+class ColumnIterator {
+ public:
+  ColumnIterator(TableHeap *table_heap, std::vector<uint32_t> column_ids)
+      : table_heap_(table_heap), column_ids_(std::move(column_ids)) {}
+
+  /**
+   * Read the next page into batch. Pages without live rows give an empty batch.
+   * @return false if the whole table has been read
+   */
+  auto Next(ColumnBatch *batch) -> bool;
+
+ private:
+  TableHeap *table_heap_;
+  std::vector<uint32_t> column_ids_;
+  page_id_t page_id_{INVALID_PAGE_ID};
+  bool started_{false};
+};
+
+}  // namespace bustub
@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** Free space is tracked in steps of this many bytes. */
+static constexpr uint32_t FSM_CATEGORY_SIZE = 32;
+static constexpr uint32_t FSM_NUM_CATEGORIES = BUSTUB_PAGE_SIZE / FSM_CATEGORY_SIZE + 1;
+
+/**
+ * FreeSpaceMap records approximately how many bytes are free in each page of a table heap, so that inserts can go
+ * to a page with room instead of always extending the heap. Like the PostgreSQL FSM, a page is only known to have
+ * free space in FSM_CATEGORY_SIZE steps, rounded down; the caller updates the entry whenever it learns the exact
+ * amount. Not thread-safe, the table heap latch protects it.
+ */
+class FreeSpaceMap {
+ public:
+  /** Record that the page can hold a tuple of up to free_bytes bytes. */
+  void Update(page_id_t page_id, uint32_t free_bytes);
+
+  /** Stop tracking the page, e.g. while it is reserved by one inserter. */
+  void Remove(page_id_t page_id);
+
+  /** @return the lowest page id that has room for a tuple of the given size, INVALID_PAGE_ID if there is none */
+  auto Find(uint32_t tuple_size) const -> page_id_t;
+
+  /** @return the number of pages tracked */
+  auto Size() const -> size_t { return category_.size(); }
+
+ private:
+  std::array<std::set<page_id_t>, FSM_NUM_CATEGORIES> pages_;
+  std::unordered_map<page_id_t, uint32_t> category_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_store.h
+//
+// Identification: src/include/storage/table/overflow_store.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * OverflowStore keeps values that are too large to live in a table page, each in its own chain of overflow pages.
+ * A table heap moves the large VARCHAR values of a tuple here and leaves the first page id of the chain in the tuple.
+ */
+class OverflowStore {
+ public:
+  explicit OverflowStore(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  /**
+   * Store a value.
+   * @return the first page of the chain
+   */
+  auto Write(const char *data, uint32_t len) const -> page_id_t;
+
+  /** Read back a value of len bytes stored at first_page_id. */
+  auto Read(page_id_t first_page_id, uint32_t len) const -> std::vector<char>;
+
+  /** Delete the pages of a value. */
+  void Free(page_id_t first_page_id) const;
+
+ private:
+  BufferPoolManager *bpm_;
+};
+
+}  // namespace bustub
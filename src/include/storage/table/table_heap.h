@@ -12,9 +12,12 @@
 
 #pragma once
 
+#include <array>
 #include <mutex>  // NOLINT
 #include <optional>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
@@ -22,17 +25,58 @@
 #include "concurrency/transaction.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
+#include "storage/table/column_iterator.h"
+#include "storage/table/free_space_map.h"
+#include "storage/table/overflow_store.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
+class TablePage;
+
+/** Number of insert targets of a table heap, inserting threads are spread over them by thread id. */
+static constexpr size_t TABLE_HEAP_INSERT_SLOTS = 16;
+
+/** How the pages of a table heap store tuples. */
+enum class TableFormat {
+  /** slotted TablePages, one tuple after another */
+  Row,
+  /** PaxPages, one minipage per column, for schemas of fixed-length columns */
+  Pax,
+};
+
+/** Tuples larger than this have their largest VARCHAR values moved to overflow pages. */
+static constexpr uint32_t TABLE_HEAP_OVERFLOW_THRESHOLD = BUSTUB_PAGE_SIZE / 4;
+
 /**
  * TableHeap represents a physical table on disk.
- * This is just a doubly-linked list of pages.
+ * This is just a doubly-linked list of pages. A free space map sends inserts to the first page with enough room,
+ * the heap only grows when no page has any.
+ *
+ * Each insert slot reserves its own target page, so threads mapped to different slots fill different pages
+ * concurrently. The table latch is only taken when a slot's page is full, to pick the next page from the free space
+ * map or to link a new page at the end of the chain.
+ *
+ * A tuple keeps its RID for its whole life. UpdateTuple rewrites a tuple of any size in its own page when it fits;
+ * otherwise the new tuple is stored elsewhere as a moved tuple and the original slot forwards to it. Reads follow the
+ * forward, scans skip moved tuples, and the tuple meta always lives in the original slot.
+ *
+ * When the heap knows the schema of its tuples, tuples over TABLE_HEAP_OVERFLOW_THRESHOLD bytes keep their largest
+ * VARCHAR values in overflow pages, so a value is not limited by the page size. A tuple read from the heap only
+ * loads such a value when that column is read.
+ *
+ * A PAX table heap stores its rows in PaxPages instead. Rows are appended to the last page and keep their RIDs, the
+ * row API works as for a row table, and MakeColumnIterator reads only the minipages of the requested columns.
+ * Vacuum does not reclaim space in PAX tables.
+ *
+ * A heap that knows its schema keeps a ZoneMap of its pages, which TableIterator::SetZoneRanges uses to skip pages.
+ * The zones of a tuple's original page cover its values even after UpdateTuple moved it to another page.
  */
 class TableHeap {
   friend class TableIterator;
+  friend class ColumnIterator;
 
  public:
   ~TableHeap() = default;
@@ -40,9 +84,10 @@ class TableHeap {
   /**
    * Create a table heap without a transaction. (open table)
    * @param buffer_pool_manager the buffer pool manager
-   * @param first_page_id the id of the first page
+   * @param schema the schema of the tuples, large values are only moved out of line when it is given
+   * @param format the page format, TableFormat::Pax needs a schema that PaxPage supports
    */
-  explicit TableHeap(BufferPoolManager *bpm);
+  explicit TableHeap(BufferPoolManager *bpm, const Schema *schema = nullptr, TableFormat format = TableFormat::Row);
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return std::nullopt.
@@ -75,12 +120,40 @@ class TableHeap {
    */
   auto GetTupleMeta(RID rid) -> TupleMeta;
 
+  /**
+   * Replace a tuple with one of any size. The RID of the tuple does not change, so indexes only need to be touched
+   * when the key changes.
+   * @param meta new tuple meta
+   * @param tuple new tuple
+   * @param rid the rid of the tuple to be updated
+   */
+  void UpdateTuple(const TupleMeta &meta, const Tuple &tuple, RID rid);
+
+  /**
+   * Reclaim the space of deleted tuples in every page, so that later inserts can reuse it. RIDs of live tuples do
+   * not change. Must only be called when no running transaction has deleted tuples from this table.
+   * @return the number of tuple slots freed
+   */
+  auto Vacuum() -> uint32_t;
+
   /** @return the iterator of this table, use this for project 3 */
   auto MakeIterator() -> TableIterator;
 
   /** @return the iterator of this table, use this for project 4 except updates */
   auto MakeEagerIterator() -> TableIterator;
 
+  /**
+   * @param column_ids the columns to read, in the order of ColumnBatch::columns_
+   * @return an iterator over the pages of a PAX table
+   */
+  auto MakeColumnIterator(std::vector<uint32_t> column_ids) -> ColumnIterator;
+
+  /** @return the page format of this table */
+  inline auto GetFormat() const -> TableFormat { return format_; }
+
+  /** @return the zone map of this table, nullptr if the heap does not know its schema */
+  inline auto GetZoneMap() const -> const ZoneMap * { return zone_map_.has_value() ? &*zone_map_ : nullptr; }
+
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
@@ -96,8 +169,39 @@ class TableHeap {
   BufferPoolManager *bpm_;
   page_id_t first_page_id_{INVALID_PAGE_ID};
 
+  struct InsertSlot {
+    std::mutex latch_;
+    page_id_t page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+  };
+
+  /** Add the overflow pages of the deleted tuples in a page that Vacuum is about to free. */
+  void CollectOverflowPages(const TablePage *page, page_id_t page_id, std::vector<page_id_t> *pages);
+
+  /** @return the tuple to store in a page, with large values moved to the overflow store */
+  auto PrepareTuple(const Tuple &tuple) -> Tuple;
+
+  /** Append a tuple to the last page of a PAX table. */
+  auto InsertIntoPaxPage(const TupleMeta &meta, const Tuple &tuple) -> RID;
+
+  /** Store a tuple in the page of the calling thread's insert slot, returns its RID. */
+  auto InsertIntoSlot(const TupleMeta &meta, const Tuple &tuple, bool is_moved) -> RID;
+
+  /**
+   * Reserve a page with room for a tuple of the given size, taking it out of the free space map or appending a new
+   * page to the chain. latch_ must be held.
+   */
+  auto ReservePage(uint32_t tuple_size) -> page_id_t;
+
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+  FreeSpaceMap fsm_;                        /* protected by latch_, pages reserved by a slot are not in it */
+  std::unordered_set<page_id_t> reserved_;  /* protected by latch_ */
+  std::array<InsertSlot, TABLE_HEAP_INSERT_SLOTS> insert_slots_;
+  std::optional<Schema> schema_;
+  std::optional<ZoneMap> zone_map_;
+  TableFormat format_;
+  OverflowStore overflow_;
+  std::vector<page_id_t> dead_overflow_; /* protected by latch_, values replaced by updates, freed by Vacuum */
 };
 
 }  // namespace bustub
@@ -15,16 +15,50 @@
 #include <cassert>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "common/macros.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
+#include "storage/page/page_guard.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
+class LockManager;
 class TableHeap;
 
+/**
+ * The tuples of one table page, filled by TableIterator::NextBatch. The batch keeps the page pinned and read-latched
+ * and its tuples are viewed in place, so reading a batch does not copy or allocate per tuple. The views are only valid
+ * until the batch is released. Release the batch before anything writes to the table, e.g. before handing rows to an
+ * update or delete executor, or the writer waits for the latch forever.
+ */
+class TupleBatch {
+  friend class TableIterator;
+
+ public:
+  TupleBatch() = default;
+
+  inline auto Size() const -> size_t { return tuples_.size(); }
+
+  inline auto GetMeta(size_t idx) const -> const TupleMeta & { return metas_[idx]; }
+
+  inline auto GetTuple(size_t idx) const -> const TupleView & { return tuples_[idx]; }
+
+  /** Unlatch and unpin the pages and forget the tuples, the buffers are kept for the next batch. */
+  void Release();
+
+ private:
+  /** The page of the batch, followed by the pages that forwarded tuples of the batch moved to */
+  std::vector<ReadPageGuard> pages_;
+  std::vector<TupleMeta> metas_;
+  std::vector<TupleView> tuples_;
+  /** The rows of a PAX page, whose columns are not contiguous and have to be copied into a tuple */
+  std::vector<Tuple> copies_;
+};
+
 /**
  * TableIterator enables the sequential scan of a TableHeap.
  */
@@ -47,7 +81,35 @@ class TableIterator {
 
   auto operator++() -> TableIterator &;
 
+  /**
+   * Read the tuples from the cursor to the end of its page into batch, and move the cursor to the next page. The
+   * batch may be empty even if the iterator is not at the end yet.
+   * @param txn if not nullptr, every tuple of the batch is share-locked for txn before the page is latched, so that
+   * waiting for a row lock never holds a page latch
+   * @return false if the iterator was already at the end
+   */
+  auto NextBatch(TupleBatch *batch, Transaction *txn = nullptr, LockManager *lock_mgr = nullptr,
+                 table_oid_t oid = 0) -> bool;
+
+  /**
+   * Let NextBatch skip the pages whose zones show that no row is inside all the ranges, without reading them. The
+   * rows of the other pages are returned unfiltered.
+   */
+  void SetZoneRanges(std::vector<ZoneRange> ranges) { zone_ranges_ = std::move(ranges); }
+
+  /** @return the number of pages NextBatch skipped because of the zone ranges */
+  auto GetPagesSkipped() const -> size_t { return pages_skipped_; }
+
  private:
+  /** Move to the next slot, which may hold a moved tuple. */
+  void Step();
+
+  /** @return whether the cursor is at a moved tuple, which is returned through its original slot instead */
+  auto AtMovedTuple() -> bool;
+
+  /** @return whether the slot of the latched page holds a moved tuple */
+  auto AtMovedTuple(ReadPageGuard &page_guard, uint32_t slot) -> bool;
+
   TableHeap *table_heap_;
   RID rid_;
 
@@ -55,6 +117,9 @@ class TableIterator {
   // Otherwise we will have dead loops when updating while scanning. (In project 4, update should be implemented as
   // deletion + insertion.)
   RID stop_at_rid_;
+
+  std::vector<ZoneRange> zone_ranges_;
+  size_t pages_skipped_{0};
 };
 
 }  // namespace bustub
@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -42,14 +45,147 @@ struct TupleMeta {
 
 static_assert(sizeof(TupleMeta) == TUPLE_META_SIZE);
 
+/** Set in the length of a VARCHAR value stored in an OverflowStore, its first page id follows the length. */
+static constexpr uint32_t VARCHAR_OVERFLOW_FLAG = 0x80000000;
+
+class OverflowStore;
+
+/**
+ * A read-only view of tuple bytes owned by someone else, usually a pinned table page. Reading values through a view
+ * does not copy the tuple, but the view is only valid as long as the bytes are, e.g. until the TupleBatch it came from
+ * is refilled.
+ */
+class TupleView {
+  friend class Tuple;
+
+ public:
+  TupleView() = default;
+
+  TupleView(const char *data, uint32_t size, RID rid, const OverflowStore *overflow = nullptr)
+      : data_(data), size_(size), rid_(rid), overflow_(overflow) {}
+
+  inline auto GetRid() const -> RID { return rid_; }
+
+  inline auto GetData() const -> const char * { return data_; }
+
+  inline auto GetLength() const -> uint32_t { return size_; }
+
+  // Get the value of a specified column, same as Tuple::GetValue
+  auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
+
+  // Like GetValue, but a VARCHAR value points to the bytes of the view instead of copying them
+  auto GetValueRef(const Schema *schema, uint32_t column_idx) const -> Value;
+
+ private:
+  const char *data_{nullptr};
+  uint32_t size_{0};
+  RID rid_{};
+  const OverflowStore *overflow_{nullptr};
+};
+
+/**
+ * The bytes of a Tuple. Rows of at most INLINE_SIZE bytes live inside the object, so the short intermediate tuples
+ * built by joins, projections and aggregations do not allocate; longer rows go to the heap as with a vector.
+ */
+class TupleData {
+ public:
+  static constexpr uint32_t INLINE_SIZE = 48;
+
+  TupleData() = default;
+
+  TupleData(const TupleData &other) { Assign(other.Data(), other.Data() + other.size_); }
+
+  TupleData(TupleData &&other) noexcept { MoveFrom(&other); }
+
+  auto operator=(const TupleData &other) -> TupleData & {
+    if (this != &other) {
+      Assign(other.Data(), other.Data() + other.size_);
+    }
+    return *this;
+  }
+
+  auto operator=(TupleData &&other) noexcept -> TupleData & {
+    if (this != &other) {
+      delete[] heap_;
+      MoveFrom(&other);
+    }
+    return *this;
+  }
+
+  ~TupleData() { delete[] heap_; }
+
+  inline auto Data() -> char * { return heap_ == nullptr ? inline_ : heap_; }
+
+  inline auto Data() const -> const char * { return heap_ == nullptr ? inline_ : heap_; }
+
+  inline auto Size() const -> uint32_t { return size_; }
+
+  /** Resize to size bytes, keeping the old bytes and zeroing the new ones */
+  void Resize(uint32_t size) {
+    Reserve(size);
+    if (size > size_) {
+      memset(Data() + size_, 0, size - size_);
+    }
+    size_ = size;
+  }
+
+  void Reserve(uint32_t capacity) {
+    if (capacity <= capacity_) {
+      return;
+    }
+    capacity = std::max(capacity, capacity_ * 2);
+    auto *heap = new char[capacity];
+    memcpy(heap, Data(), size_);
+    delete[] heap_;
+    heap_ = heap;
+    capacity_ = capacity;
+  }
+
+  void Assign(const char *begin, const char *end) {
+    size_ = 0;
+    Append(begin, end);
+  }
+
+  void Append(const char *begin, const char *end) {
+    auto len = static_cast<uint32_t>(end - begin);
+    Reserve(size_ + len);
+    memcpy(Data() + size_, begin, len);
+    size_ += len;
+  }
+
+ private:
+  void MoveFrom(TupleData *other) {
+    size_ = other->size_;
+    capacity_ = other->capacity_;
+    heap_ = other->heap_;
+    if (heap_ == nullptr) {
+      memcpy(inline_, other->inline_, size_);
+    }
+    other->heap_ = nullptr;
+    other->size_ = 0;
+    other->capacity_ = INLINE_SIZE;
+  }
+
+  uint32_t size_{0};
+  uint32_t capacity_{INLINE_SIZE};
+  char *heap_{nullptr};
+  char inline_[INLINE_SIZE];
+};
+
 /**
  * Tuple format:
  * ---------------------------------------------------------------------
  * | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD |
  * ---------------------------------------------------------------------
+ *
+ * A VARCHAR payload is its length followed by the bytes. A value moved out of line by the table heap has
+ * VARCHAR_OVERFLOW_FLAG in its length and the first page id of its overflow chain instead of the bytes, it is only
+ * read from the overflow pages when GetValue asks for that column. A dictionary encoded VARCHAR column stores the
+ * 4-byte code of its value in the fixed-size part, GetValue decodes it without copying the string.
  */
 class Tuple {
   friend class TablePage;
+  friend class PaxPage;
   friend class TableHeap;
   friend class TableIterator;
 
@@ -83,16 +219,25 @@ class Tuple {
   // return RID of current tuple
   inline auto GetRid() const -> RID { return rid_; }
 
+  // set RID of current tuple
+  inline void SetRid(RID rid) { rid_ = rid; }
+
   // Get the address of this tuple in the table's backing store
-  inline auto GetData() const -> const char * { return data_.data(); }
+  inline auto GetData() const -> const char * { return data_.Data(); }
 
   // Get length of the tuple, including varchar legth
-  inline auto GetLength() const -> uint32_t { return data_.size(); }
+  inline auto GetLength() const -> uint32_t { return data_.Size(); }
 
   // Get the value of a specified column (const)
   // checks the schema to see how to return the Value.
   auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
 
+  // A view of this tuple, valid until the tuple is changed or destroyed
+  inline auto AsView() const -> TupleView { return {data_.Data(), GetLength(), rid_, overflow_}; }
+
+  // Copy the tuple a view points to into this tuple, reusing its buffer
+  void CopyFrom(const TupleView &view);
+
   // Generates a key tuple given schemas and attributes
   auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) -> Tuple;
 
@@ -104,12 +249,25 @@ class Tuple {
 
   auto ToString(const Schema *schema) const -> std::string;
 
+  // Move the largest VARCHAR values to the overflow store until the tuple is at most target bytes. Values of this
+  // tuple that are already out of line are read back and stored again, so the result never shares pages with another
+  // tuple. Returns std::nullopt if nothing had to change.
+  auto MoveToOverflow(const Schema *schema, const OverflowStore *store, uint32_t target) const
+      -> std::optional<Tuple>;
+
+  // The first pages of the values of this tuple that are stored out of line
+  auto GetOverflowPages(const Schema *schema) const -> std::vector<page_id_t>;
+
  private:
   // Get the starting storage address of specific column
   auto GetDataPtr(const Schema *schema, uint32_t column_idx) const -> const char *;
 
+  // Read the bytes of a VARCHAR value stored out of line, whose payload starts at data_ptr
+  auto ReadOverflow(const char *data_ptr) const -> std::vector<char>;
+
   RID rid_{};  // if pointing to the table heap, the rid is valid
-  std::vector<char> data_;
+  TupleData data_;
+  const OverflowStore *overflow_{nullptr};  // set by the table heap, to read values stored out of line
 };
 
 }  // namespace bustub
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vector_batch.h
+//
+// Identification: src/include/storage/table/vector_batch.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ColumnVector holds the values of one column of a VectorBatch. Fixed-length values are stored back to back in the
+ * same format as in a tuple, so they can be read as a plain array. VARCHAR values are kept as Values that own their
+ * bytes, or point into a dictionary. NULLs are also flagged in one byte per row.
+ */
+class ColumnVector {
+ public:
+  explicit ColumnVector(TypeId type);
+
+  inline auto GetType() const -> TypeId { return type_; }
+
+  inline auto Size() const -> size_t { return nulls_.size(); }
+
+  inline auto IsNull(size_t idx) const -> bool { return nulls_[idx] != 0; }
+
+  /** @return one byte per row, nonzero for NULL */
+  inline auto GetNulls() const -> const uint8_t * { return nulls_.data(); }
+
+  /** @return the values of a fixed-length column as an array, T must have the size of the column type */
+  template <class T>
+  inline auto GetData() const -> const T * {
+    return reinterpret_cast<const T *>(data_.data());
+  }
+
+  auto GetValue(size_t idx) const -> Value;
+
+  /** Append a value, which is cast to the type of the column if needed */
+  void Append(const Value &value);
+
+  /** Append the idx-th value of a column of the same type */
+  void AppendFrom(const ColumnVector &other, size_t idx);
+
+  /** Keep only the first size values */
+  void Truncate(size_t size);
+
+  /** Forget the values, the buffers are kept */
+  void Clear();
+
+ private:
+  TypeId type_;
+  /** The size of a fixed-length value, 0 for VARCHAR */
+  uint32_t width_;
+  std::vector<char> data_;
+  std::vector<uint8_t> nulls_;
+  std::vector<Value> varlens_;
+};
+
+/**
+ * VectorBatch is a batch of rows passed between executors by AbstractExecutor::NextBatch, stored column by column so
+ * that an executor can work on a whole column in one loop instead of one virtual call per tuple. Unlike a TupleBatch,
+ * the batch owns its values and stays valid after the pages it was read from are released.
+ */
+class VectorBatch {
+ public:
+  /** The number of rows an executor aims to put into one batch. A scan may go over it to finish a page. */
+  static constexpr size_t CAPACITY = 1024;
+
+  VectorBatch() = default;
+
+  /** Forget the rows and set up one column for each column of the schema, the buffers are kept if the types match */
+  void Reset(const Schema &schema);
+
+  inline auto Size() const -> size_t { return rids_.size(); }
+
+  inline auto IsFull() const -> bool { return rids_.size() >= CAPACITY; }
+
+  inline auto GetColumnCount() const -> uint32_t { return static_cast<uint32_t>(columns_.size()); }
+
+  inline auto GetColumn(uint32_t column_idx) const -> const ColumnVector & { return columns_[column_idx]; }
+
+  /** The columns can be filled one at a time, each must get a value for every row appended with AppendRid */
+  inline auto GetColumn(uint32_t column_idx) -> ColumnVector & { return columns_[column_idx]; }
+
+  inline auto GetValue(uint32_t column_idx, size_t row) const -> Value { return columns_[column_idx].GetValue(row); }
+
+  inline auto GetRid(size_t row) const -> RID { return rids_[row]; }
+
+  /** @return the row as a tuple of the schema the batch was reset with */
+  auto GetTuple(size_t row, const Schema &schema) const -> Tuple;
+
+  void AppendTuple(const Tuple &tuple, const Schema &schema);
+
+  /** Append a tuple viewed in place, its VARCHAR values are copied */
+  void AppendView(const TupleView &tuple, const Schema &schema);
+
+  void AppendRow(const std::vector<Value> &values, RID rid);
+
+  /** Append a row of a batch with the same column types */
+  void AppendRowFrom(const VectorBatch &other, size_t row);
+
+  inline void AppendRid(RID rid) { rids_.push_back(rid); }
+
+  /** Keep only the first size rows */
+  void Truncate(size_t size);
+
+ private:
+  std::vector<ColumnVector> columns_;
+  std::vector<RID> rids_;
+};
+
+}  // namespace bustub
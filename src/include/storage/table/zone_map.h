@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** The values of one column a scan is looking for. A bound that is not set is unbounded. */
+struct ZoneRange {
+  uint32_t column_idx_;
+  std::optional<Value> lower_;
+  bool lower_inclusive_{true};
+  std::optional<Value> upper_;
+  bool upper_inclusive_{true};
+};
+
+/**
+ * ZoneMap keeps the minimum and maximum value of each numeric column in every page of a table heap, so that a scan
+ * can skip the pages that cannot hold a row it is looking for. A zone only grows: inserts and updates widen it, deletes
+ * leave it as is. It also remembers the page chain, so a skipped page is not read at all. Like the free space map, it
+ * only lives in memory. Thread-safe.
+ */
+class ZoneMap {
+ public:
+  explicit ZoneMap(const Schema &schema);
+
+  /** Start tracking a page linked after prev_page_id, INVALID_PAGE_ID for the first page of the heap. */
+  void AddPage(page_id_t page_id, page_id_t prev_page_id);
+
+  /** Widen the zones of the page to include the values of the tuple. */
+  void Update(page_id_t page_id, const Tuple &tuple);
+
+  /** @return whether the column has zones, i.e. ZoneRanges on it can prune pages */
+  auto IsTracked(uint32_t column_idx) const -> bool { return tracked_[column_idx]; }
+
+  /**
+   * @param[out] next_page_id the page after page_id in the heap
+   * @return false if no row of the page can be inside all the ranges, true if it may or the page is not tracked
+   */
+  auto MayMatch(page_id_t page_id, const std::vector<ZoneRange> &ranges, page_id_t *next_page_id) const -> bool;
+
+ private:
+  struct Zone {
+    Value min_;
+    Value max_;
+    bool has_value_{false};
+  };
+
+  struct PageZones {
+    page_id_t next_page_id_{INVALID_PAGE_ID};
+    std::vector<Zone> zones_;
+  };
+
+  Schema schema_;
+  std::vector<bool> tracked_;
+  mutable std::mutex latch_;
+  std::unordered_map<page_id_t, PageZones> pages_; /* protected by latch_ */
+};
+
+}  // namespace bustub
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// dictionary.h
+//
+// Identification: src/include/type/dictionary.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rwlatch.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Dictionary maps the distinct strings of a low-cardinality VARCHAR column to small integer codes, so that tuples store
+ * a 4-byte code instead of the string. Codes are handed out in insertion order and never reused, so the dictionary only
+ * grows. A decoded value points into the dictionary and carries its code: two values of the same dictionary are equal
+ * iff their codes are, and their hash is computed once when the string is added. Thread-safe, Decode is lock-free.
+ */
+class Dictionary {
+ public:
+  /** The code stored for a NULL value */
+  static constexpr uint32_t NULL_CODE = std::numeric_limits<uint32_t>::max();
+  /** Codes are stored in chunks of this many entries, so decoding never races with a growing array */
+  static constexpr uint32_t CHUNK_SIZE = 4096;
+  static constexpr uint32_t MAX_CHUNKS = 4096;
+
+  Dictionary();
+  ~Dictionary();
+
+  DISALLOW_COPY_AND_MOVE(Dictionary);
+
+  /** @return the code of a VARCHAR value, adding it to the dictionary if it is not there yet */
+  auto Encode(const Value &value) -> uint32_t;
+
+  /** @return the code of a VARCHAR value, std::nullopt if it is not in the dictionary */
+  auto Lookup(const Value &value) const -> std::optional<uint32_t>;
+
+  /** @return the value of a code. It points into the dictionary and stays valid as long as the dictionary does */
+  auto Decode(uint32_t code) const -> Value;
+
+  /** @return the hash of a value decoded from any dictionary, the same as HashUtil::HashValue of its string */
+  static auto CachedHash(const Value &value) -> std::size_t;
+
+  /** @return the number of distinct strings */
+  auto Size() const -> size_t { return size_.load(); }
+
+  auto GetId() const -> uint32_t { return id_; }
+
+ private:
+  struct Entry {
+    const char *data_;
+    uint32_t len_;
+  };
+
+  /** Unique among all dictionaries, 0 means a value does not come from a dictionary */
+  const uint32_t id_;
+  std::atomic<size_t> size_{0};
+  /** Each string is stored after its hash, so a decoded value can find the hash from its data pointer */
+  std::vector<std::unique_ptr<char[]>> strings_;
+  std::unordered_map<std::string_view, uint32_t> codes_;
+  std::unique_ptr<std::atomic<Entry *>[]> chunks_;
+  mutable ReaderWriterLatch latch_;
+};
+
+}  // namespace bustub
@@ -42,6 +42,7 @@ class Value {
   friend class TimestampType;
   friend class BooleanType;
   friend class VarlenType;
+  friend class Dictionary;
 
  public:
   explicit Value(const TypeId type) : manage_data_(false), type_id_(type) { size_.len_ = BUSTUB_VALUE_NULL; }
@@ -58,7 +59,8 @@ class Value {
   Value(TypeId type, int64_t i);
   // TIMESTAMP
   Value(TypeId type, uint64_t i);
-  // VARCHAR
+  // VARCHAR. An owned value of at most INLINE_VARLEN_SIZE bytes is kept inside the Value without a heap allocation,
+  // a value that does not manage its data only points to it and must not outlive the bytes.
   Value(TypeId type, const char *data, uint32_t len, bool manage_data);
   Value(TypeId type, const std::string &data);
 
@@ -127,6 +129,15 @@ class Value {
   inline auto IsZero() const -> bool { return Type::GetInstance(type_id_)->IsZero(*this); }
   inline auto IsNull() const -> bool { return size_.len_ == BUSTUB_VALUE_NULL; }
 
+  /** @return the id of the dictionary this VARCHAR value was decoded from, 0 if it was not */
+  inline auto GetDictionaryId() const -> uint32_t {
+    return type_id_ == TypeId::VARCHAR && !manage_data_ && size_.len_ != BUSTUB_VALUE_NULL
+               ? value_.coded_varlen_.dictionary_id_
+               : 0;
+  }
+  /** @return the code of this value in its dictionary, only meaningful if GetDictionaryId() is not 0 */
+  inline auto GetDictionaryCode() const -> uint32_t { return value_.coded_varlen_.code_; }
+
   // Serialize this value into the given storage space. The inlined parameter
   // indicates whether we are allowed to inline this value into the storage
   // space, or whether we must store only a reference to this value. If inlined
@@ -145,6 +156,14 @@ class Value {
   inline auto Copy() const -> Value { return Type::GetInstance(type_id_)->Copy(*this); }
 
  protected:
+  /** Owned VARCHAR values up to this many bytes (including the trailing '\0') are stored inline */
+  static constexpr uint32_t INLINE_VARLEN_SIZE = 16;
+
+  // The bytes of a VARCHAR value, wherever they are stored
+  inline auto VarlenData() const -> const char * {
+    return manage_data_ && size_.len_ <= INLINE_VARLEN_SIZE ? value_.inline_varlen_ : value_.const_varlen_;
+  }
+
   // The actual value item
   union Val {
     int8_t boolean_;
@@ -156,6 +175,13 @@ class Value {
     uint64_t timestamp_;
     char *varlen_;
     const char *const_varlen_;
+    // 从字典解码出来的值，借用字典里的字符串，并带着它的编码
+    struct {
+      const char *data_;
+      uint32_t code_;
+      uint32_t dictionary_id_;
+    } coded_varlen_;
+    char inline_varlen_[INLINE_VARLEN_SIZE];
   } value_;
 
   union {
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+void CollectColumns(const AbstractExpressionRef &expr, std::vector<uint32_t> *columns) {
+  if (expr == nullptr) {
+    return;
+  }
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr.get()); column_expr != nullptr) {
+    columns->push_back(column_expr->GetColIdx());
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizePruneScanColumns(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizePruneScanColumns(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::Aggregation) {
+    return optimized_plan;
+  }
+  const auto &agg_plan = dynamic_cast<const AggregationPlanNode &>(*optimized_plan);
+  std::vector<uint32_t> columns;
+  for (const auto &expr : agg_plan.GetGroupBys()) {
+    CollectColumns(expr, &columns);
+  }
+  for (const auto &expr : agg_plan.GetAggregates()) {
+    CollectColumns(expr, &columns);
+  }
+
+  // 聚合下面可能还有一层filter，它的谓词读的也是扫描输出的列
+  auto child = agg_plan.GetChildPlan();
+  const FilterPlanNode *filter_plan = nullptr;
+  if (child->GetType() == PlanType::Filter) {
+    filter_plan = dynamic_cast<const FilterPlanNode *>(child.get());
+    CollectColumns(filter_plan->GetPredicate(), &columns);
+    child = filter_plan->GetChildPlan();
+  }
+  if (child->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child);
+  const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
+  if (table_info == Catalog::NULL_TABLE_INFO || table_info->table_ == nullptr ||
+      table_info->table_->GetFormat() != TableFormat::Pax || seq_scan.columns_.has_value()) {
+    return optimized_plan;
+  }
+  CollectColumns(seq_scan.filter_predicate_, &columns);
+  std::sort(columns.begin(), columns.end());
+  columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+  auto pruned_scan = std::make_shared<SeqScanPlanNode>(seq_scan);
+  pruned_scan->columns_ = std::move(columns);
+  AbstractPlanNodeRef new_child = pruned_scan;
+  if (filter_plan != nullptr) {
+    new_child = filter_plan->CloneWithChildren({new_child});
+  }
+  return optimized_plan->CloneWithChildren({new_child});
+}
+
+}  // namespace bustub
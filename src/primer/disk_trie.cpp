@@ -0,0 +1,386 @@
+#include "primer/disk_trie.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+namespace {
+
+auto ByteLess(const std::pair<char, page_id_t> &entry, char c) -> bool {
+  return static_cast<unsigned char>(entry.first) < static_cast<unsigned char>(c);
+}
+
+}  // namespace
+
+DiskTrieSnapshot::DiskTrieSnapshot(DiskTrieSnapshot &&that) noexcept
+    : trie_(that.trie_), root_page_id_(that.root_page_id_), version_(that.version_) {
+  that.trie_ = nullptr;
+}
+
+DiskTrieSnapshot::~DiskTrieSnapshot() {
+  if (trie_ != nullptr) {
+    trie_->ReleaseSnapshot(version_);
+  }
+}
+
+auto DiskTrieSnapshot::Get(std::string_view key) const -> std::optional<std::string> {
+  return trie_->Lookup(root_page_id_, key);
+}
+
+auto DiskTrieSnapshot::ScanPrefix(std::string_view prefix, size_t limit) const
+    -> std::vector<std::pair<std::string, std::string>> {
+  return trie_->Scan(root_page_id_, prefix, limit);
+}
+
+void DiskTrieWriteBatch::Put(std::string_view key, std::string_view value) {
+  if (key.size() > DISK_TRIE_MAX_KEY_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "DiskTrie key too long");
+  }
+  if (value.size() > DISK_TRIE_MAX_VALUE_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "DiskTrie value too long");
+  }
+  writes_.emplace_back(std::string(key), std::string(value));
+}
+
+void DiskTrieWriteBatch::Remove(std::string_view key) { writes_.emplace_back(std::string(key), std::nullopt); }
+
+auto DiskTrie::Node::Find(char c) const -> page_id_t {
+  auto it = std::lower_bound(children_.begin(), children_.end(), c, ByteLess);
+  if (it == children_.end() || it->first != c) {
+    return INVALID_PAGE_ID;
+  }
+  return it->second;
+}
+
+void DiskTrie::Node::Set(char c, page_id_t child) {
+  auto it = std::lower_bound(children_.begin(), children_.end(), c, ByteLess);
+  if (it != children_.end() && it->first == c) {
+    it->second = child;
+  } else {
+    children_.emplace(it, c, child);
+  }
+}
+
+void DiskTrie::Node::Erase(char c) {
+  auto it = std::lower_bound(children_.begin(), children_.end(), c, ByteLess);
+  if (it != children_.end() && it->first == c) {
+    children_.erase(it);
+  }
+}
+
+DiskTrie::DiskTrie(BufferPoolManager *bpm, page_id_t header_page_id) : bpm_(bpm), header_page_id_(header_page_id) {
+  WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
+  auto *header = guard.AsMut<DiskTrieHeaderPage>();
+  if (header->magic_ != DISK_TRIE_MAGIC) {
+    header->magic_ = DISK_TRIE_MAGIC;
+    header->root_page_id_ = INVALID_PAGE_ID;
+  }
+  // 恢复只需要读出最后一次提交的根
+  root_page_id_ = header->root_page_id_;
+}
+
+auto DiskTrie::GetSnapshot() -> DiskTrieSnapshot {
+  std::scoped_lock lock(latch_);
+  snapshots_[version_]++;
+  return {this, root_page_id_, version_};
+}
+
+auto DiskTrie::Get(std::string_view key) -> std::optional<std::string> { return GetSnapshot().Get(key); }
+
+auto DiskTrie::ScanPrefix(std::string_view prefix, size_t limit) -> std::vector<std::pair<std::string, std::string>> {
+  return GetSnapshot().ScanPrefix(prefix, limit);
+}
+
+void DiskTrie::Put(std::string_view key, std::string_view value) {
+  DiskTrieWriteBatch batch;
+  batch.Put(key, value);
+  Commit(batch);
+}
+
+void DiskTrie::Remove(std::string_view key) {
+  DiskTrieWriteBatch batch;
+  batch.Remove(key);
+  Commit(batch);
+}
+
+auto DiskTrie::GetRootPageId() -> page_id_t {
+  std::scoped_lock lock(latch_);
+  return root_page_id_;
+}
+
+void DiskTrie::Commit(const DiskTrieWriteBatch &batch) {
+  std::scoped_lock write_lock(write_latch_);
+  page_id_t root = root_page_id_;
+  CommitContext ctx;
+  for (const auto &[key, value] : batch.writes_) {
+    if (value.has_value()) {
+      if (root == INVALID_PAGE_ID) {
+        root = WriteNode(Node(), &ctx);
+      }
+      root = PutAt(root, key, *value, &ctx);
+    } else if (root != INVALID_PAGE_ID) {
+      root = RemoveAt(root, key, true, &ctx);
+    }
+  }
+  if (ctx.fresh_.empty() && ctx.retired_.empty()) {
+    return;
+  }
+
+  // 新页面先落盘，再写header发布新的根，崩溃时header要么指向旧根要么指向完整的新根
+  for (auto page_id : ctx.fresh_) {
+    bpm_->FlushPage(page_id);
+  }
+  {
+    WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
+    guard.AsMut<DiskTrieHeaderPage>()->root_page_id_ = root;
+  }
+  bpm_->FlushPage(header_page_id_);
+
+  std::scoped_lock lock(latch_);
+  retired_.emplace_back(version_, std::move(ctx.retired_));
+  root_page_id_ = root;
+  version_++;
+  ReclaimPages();
+}
+
+auto DiskTrie::ReadNode(page_id_t page_id) -> Node {
+  ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+  const auto *page = guard.As<TrieNodePage>();
+  Node node;
+  node.prefix_ = page->GetPrefix();
+  if (page->HasValue()) {
+    node.value_ = std::string(page->GetValue());
+  }
+  node.children_.reserve(page->GetNumChildren());
+  for (uint32_t i = 0; i < page->GetNumChildren(); i++) {
+    node.children_.emplace_back(page->KeyAt(i), page->ChildAt(i));
+  }
+  return node;
+}
+
+auto DiskTrie::WriteNode(const Node &node, CommitContext *ctx) -> page_id_t {
+  page_id_t page_id;
+  Page *new_page = bpm_->NewPage(&page_id);
+  if (new_page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "DiskTrie cannot allocate a page");
+  }
+  BasicPageGuard guard(bpm_, new_page);
+  std::optional<std::string_view> value;
+  if (node.value_.has_value()) {
+    value = *node.value_;
+  }
+  guard.AsMut<TrieNodePage>()->Init(node.prefix_, value.has_value() ? &*value : nullptr, node.children_);
+  ctx->fresh_.insert(page_id);
+  return page_id;
+}
+
+auto DiskTrie::RewriteNode(page_id_t page_id, const Node &node, CommitContext *ctx) -> page_id_t {
+  if (ctx->fresh_.count(page_id) == 0) {
+    RetireNode(page_id, ctx);
+    return WriteNode(node, ctx);
+  }
+  std::optional<std::string_view> value;
+  if (node.value_.has_value()) {
+    value = *node.value_;
+  }
+  WritePageGuard guard = bpm_->FetchPageWrite(page_id);
+  guard.AsMut<TrieNodePage>()->Init(node.prefix_, value.has_value() ? &*value : nullptr, node.children_);
+  return page_id;
+}
+
+void DiskTrie::RetireNode(page_id_t page_id, CommitContext *ctx) {
+  if (ctx->fresh_.erase(page_id) == 1) {
+    // 本次提交自己写的页面，别人看不到，直接删
+    bpm_->DeletePage(page_id);
+    return;
+  }
+  ctx->retired_.push_back(page_id);
+}
+
+auto DiskTrie::PutAt(page_id_t page_id, std::string_view rest, std::string_view value, CommitContext *ctx)
+    -> page_id_t {
+  Node node = ReadNode(page_id);
+  if (rest.empty()) {
+    node.value_ = std::string(value);
+    return RewriteNode(page_id, node, ctx);
+  }
+  page_id_t child = node.Find(rest[0]);
+  auto tail = rest.substr(1);
+  if (child == INVALID_PAGE_ID) {
+    // 没有这个分支，剩下的key整段压缩进一个叶子
+    Node leaf;
+    leaf.prefix_ = tail;
+    leaf.value_ = std::string(value);
+    node.Set(rest[0], WriteNode(leaf, ctx));
+    return RewriteNode(page_id, node, ctx);
+  }
+
+  Node child_node = ReadNode(child);
+  const auto &prefix = child_node.prefix_;
+  size_t common = 0;
+  while (common < prefix.size() && common < tail.size() && prefix[common] == tail[common]) {
+    common++;
+  }
+  page_id_t next = child;
+  if (common < prefix.size()) {
+    // key在压缩路径中间分叉，把路径拆成上下两段
+    Node upper;
+    upper.prefix_ = prefix.substr(0, common);
+    char split = prefix[common];
+    child_node.prefix_ = prefix.substr(common + 1);
+    upper.Set(split, RewriteNode(child, child_node, ctx));
+    next = WriteNode(upper, ctx);
+  }
+  node.Set(rest[0], PutAt(next, tail.substr(common), value, ctx));
+  return RewriteNode(page_id, node, ctx);
+}
+
+auto DiskTrie::RemoveAt(page_id_t page_id, std::string_view rest, bool is_root, CommitContext *ctx) -> page_id_t {
+  Node node = ReadNode(page_id);
+  if (rest.substr(0, node.prefix_.size()) != node.prefix_) {
+    return page_id;
+  }
+  rest = rest.substr(node.prefix_.size());
+  if (rest.empty()) {
+    if (!node.value_.has_value()) {
+      return page_id;
+    }
+    node.value_.reset();
+  } else {
+    page_id_t child = node.Find(rest[0]);
+    if (child == INVALID_PAGE_ID) {
+      return page_id;
+    }
+    // 孩子在本次提交里被原地改写时页号不变，父节点也一定是本次写的，不用再改
+    page_id_t new_child = RemoveAt(child, rest.substr(1), false, ctx);
+    if (new_child == child) {
+      return page_id;
+    }
+    if (new_child != INVALID_PAGE_ID) {
+      node.Set(rest[0], new_child);
+    } else {
+      node.Erase(rest[0]);
+    }
+  }
+
+  if (node.value_.has_value()) {
+    return RewriteNode(page_id, node, ctx);
+  }
+  // 没有值也没有孩子的节点删掉；只剩一个孩子的节点和孩子合并成一段压缩路径，根节点除外
+  if (node.children_.empty()) {
+    RetireNode(page_id, ctx);
+    return INVALID_PAGE_ID;
+  }
+  if (!is_root && node.children_.size() == 1) {
+    auto [c, only_child] = node.children_[0];
+    Node merged = ReadNode(only_child);
+    merged.prefix_ = node.prefix_ + c + merged.prefix_;
+    RetireNode(page_id, ctx);
+    return RewriteNode(only_child, merged, ctx);
+  }
+  return RewriteNode(page_id, node, ctx);
+}
+
+auto DiskTrie::Lookup(page_id_t root_page_id, std::string_view key) -> std::optional<std::string> {
+  page_id_t page_id = root_page_id;
+  size_t i = 0;
+  while (page_id != INVALID_PAGE_ID) {
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    const auto *page = guard.As<TrieNodePage>();
+    auto prefix = page->GetPrefix();
+    if (key.substr(i, prefix.size()) != prefix) {
+      return std::nullopt;
+    }
+    i += prefix.size();
+    if (i == key.size()) {
+      if (!page->HasValue()) {
+        return std::nullopt;
+      }
+      return std::string(page->GetValue());
+    }
+    page_id = page->FindChild(key[i]);
+    i++;
+  }
+  return std::nullopt;
+}
+
+auto DiskTrie::Scan(page_id_t root_page_id, std::string_view prefix, size_t limit)
+    -> std::vector<std::pair<std::string, std::string>> {
+  std::vector<std::pair<std::string, std::string>> result;
+  page_id_t page_id = root_page_id;
+  size_t i = 0;
+  while (page_id != INVALID_PAGE_ID && limit > 0) {
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    const auto *page = guard.As<TrieNodePage>();
+    auto node_prefix = page->GetPrefix();
+    auto rest = prefix.substr(i);
+    size_t n = std::min(rest.size(), node_prefix.size());
+    if (node_prefix.substr(0, n) != rest.substr(0, n)) {
+      break;
+    }
+    if (rest.size() <= node_prefix.size()) {
+      // 前缀在这个节点内结束，整个子树都匹配
+      guard.Drop();
+      std::string key(prefix.substr(0, i));
+      ScanFrom(page_id, &key, limit, &result);
+      break;
+    }
+    i += node_prefix.size();
+    page_id = page->FindChild(prefix[i]);
+    i++;
+  }
+  return result;
+}
+
+void DiskTrie::ScanFrom(page_id_t page_id, std::string *key, size_t limit,
+                        std::vector<std::pair<std::string, std::string>> *result) {
+  size_t key_size = key->size();
+  std::vector<std::pair<char, page_id_t>> children;
+  {
+    // 递归前放掉page，深的路径不会把缓冲池pin满
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    const auto *page = guard.As<TrieNodePage>();
+    key->append(page->GetPrefix());
+    if (page->HasValue()) {
+      result->emplace_back(*key, page->GetValue());
+    }
+    children.reserve(page->GetNumChildren());
+    for (uint32_t i = 0; i < page->GetNumChildren(); i++) {
+      children.emplace_back(page->KeyAt(i), page->ChildAt(i));
+    }
+  }
+  for (const auto &[c, child] : children) {
+    if (result->size() >= limit) {
+      break;
+    }
+    key->push_back(c);
+    ScanFrom(child, key, limit, result);
+    key->pop_back();
+  }
+  key->resize(key_size);
+}
+
+void DiskTrie::ReleaseSnapshot(uint64_t version) {
+  std::scoped_lock lock(latch_);
+  auto it = snapshots_.find(version);
+  if (--it->second == 0) {
+    snapshots_.erase(it);
+  }
+  ReclaimPages();
+}
+
+void DiskTrie::ReclaimPages() {
+  uint64_t oldest = snapshots_.empty() ? UINT64_MAX : snapshots_.begin()->first;
+  // 第v个版本之后被替换的页面，只有版本<=v的快照还能看到
+  while (!retired_.empty() && retired_.front().first < oldest) {
+    for (auto page_id : retired_.front().second) {
+      bpm_->DeletePage(page_id);
+    }
+    retired_.pop_front();
+  }
+}
+
+}  // namespace bustub
@@ -4,32 +4,146 @@
 
 namespace bustub {
 
+namespace {
+
+// 按无符号字节排序，和稠密数组的下标顺序一致
+auto Byte(char c) -> uint8_t { return static_cast<uint8_t>(c); }
+
+}  // namespace
+
+TrieChildren::TrieChildren(const TrieChildren &that)
+    : sparse_(that.sparse_),
+      dense_(that.dense_ != nullptr ? std::make_unique<std::array<std::shared_ptr<const TrieNode>, 256>>(*that.dense_)
+                                    : nullptr),
+      dense_size_(that.dense_size_) {}
+
+auto TrieChildren::operator=(const TrieChildren &that) -> TrieChildren & {
+  if (this != &that) {
+    TrieChildren copy(that);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+auto TrieChildren::Find(char c) const -> const std::shared_ptr<const TrieNode> * {
+  if (dense_ != nullptr) {
+    const auto &slot = (*dense_)[Byte(c)];
+    return slot != nullptr ? &slot : nullptr;
+  }
+  for (const auto &entry : sparse_) {
+    if (entry.first == c) {
+      return &entry.second;
+    }
+  }
+  return nullptr;
+}
+
+auto TrieChildren::LowerBound(size_t from, char *c) const -> const std::shared_ptr<const TrieNode> * {
+  if (dense_ != nullptr) {
+    for (size_t i = from; i < dense_->size(); i++) {
+      if ((*dense_)[i] != nullptr) {
+        *c = static_cast<char>(i);
+        return &(*dense_)[i];
+      }
+    }
+    return nullptr;
+  }
+  for (const auto &entry : sparse_) {
+    if (Byte(entry.first) >= from) {
+      *c = entry.first;
+      return &entry.second;
+    }
+  }
+  return nullptr;
+}
+
+void TrieChildren::Set(char c, std::shared_ptr<const TrieNode> child) {
+  if (dense_ != nullptr) {
+    auto &slot = (*dense_)[Byte(c)];
+    if (slot == nullptr) {
+      dense_size_++;
+    }
+    slot = std::move(child);
+    return;
+  }
+  auto it = std::lower_bound(sparse_.begin(), sparse_.end(), c,
+                             [](const auto &entry, char key) { return Byte(entry.first) < Byte(key); });
+  if (it != sparse_.end() && it->first == c) {
+    it->second = std::move(child);
+    return;
+  }
+  if (sparse_.size() < TRIE_SPARSE_MAX_CHILDREN) {
+    sparse_.emplace(it, c, std::move(child));
+    return;
+  }
+  // 孩子太多，换成按字节下标的稠密数组
+  dense_ = std::make_unique<std::array<std::shared_ptr<const TrieNode>, 256>>();
+  for (auto &entry : sparse_) {
+    (*dense_)[Byte(entry.first)] = std::move(entry.second);
+  }
+  dense_size_ = sparse_.size() + 1;
+  (*dense_)[Byte(c)] = std::move(child);
+  sparse_.clear();
+  sparse_.shrink_to_fit();
+}
+
+void TrieChildren::Erase(char c) {
+  if (dense_ == nullptr) {
+    auto it = std::find_if(sparse_.begin(), sparse_.end(), [c](const auto &entry) { return entry.first == c; });
+    if (it != sparse_.end()) {
+      sparse_.erase(it);
+    }
+    return;
+  }
+  auto &slot = (*dense_)[Byte(c)];
+  if (slot == nullptr) {
+    return;
+  }
+  slot.reset();
+  dense_size_--;
+  if (dense_size_ > TRIE_DENSE_MIN_CHILDREN) {
+    return;
+  }
+  // 孩子少了，换回有序小数组
+  sparse_.reserve(dense_size_);
+  for (size_t i = 0; i < dense_->size(); i++) {
+    if ((*dense_)[i] != nullptr) {
+      sparse_.emplace_back(static_cast<char>(i), std::move((*dense_)[i]));
+    }
+  }
+  dense_.reset();
+  dense_size_ = 0;
+}
+
 template <class T>
 auto Trie::Get(std::string_view key) const -> const T * {
   // You should walk through the trie to find the node corresponding to the key. If the node doesn't exist, return
   // nullptr. After you find the node, you should use `dynamic_cast` to cast it to `const TrieNodeWithValue<T> *`. If
   // dynamic_cast returns `nullptr`, it means the type of the value is mismatched, and you should return nullptr.
   // Otherwise, return the value.
-
-  // throw NotImplementedException("Trie::Get is not implemented.");
-
   if (!root_) {
     return nullptr;
   }
-  // 指针
-  auto ptr = root_;
-  for (const auto c : key) {
-    if (ptr->children_.count(c) == 0) {
+  const TrieNode *node = root_.get();
+  size_t i = 0;
+  while (i < key.size()) {
+    const auto *child = node->children_.Find(key[i]);
+    if (child == nullptr) {
+      return nullptr;
+    }
+    node = child->get();
+    i++;
+    // 压缩的路径必须整段匹配
+    if (key.substr(i, node->prefix_.size()) != node->prefix_) {
       return nullptr;
     }
-    auto temp = ptr->children_.at(c);
-    ptr = temp;
+    i += node->prefix_.size();
   }
 
-  if (!ptr->is_value_node_) {
+  if (!node->is_value_node_) {
     return nullptr;
   }
-  auto temp_value = dynamic_cast<const TrieNodeWithValue<T> *>(ptr.get());
+  auto temp_value = dynamic_cast<const TrieNodeWithValue<T> *>(node);
   if (temp_value == nullptr) {
     return nullptr;
   }
@@ -39,111 +153,185 @@ auto Trie::Get(std::string_view key) const -> const T * {
 template <class T>
 auto Trie::Put(std::string_view key, T value) const -> Trie {
   // Note that `T` might be a non-copyable type. Always use `std::move` when creating `shared_ptr` on that value.
+  return PutShared<T>(key, MakePooled<T>(std::move(value)));
+}
+
+template <class T>
+auto Trie::PutShared(std::string_view key, std::shared_ptr<T> value) const -> Trie {
   // put 注意 这里要新创建一个根节点
+  auto root = root_ != nullptr ? root_ : MakePooled<const TrieNode>();
+  return Trie(PutAt<T>(root, key, std::move(value)));
+}
 
-  // 1. 建立新的trie树
-  Trie trie;
-  if (!root_) {
-    std::shared_ptr<const TrieNode> root = std::make_shared<const TrieNode>();
-    return Trie(root).Put(key, std::move(value));
+template <class T>
+auto Trie::PutAt(const std::shared_ptr<const TrieNode> &node, std::string_view rest, std::shared_ptr<T> value)
+    -> std::shared_ptr<const TrieNode> {
+  if (rest.empty()) {
+    // 覆盖或者新增值，保留原来的孩子和压缩路径
+    return MakePooled<const TrieNodeWithValue<T>>(node->children_, std::move(value), node->prefix_);
   }
-  std::shared_ptr<TrieNode> ptr = root_->Clone();
-  auto root = ptr;
-
-  // 2. 字符串为空
-  if (key.empty()) {
-    ptr = std::make_shared<TrieNodeWithValue<T>>(ptr->children_, std::make_shared<T>(std::move(value)));
-    return Trie(ptr);
+  std::shared_ptr<TrieNode> new_node = node->Clone();
+  const auto *child = node->children_.Find(rest[0]);
+  auto tail = rest.substr(1);
+  if (child == nullptr) {
+    // 没有这个分支，剩下的key整段压缩进一个叶子
+    new_node->children_.Set(rest[0], MakePooled<const TrieNodeWithValue<T>>(std::move(value), std::string(tail)));
+    return new_node;
   }
 
-  // 3. 遍历字符串
-  size_t i = 0;
-  for (; i < key.size() - 1; i++) {
-    if (ptr->children_.count(key[i]) == 0) {
-      // 没有这个分支，创建一个新的分支
-      std::shared_ptr<TrieNode> new_node = std::make_shared<TrieNode>();
-      ptr->children_[key[i]] = new_node;
-      ptr = new_node;
-    } else {
-      // 已有这个分支，直接访问
-      std::shared_ptr<TrieNode> child = ptr->children_[key[i]].get()->Clone();
-      ptr->children_[key[i]] = child;
-      ptr = child;
-    }
+  const auto &prefix = (*child)->prefix_;
+  size_t common = 0;
+  while (common < prefix.size() && common < tail.size() && prefix[common] == tail[common]) {
+    common++;
   }
-  std::shared_ptr<TrieNodeWithValue<T>> value_node;
-  if (ptr->children_.count(key.back()) == 0) {
-    // 不存在
-    value_node = std::make_shared<TrieNodeWithValue<T>>(std::make_shared<T>(std::move(value)));
-  } else {
-    value_node = std::make_shared<TrieNodeWithValue<T>>(ptr->children_[key.back()]->children_,
-                                                        std::make_shared<T>(std::move(value)));
+  std::shared_ptr<const TrieNode> next = *child;
+  if (common < prefix.size()) {
+    // key在压缩路径中间分叉，把路径拆成上下两段
+    std::shared_ptr<TrieNode> lower = (*child)->Clone();
+    lower->prefix_ = prefix.substr(common + 1);
+    auto upper = MakePooled<TrieNode>(TrieChildren(), prefix.substr(0, common));
+    upper->children_.Set(prefix[common], std::move(lower));
+    next = std::move(upper);
   }
+  new_node->children_.Set(rest[0], PutAt<T>(next, tail.substr(common), std::move(value)));
+  return new_node;
+}
 
-  ptr->children_[key.back()] = value_node;
-  return Trie(root);
-  // You should walk through the trie and create new nodes if necessary. If the node corresponding to the key already
-  // exists, you should create a new `TrieNodeWithValue`.
+auto Trie::MergeWithChild(const TrieNode &node) -> std::shared_ptr<const TrieNode> {
+  std::shared_ptr<TrieNode> merged;
+  node.children_.ForEach([&node, &merged](char c, const std::shared_ptr<const TrieNode> &child) {
+    merged = child->Clone();
+    merged->prefix_ = node.prefix_ + c + child->prefix_;
+  });
+  return merged;
 }
 
-std::shared_ptr<const TrieNode> Trie::Dfs(const std::shared_ptr<const TrieNode> &root, std::string_view key,
-                                          size_t index) const {
-  if (index == key.size()) {
-    if (root->children_.empty()) {
-      return nullptr;
+auto Trie::RemoveAt(const std::shared_ptr<const TrieNode> &node, std::string_view rest, bool is_root)
+    -> std::shared_ptr<const TrieNode> {
+  std::shared_ptr<TrieNode> new_node;
+  if (rest.empty()) {
+    if (!node->is_value_node_) {
+      return node;
     }
-    /*
-     * auto ttt = root->Clone();
-     * ttt->is_value_node_ = false;
-     * return ttt;
-     * 是value没有清空吗？
-     * */
-    return std::make_shared<const TrieNode>(root->children_);
-  }
-  std::shared_ptr<const TrieNode> new_node;
-  auto t = std::const_pointer_cast<TrieNode>(root);
-  if (t->children_.find(key[index]) != root->children_.end()) {
-    /*如果这个key存在，则递归去处理子节点*/
-    new_node = Dfs(t->children_[key[index]], key, index + 1);
-    auto node = root->Clone();
-    /*获得处理之后的子节点，如果子节点为空了，则需要再字典树中把这个分支清理掉*/
-    if (new_node) {
-      node->children_[key[index]] = new_node;
+    new_node = MakePooled<TrieNode>(node->children_, node->prefix_);
+  } else {
+    const auto *child = node->children_.Find(rest[0]);
+    auto tail = rest.substr(1);
+    if (child == nullptr || tail.substr(0, (*child)->prefix_.size()) != (*child)->prefix_) {
+      // key不存在，原样返回
+      return node;
+    }
+    auto new_child = RemoveAt(*child, tail.substr((*child)->prefix_.size()), false);
+    if (new_child == *child) {
+      return node;
+    }
+    new_node = node->Clone();
+    if (new_child != nullptr) {
+      new_node->children_.Set(rest[0], std::move(new_child));
     } else {
-      node->children_.erase(key[index]);
-      if (!node->is_value_node_ && node->children_.empty()) {
-        return nullptr;
-      }
+      new_node->children_.Erase(rest[0]);
     }
-    return node;
   }
-  /*当这个key不存在时，直接返回原来的节点即可*/
-  return root;
+
+  if (new_node->is_value_node_) {
+    return new_node;
+  }
+  // 没有值也没有孩子的节点删掉；只剩一个孩子的节点和孩子合并成一段压缩路径，根节点除外
+  if (new_node->children_.Empty()) {
+    return nullptr;
+  }
+  if (!is_root && new_node->children_.Size() == 1) {
+    return MergeWithChild(*new_node);
+  }
+  return new_node;
 }
 
 auto Trie::Remove(std::string_view key) const -> Trie {
-  auto root = Dfs(root_, key, 0);
-  return Trie(root);
-  // throw NotImplementedException("Trie::Remove is not implemented.");
-
   // You should walk through the trie and remove nodes if necessary. If the node doesn't contain a value any more,
   // you should convert it to `TrieNode`. If a node doesn't have children any more, you should remove it.
+  if (!root_) {
+    return *this;
+  }
+  return Trie(RemoveAt(root_, key, true));
+}
+
+auto Trie::PrefixScan(std::string_view prefix, size_t limit) const -> TrieIterator {
+  const TrieNode *node = root_.get();
+  size_t i = 0;
+  while (node != nullptr && limit > 0) {
+    auto rest = prefix.substr(i);
+    size_t n = std::min(rest.size(), node->prefix_.size());
+    if (rest.substr(0, n) != std::string_view(node->prefix_).substr(0, n)) {
+      break;
+    }
+    if (rest.size() <= node->prefix_.size()) {
+      // 前缀在这个节点的压缩路径内结束，整棵子树都匹配
+      return {root_, node, std::string(prefix.substr(0, i)) + node->prefix_, limit};
+    }
+    i += node->prefix_.size();
+    const auto *child = node->children_.Find(prefix[i]);
+    node = child != nullptr ? child->get() : nullptr;
+    i++;
+  }
+  return {};
+}
+
+TrieIterator::TrieIterator(std::shared_ptr<const TrieNode> root, const TrieNode *start, std::string key, size_t limit)
+    : root_(std::move(root)), key_(std::move(key)), remaining_(limit) {
+  stack_.push_back({start, 0, key_.size()});
+  if (!start->is_value_node_) {
+    Advance();
+  }
 }
 
-// Below are explicit instantiation of template functions.
-//
-// Generally people would write the implementation of template classes and functions in the header file. However, we
-// separate the implementation into a .cpp file to make things clearer. In order to make the compiler know the
-// implementation of the template functions, we need to explicitly instantiate them here, so that they can be picked up
-// by the linker.
+void TrieIterator::Advance() {
+  while (!stack_.empty()) {
+    auto &top = stack_.back();
+    char c;
+    const auto *child = top.node_->children_.LowerBound(top.next_, &c);
+    if (child == nullptr) {
+      stack_.pop_back();
+      continue;
+    }
+    top.next_ = Byte(c) + 1;
+    key_.resize(top.key_size_);
+    key_.push_back(c);
+    key_.append((*child)->prefix_);
+    stack_.push_back({child->get(), 0, key_.size()});
+    if ((*child)->is_value_node_) {
+      return;
+    }
+  }
+  key_.clear();
+}
+
+auto TrieIterator::operator++() -> TrieIterator & {
+  if (--remaining_ == 0) {
+    stack_.clear();
+    key_.clear();
+    return *this;
+  }
+  Advance();
+  return *this;
+}
+
+auto TrieIterator::operator==(const TrieIterator &itr) const -> bool {
+  if (IsEnd() || itr.IsEnd()) {
+    return IsEnd() == itr.IsEnd();
+  }
+  return stack_.back().node_ == itr.stack_.back().node_;
+}
 
 template auto Trie::Put(std::string_view key, uint32_t value) const -> Trie;
+template auto Trie::PutShared(std::string_view key, std::shared_ptr<uint32_t> value) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const uint32_t *;
 
 template auto Trie::Put(std::string_view key, uint64_t value) const -> Trie;
+template auto Trie::PutShared(std::string_view key, std::shared_ptr<uint64_t> value) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const uint64_t *;
 
 template auto Trie::Put(std::string_view key, std::string value) const -> Trie;
+template auto Trie::PutShared(std::string_view key, std::shared_ptr<std::string> value) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const std::string *;
 
 // If your solution cannot compile for non-copy tests, you can remove the below lines to get partial score.
@@ -151,9 +339,11 @@ template auto Trie::Get(std::string_view key) const -> const std::string *;
 using Integer = std::unique_ptr<uint32_t>;
 
 template auto Trie::Put(std::string_view key, Integer value) const -> Trie;
+template auto Trie::PutShared(std::string_view key, std::shared_ptr<Integer> value) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const Integer *;
 
 template auto Trie::Put(std::string_view key, MoveBlocked value) const -> Trie;
+template auto Trie::PutShared(std::string_view key, std::shared_ptr<MoveBlocked> value) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const MoveBlocked *;
 
 }  // namespace bustub
@@ -0,0 +1,157 @@
+#include "primer/trie_node_pool.h"
+
+#include <array>
+#include <mutex>  // NOLINT
+#include <new>
+#include <vector>
+
+namespace bustub {
+
+namespace {
+
+static constexpr size_t NUM_SIZE_CLASSES = TRIE_POOL_MAX_BLOCK / TRIE_POOL_GRANULARITY;
+
+struct FreeBlock {
+  FreeBlock *next_;
+};
+
+auto SizeClass(size_t size) -> size_t {
+  return size == 0 ? 0 : (size + TRIE_POOL_GRANULARITY - 1) / TRIE_POOL_GRANULARITY - 1;
+}
+
+// Free lists shared by all threads, and the owner of every slab.
+struct SharedPool {
+  std::mutex latch_;
+  std::array<FreeBlock *, NUM_SIZE_CLASSES> free_{};
+  std::array<size_t, NUM_SIZE_CLASSES> free_count_{};
+  std::vector<std::unique_ptr<char[]>> slabs_;  // NOLINT
+
+  // Move up to n blocks of a size class into list, carving a new slab if there are none.
+  auto Take(size_t size_class, size_t n, FreeBlock **list) -> size_t {
+    std::scoped_lock lock(latch_);
+    if (free_[size_class] == nullptr) {
+      size_t block_size = (size_class + 1) * TRIE_POOL_GRANULARITY;
+      auto *slab = new char[TRIE_POOL_SLAB_SIZE];
+      slabs_.emplace_back(slab);
+      for (size_t offset = 0; offset + block_size <= TRIE_POOL_SLAB_SIZE; offset += block_size) {
+        auto *block = reinterpret_cast<FreeBlock *>(slab + offset);
+        block->next_ = free_[size_class];
+        free_[size_class] = block;
+        free_count_[size_class]++;
+      }
+    }
+    size_t taken = 0;
+    while (taken < n && free_[size_class] != nullptr) {
+      FreeBlock *block = free_[size_class];
+      free_[size_class] = block->next_;
+      block->next_ = *list;
+      *list = block;
+      taken++;
+    }
+    free_count_[size_class] -= taken;
+    return taken;
+  }
+
+  // Push a chain of n blocks ending at tail.
+  void Give(size_t size_class, FreeBlock *head, FreeBlock *tail, size_t n) {
+    std::scoped_lock lock(latch_);
+    tail->next_ = free_[size_class];
+    free_[size_class] = head;
+    free_count_[size_class] += n;
+  }
+};
+
+// Blocks can still be freed by static destructors after main returns, so the shared pool is never destroyed.
+auto GetSharedPool() -> SharedPool & {
+  static auto *pool = new SharedPool();
+  return *pool;
+}
+
+thread_local bool cache_destroyed = false;
+
+struct ThreadCache {
+  std::array<FreeBlock *, NUM_SIZE_CLASSES> free_{};
+  std::array<size_t, NUM_SIZE_CLASSES> free_count_{};
+
+  auto Allocate(size_t size_class) -> void * {
+    if (free_[size_class] == nullptr) {
+      free_count_[size_class] += GetSharedPool().Take(size_class, TRIE_POOL_BATCH, &free_[size_class]);
+    }
+    FreeBlock *block = free_[size_class];
+    free_[size_class] = block->next_;
+    free_count_[size_class]--;
+    return block;
+  }
+
+  void Deallocate(void *ptr, size_t size_class) {
+    auto *block = static_cast<FreeBlock *>(ptr);
+    block->next_ = free_[size_class];
+    free_[size_class] = block;
+    free_count_[size_class]++;
+    // 释放远多于分配的线程(比如专门丢弃旧快照的线程)把多余的块还给共享池
+    if (free_count_[size_class] >= 2 * TRIE_POOL_BATCH) {
+      FreeBlock *head = free_[size_class];
+      FreeBlock *tail = head;
+      for (size_t i = 1; i < TRIE_POOL_BATCH; i++) {
+        tail = tail->next_;
+      }
+      free_[size_class] = tail->next_;
+      free_count_[size_class] -= TRIE_POOL_BATCH;
+      GetSharedPool().Give(size_class, head, tail, TRIE_POOL_BATCH);
+    }
+  }
+
+  ~ThreadCache() {
+    for (size_t size_class = 0; size_class < NUM_SIZE_CLASSES; size_class++) {
+      if (free_[size_class] == nullptr) {
+        continue;
+      }
+      FreeBlock *tail = free_[size_class];
+      while (tail->next_ != nullptr) {
+        tail = tail->next_;
+      }
+      GetSharedPool().Give(size_class, free_[size_class], tail, free_count_[size_class]);
+    }
+    cache_destroyed = true;
+  }
+};
+
+thread_local ThreadCache cache;
+
+}  // namespace
+
+auto TrieNodePool::Allocate(size_t size) -> void * {
+  if (size > TRIE_POOL_MAX_BLOCK) {
+    return ::operator new(size);
+  }
+  size_t size_class = SizeClass(size);
+  if (cache_destroyed) {
+    // 线程退出时thread local已经析构，直接走共享池
+    FreeBlock *block = nullptr;
+    GetSharedPool().Take(size_class, 1, &block);
+    return block;
+  }
+  return cache.Allocate(size_class);
+}
+
+void TrieNodePool::Deallocate(void *ptr, size_t size) {
+  if (size > TRIE_POOL_MAX_BLOCK) {
+    ::operator delete(ptr);
+    return;
+  }
+  size_t size_class = SizeClass(size);
+  if (cache_destroyed) {
+    auto *block = static_cast<FreeBlock *>(ptr);
+    GetSharedPool().Give(size_class, block, block, 1);
+    return;
+  }
+  cache.Deallocate(ptr, size_class);
+}
+
+auto TrieNodePool::SlabCount() -> size_t {
+  auto &pool = GetSharedPool();
+  std::scoped_lock lock(pool.latch_);
+  return pool.slabs_.size();
+}
+
+}  // namespace bustub
@@ -5,16 +5,8 @@ namespace bustub {
 
 template <class T>
 auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<T>> {
-  // Pseudo-code:
-  // (1) Take the root lock, get the root, and release the root lock. Don't lookup the value in the
-  //     trie while holding the root lock.
-  // (2) Lookup the value in the trie.
-  // (3) If the value is found, return a ValueGuard object that holds a reference to the value and the
-  //     root. Otherwise, return std::nullopt.
-  // throw NotImplementedException("TrieStore::Get is not implemented.");
-  root_lock_.lock();
-  auto root = root_;
-  root_lock_.unlock();
+  // The ValueGuard keeps the snapshot root alive, so the value stays valid after later writes.
+  Trie root(std::atomic_load(&root_));
   const T *value = root.Get<T>(key);
   if (value != nullptr) {
     return ValueGuard<T>(root, *value);
@@ -24,37 +16,29 @@ auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<T>> {
 
 template <class T>
 void TrieStore::Put(std::string_view key, T value) {
-  // You will need to ensure there is only one writer at a time. Think of how you can achieve this.
-  // The logic should be somehow similar to `TrieStore::Get`.
-  // throw NotImplementedException("TrieStore::Put is not implemented.");
-  write_lock_.lock();
-  root_lock_.lock();
-  auto root = this->root_;
-  root_lock_.unlock();
-  root = root.Put(key, std::move(value));
-  root_lock_.lock();
-  root_ = root;
-  root_lock_.unlock();
-  write_lock_.unlock();
+  // value只move一次，CAS失败重试时复用同一个shared_ptr
+  auto shared_value = MakePooled<T>(std::move(value));
+  auto expected = std::atomic_load(&root_);
+  while (true) {
+    auto desired = Trie(expected).PutShared<T>(key, shared_value).root_;
+    // 失败时expected会被更新成最新的root，在新root上重做
+    if (std::atomic_compare_exchange_strong(&root_, &expected, desired)) {
+      return;
+    }
+  }
 }
 
 void TrieStore::Remove(std::string_view key) {
-  // You will need to ensure there is only one writer at a time. Think of how you can achieve this.
-  // The logic should be somehow similar to `TrieStore::Get`.
-  // throw NotImplementedException("TrieStore::Remove is not implemented.");
-  write_lock_.lock();
-  root_lock_.lock();
-  auto root = this->root_;
-  root_lock_.unlock();
-  root = root.Remove(key);
-  root_lock_.lock();
-  root_ = root;
-  root_lock_.unlock();
-  write_lock_.unlock();
+  auto expected = std::atomic_load(&root_);
+  while (true) {
+    auto desired = Trie(expected).Remove(key).root_;
+    // key不存在时树没有变化，不用发布
+    if (desired == expected || std::atomic_compare_exchange_strong(&root_, &expected, desired)) {
+      return;
+    }
+  }
 }
 
-// Below are explicit instantiation of template functions.
-
 template auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<uint32_t>>;
 template void TrieStore::Put(std::string_view key, uint32_t value);
 
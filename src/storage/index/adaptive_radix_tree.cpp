@@ -0,0 +1,489 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.cpp
+//
+// Identification: src/storage/index/adaptive_radix_tree.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/adaptive_radix_tree.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/macros.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+namespace {
+
+// Node4 / Node16 helpers, the key bytes are kept sorted
+
+template <typename SortedNode>
+auto FindSorted(SortedNode *node, uint8_t byte) -> int {
+  for (int i = 0; i < node->num_children_; i++) {
+    if (node->keys_[i] == byte) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+template <typename SortedNode, typename ChildPtr>
+void InsertSorted(SortedNode *node, uint8_t byte, ChildPtr child) {
+  int pos = 0;
+  while (pos < node->num_children_ && node->keys_[pos] < byte) {
+    pos++;
+  }
+  for (int i = node->num_children_; i > pos; i--) {
+    node->keys_[i] = node->keys_[i - 1];
+    node->children_[i] = std::move(node->children_[i - 1]);
+  }
+  node->keys_[pos] = byte;
+  node->children_[pos] = std::move(child);
+  node->num_children_++;
+}
+
+template <typename SortedNode>
+void RemoveSorted(SortedNode *node, int pos) {
+  for (int i = pos; i + 1 < node->num_children_; i++) {
+    node->keys_[i] = node->keys_[i + 1];
+    node->children_[i] = std::move(node->children_[i + 1]);
+  }
+  node->num_children_--;
+  node->children_[node->num_children_].reset();
+}
+
+// move every child of a sorted node into another sorted node that is large enough
+template <typename FromNode, typename ToNode>
+void MoveSorted(FromNode *from, ToNode *to) {
+  for (int i = 0; i < from->num_children_; i++) {
+    to->keys_[i] = from->keys_[i];
+    to->children_[i] = std::move(from->children_[i]);
+  }
+  to->num_children_ = from->num_children_;
+}
+
+}  // namespace
+
+template <typename ValueType>
+AdaptiveRadixTree<ValueType>::AdaptiveRadixTree(size_t key_size) : key_size_(key_size) {}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::GetValue(const uint8_t *key, ValueType *value) const -> bool {
+  Node *node = root_.get();
+  size_t depth = 0;
+  while (node != nullptr) {
+    if (node->type_ == ArtNodeType::LEAF) {
+      if (!LeafMatches(node, key)) {
+        return false;
+      }
+      if (value != nullptr) {
+        *value = static_cast<Leaf *>(node)->value_;
+      }
+      return true;
+    }
+    if (node->prefix_len_ > 0) {
+      // 乐观跳过没有存下来的前缀字节，最后在叶子上比较完整的key
+      if (CheckPrefix(node, key, depth) != std::min(node->prefix_len_, ART_MAX_PREFIX_LEN)) {
+        return false;
+      }
+      depth += node->prefix_len_;
+    }
+    if (depth >= key_size_) {
+      return false;
+    }
+    auto *child = FindChild(node, key[depth]);
+    node = child == nullptr ? nullptr : child->get();
+    depth++;
+  }
+  return false;
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::FindChild(Node *node, uint8_t byte) -> std::unique_ptr<Node> * {
+  switch (node->type_) {
+    case ArtNodeType::NODE4: {
+      auto *n = static_cast<Node4 *>(node);
+      int pos = FindSorted(n, byte);
+      return pos < 0 ? nullptr : &n->children_[pos];
+    }
+    case ArtNodeType::NODE16: {
+      auto *n = static_cast<Node16 *>(node);
+      int pos = FindSorted(n, byte);
+      return pos < 0 ? nullptr : &n->children_[pos];
+    }
+    case ArtNodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      uint8_t index = n->child_index_[byte];
+      return index == 0 ? nullptr : &n->children_[index - 1];
+    }
+    case ArtNodeType::NODE256: {
+      auto *n = static_cast<Node256 *>(node);
+      return n->children_[byte] == nullptr ? nullptr : &n->children_[byte];
+    }
+    default:
+      return nullptr;
+  }
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::CheckPrefix(const Node *node, const uint8_t *key, size_t depth) const -> uint32_t {
+  uint32_t max_cmp = std::min<size_t>(std::min(node->prefix_len_, ART_MAX_PREFIX_LEN), key_size_ - depth);
+  uint32_t idx = 0;
+  while (idx < max_cmp && node->prefix_[idx] == key[depth + idx]) {
+    idx++;
+  }
+  return idx;
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::PrefixMismatch(const Node *node, const uint8_t *key, size_t depth) const
+    -> uint32_t {
+  uint32_t idx = CheckPrefix(node, key, depth);
+  if (idx < ART_MAX_PREFIX_LEN || node->prefix_len_ <= ART_MAX_PREFIX_LEN) {
+    return idx;
+  }
+  // 前缀比存下来的长，剩下的字节从任意一个叶子的key里取
+  const Leaf *leaf = Minimum(node);
+  uint32_t max_cmp = std::min<size_t>(node->prefix_len_, key_size_ - depth);
+  while (idx < max_cmp && leaf->key_[depth + idx] == key[depth + idx]) {
+    idx++;
+  }
+  return idx;
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::Minimum(const Node *node) -> const Leaf * {
+  while (node != nullptr && node->type_ != ArtNodeType::LEAF) {
+    switch (node->type_) {
+      case ArtNodeType::NODE4:
+        node = static_cast<const Node4 *>(node)->children_[0].get();
+        break;
+      case ArtNodeType::NODE16:
+        node = static_cast<const Node16 *>(node)->children_[0].get();
+        break;
+      case ArtNodeType::NODE48: {
+        const auto *n = static_cast<const Node48 *>(node);
+        int byte = 0;
+        while (n->child_index_[byte] == 0) {
+          byte++;
+        }
+        node = n->children_[n->child_index_[byte] - 1].get();
+        break;
+      }
+      case ArtNodeType::NODE256: {
+        const auto *n = static_cast<const Node256 *>(node);
+        int byte = 0;
+        while (n->children_[byte] == nullptr) {
+          byte++;
+        }
+        node = n->children_[byte].get();
+        break;
+      }
+      default:
+        UNREACHABLE("unknown art node type");
+    }
+  }
+  return static_cast<const Leaf *>(node);
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::LeafMatches(const Node *node, const uint8_t *key) const -> bool {
+  const auto *leaf = static_cast<const Leaf *>(node);
+  return memcmp(leaf->key_.data(), key, key_size_) == 0;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::Insert(const uint8_t *key, const ValueType &value) -> bool {
+  return InsertAt(root_, key, 0, value);
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::InsertAt(std::unique_ptr<Node> &node_ref, const uint8_t *key, size_t depth,
+                                            const ValueType &value) -> bool {
+  if (node_ref == nullptr) {
+    node_ref = std::make_unique<Leaf>(key, key_size_, value);
+    size_++;
+    return true;
+  }
+  Node *node = node_ref.get();
+  if (node->type_ == ArtNodeType::LEAF) {
+    if (LeafMatches(node, key)) {
+      return false;
+    }
+    // 叶子分裂成一个Node4，公共部分作为新节点的前缀
+    const auto *leaf = static_cast<Leaf *>(node);
+    uint32_t common = 0;
+    while (depth + common < key_size_ && leaf->key_[depth + common] == key[depth + common]) {
+      common++;
+    }
+    BUSTUB_ASSERT(depth + common < key_size_, "distinct fixed-length keys must differ before the end");
+    std::unique_ptr<Node> new_node = std::make_unique<Node4>();
+    new_node->prefix_len_ = common;
+    memcpy(new_node->prefix_.data(), key + depth, std::min(common, ART_MAX_PREFIX_LEN));
+    uint8_t old_byte = leaf->key_[depth + common];
+    AddChild(new_node, old_byte, std::move(node_ref));
+    AddChild(new_node, key[depth + common], std::make_unique<Leaf>(key, key_size_, value));
+    node_ref = std::move(new_node);
+    size_++;
+    return true;
+  }
+
+  if (node->prefix_len_ > 0) {
+    uint32_t mismatch = PrefixMismatch(node, key, depth);
+    if (mismatch < node->prefix_len_) {
+      // 前缀在中间不匹配，在不匹配的位置插入一个新的Node4
+      std::unique_ptr<Node> new_node = std::make_unique<Node4>();
+      new_node->prefix_len_ = mismatch;
+      memcpy(new_node->prefix_.data(), node->prefix_.data(), std::min(mismatch, ART_MAX_PREFIX_LEN));
+      uint8_t old_byte;
+      if (node->prefix_len_ <= ART_MAX_PREFIX_LEN) {
+        old_byte = node->prefix_[mismatch];
+        node->prefix_len_ -= mismatch + 1;
+        memmove(node->prefix_.data(), node->prefix_.data() + mismatch + 1,
+                std::min(node->prefix_len_, ART_MAX_PREFIX_LEN));
+      } else {
+        const Leaf *leaf = Minimum(node);
+        old_byte = leaf->key_[depth + mismatch];
+        node->prefix_len_ -= mismatch + 1;
+        memcpy(node->prefix_.data(), leaf->key_.data() + depth + mismatch + 1,
+               std::min(node->prefix_len_, ART_MAX_PREFIX_LEN));
+      }
+      AddChild(new_node, old_byte, std::move(node_ref));
+      AddChild(new_node, key[depth + mismatch], std::make_unique<Leaf>(key, key_size_, value));
+      node_ref = std::move(new_node);
+      size_++;
+      return true;
+    }
+    depth += node->prefix_len_;
+  }
+
+  auto *child = FindChild(node, key[depth]);
+  if (child != nullptr) {
+    return InsertAt(*child, key, depth + 1, value);
+  }
+  AddChild(node_ref, key[depth], std::make_unique<Leaf>(key, key_size_, value));
+  size_++;
+  return true;
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::CopyPrefix(Node *dst, const Node *src) {
+  dst->prefix_len_ = src->prefix_len_;
+  dst->prefix_ = src->prefix_;
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::AddChild(std::unique_ptr<Node> &node_ref, uint8_t byte,
+                                            std::unique_ptr<Node> child) {
+  switch (node_ref->type_) {
+    case ArtNodeType::NODE4: {
+      auto *n = static_cast<Node4 *>(node_ref.get());
+      if (n->num_children_ < 4) {
+        InsertSorted(n, byte, std::move(child));
+        return;
+      }
+      auto grown = std::make_unique<Node16>();
+      CopyPrefix(grown.get(), n);
+      MoveSorted(n, grown.get());
+      InsertSorted(grown.get(), byte, std::move(child));
+      node_ref = std::move(grown);
+      return;
+    }
+    case ArtNodeType::NODE16: {
+      auto *n = static_cast<Node16 *>(node_ref.get());
+      if (n->num_children_ < 16) {
+        InsertSorted(n, byte, std::move(child));
+        return;
+      }
+      auto grown = std::make_unique<Node48>();
+      CopyPrefix(grown.get(), n);
+      for (int i = 0; i < n->num_children_; i++) {
+        grown->child_index_[n->keys_[i]] = i + 1;
+        grown->children_[i] = std::move(n->children_[i]);
+      }
+      grown->num_children_ = n->num_children_;
+      node_ref = std::move(grown);
+      AddChild(node_ref, byte, std::move(child));
+      return;
+    }
+    case ArtNodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node_ref.get());
+      if (n->num_children_ < 48) {
+        int pos = 0;
+        while (n->children_[pos] != nullptr) {
+          pos++;
+        }
+        n->children_[pos] = std::move(child);
+        n->child_index_[byte] = pos + 1;
+        n->num_children_++;
+        return;
+      }
+      auto grown = std::make_unique<Node256>();
+      CopyPrefix(grown.get(), n);
+      for (int b = 0; b < 256; b++) {
+        if (n->child_index_[b] != 0) {
+          grown->children_[b] = std::move(n->children_[n->child_index_[b] - 1]);
+        }
+      }
+      grown->num_children_ = n->num_children_;
+      node_ref = std::move(grown);
+      AddChild(node_ref, byte, std::move(child));
+      return;
+    }
+    case ArtNodeType::NODE256: {
+      auto *n = static_cast<Node256 *>(node_ref.get());
+      n->children_[byte] = std::move(child);
+      n->num_children_++;
+      return;
+    }
+    default:
+      UNREACHABLE("cannot add a child to a leaf");
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::Remove(const uint8_t *key) -> bool {
+  return RemoveAt(root_, key, 0);
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::RemoveAt(std::unique_ptr<Node> &node_ref, const uint8_t *key, size_t depth)
+    -> bool {
+  Node *node = node_ref.get();
+  if (node == nullptr) {
+    return false;
+  }
+  if (node->type_ == ArtNodeType::LEAF) {
+    // 只有根是叶子时才会走到这里
+    if (!LeafMatches(node, key)) {
+      return false;
+    }
+    node_ref.reset();
+    size_--;
+    return true;
+  }
+  if (node->prefix_len_ > 0) {
+    if (CheckPrefix(node, key, depth) != std::min(node->prefix_len_, ART_MAX_PREFIX_LEN)) {
+      return false;
+    }
+    depth += node->prefix_len_;
+  }
+  if (depth >= key_size_) {
+    return false;
+  }
+  auto *child = FindChild(node, key[depth]);
+  if (child == nullptr) {
+    return false;
+  }
+  if ((*child)->type_ == ArtNodeType::LEAF) {
+    if (!LeafMatches(child->get(), key)) {
+      return false;
+    }
+    RemoveChild(node_ref, key[depth]);
+    size_--;
+    return true;
+  }
+  return RemoveAt(*child, key, depth + 1);
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::RemoveChild(std::unique_ptr<Node> &node_ref, uint8_t byte) {
+  switch (node_ref->type_) {
+    case ArtNodeType::NODE4: {
+      auto *n = static_cast<Node4 *>(node_ref.get());
+      RemoveSorted(n, FindSorted(n, byte));
+      if (n->num_children_ > 1) {
+        return;
+      }
+      // 只剩一个孩子，把自己的前缀和那个字节拼到孩子的前缀前面，然后用孩子替换自己
+      std::unique_ptr<Node> child = std::move(n->children_[0]);
+      if (child->type_ != ArtNodeType::LEAF) {
+        uint32_t prefix = n->prefix_len_;
+        if (prefix < ART_MAX_PREFIX_LEN) {
+          n->prefix_[prefix] = n->keys_[0];
+          prefix++;
+        }
+        if (prefix < ART_MAX_PREFIX_LEN) {
+          uint32_t sub_prefix = std::min(child->prefix_len_, ART_MAX_PREFIX_LEN - prefix);
+          memcpy(n->prefix_.data() + prefix, child->prefix_.data(), sub_prefix);
+          prefix += sub_prefix;
+        }
+        memcpy(child->prefix_.data(), n->prefix_.data(), std::min(prefix, ART_MAX_PREFIX_LEN));
+        child->prefix_len_ += n->prefix_len_ + 1;
+      }
+      node_ref = std::move(child);
+      return;
+    }
+    case ArtNodeType::NODE16: {
+      auto *n = static_cast<Node16 *>(node_ref.get());
+      RemoveSorted(n, FindSorted(n, byte));
+      if (n->num_children_ > 3) {
+        return;
+      }
+      auto shrunk = std::make_unique<Node4>();
+      CopyPrefix(shrunk.get(), n);
+      MoveSorted(n, shrunk.get());
+      node_ref = std::move(shrunk);
+      return;
+    }
+    case ArtNodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node_ref.get());
+      n->children_[n->child_index_[byte] - 1].reset();
+      n->child_index_[byte] = 0;
+      n->num_children_--;
+      if (n->num_children_ > 12) {
+        return;
+      }
+      auto shrunk = std::make_unique<Node16>();
+      CopyPrefix(shrunk.get(), n);
+      for (int b = 0; b < 256; b++) {
+        if (n->child_index_[b] != 0) {
+          shrunk->keys_[shrunk->num_children_] = b;
+          shrunk->children_[shrunk->num_children_] = std::move(n->children_[n->child_index_[b] - 1]);
+          shrunk->num_children_++;
+        }
+      }
+      node_ref = std::move(shrunk);
+      return;
+    }
+    case ArtNodeType::NODE256: {
+      auto *n = static_cast<Node256 *>(node_ref.get());
+      n->children_[byte].reset();
+      n->num_children_--;
+      if (n->num_children_ > 37) {
+        return;
+      }
+      auto shrunk = std::make_unique<Node48>();
+      CopyPrefix(shrunk.get(), n);
+      for (int b = 0; b < 256; b++) {
+        if (n->children_[b] != nullptr) {
+          shrunk->children_[shrunk->num_children_] = std::move(n->children_[b]);
+          shrunk->num_children_++;
+          shrunk->child_index_[b] = shrunk->num_children_;
+        }
+      }
+      node_ref = std::move(shrunk);
+      return;
+    }
+    default:
+      UNREACHABLE("cannot remove a child from a leaf");
+  }
+}
+
+template class AdaptiveRadixTree<RID>;
+
+}  // namespace bustub
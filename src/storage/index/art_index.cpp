@@ -0,0 +1,54 @@
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "storage/index/art_index.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+ART_INDEX_TYPE::ARTIndex(std::unique_ptr<IndexMetadata> &&metadata)
+    : Index(std::move(metadata)), container_(sizeof(KeyType)) {}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto ART_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  // construct insert index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  return container_.Insert(reinterpret_cast<const uint8_t *>(index_key.data_), rid);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void ART_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct delete index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  container_.Remove(reinterpret_cast<const uint8_t *>(index_key.data_));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void ART_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  // construct scan index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  RID rid;
+  if (container_.GetValue(reinterpret_cast<const uint8_t *>(index_key.data_), &rid)) {
+    result->push_back(rid);
+  }
+}
+
+template class ARTIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class ARTIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class ARTIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class ARTIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class ARTIndex<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -1,5 +1,6 @@
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -18,13 +19,17 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
       internal_max_size_(internal_max_size),
       header_page_id_(header_page_id) {
   WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
-  std::cout << guard.PageId() << std::endl;
   auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
-  std::cout << header_page_id_ << std::endl;
-  std::cout << "root_page->root_page_id_ = " << root_page->root_page_id_ << std::endl;
   root_page->root_page_id_ = INVALID_PAGE_ID;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() {
+  if (merge_thread_ != nullptr) {
+    StopLazyMerge();
+  }
+}
+
 // 得到一个写保护页面
 auto Context::GetWritePageGuardAt(BufferPoolManager *bpm, page_id_t page_id) -> WritePageGuard {
   auto itr = write_set_.end();
@@ -90,30 +95,69 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
-  // 定义读写页面保护
+  std::shared_lock<std::shared_mutex> structure_guard(structure_latch_);
   Context ctx;
-  (void)ctx;
   // 找到key所在的叶子节点
-  page_id_t leaf_page_id = GetKeyAt(key, comparator_, ctx);
+  page_id_t leaf_page_id = FindPageAtLevel(key, 0, ctx);
   if (leaf_page_id == INVALID_PAGE_ID) {
     return false;
   }
-  auto leaf_page_guard = std::move(ctx.read_set_.back());
-  ctx.read_set_.pop_back();
+  ReadPageGuard leaf_page_guard = bpm_->FetchPageRead(leaf_page_id);
   auto *leaf_page = leaf_page_guard.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+  // 叶子节点可能刚被并发分裂，key已经被移到右兄弟，沿右链继续找
+  while (leaf_page->NeedMoveRight(key, comparator_)) {
+    leaf_page_guard = bpm_->FetchPageRead(leaf_page->GetNextPageId());
+    leaf_page = leaf_page_guard.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+  }
   //找到key所在叶子节点中的位置
   int i = leaf_page->Lookup(key, comparator_);
-  bool is_success = false;
   if (i >= 0 && i < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(i), key) == 0) {
     if (result != nullptr) {
       result->push_back(leaf_page->ValueAt(i));
     }
-    is_success = true;
+    return true;
   }
-  if (!is_success) {
-    is_success = false;
+  return false;
+}
+
+/*
+ * Descend from the root to the page on the given level whose key range covers key.
+ * Only one page is latched at a time; a page that was split under us is handled by
+ * following its right link. Internal pages passed on the way down are recorded in
+ * ctx.access_set_, so access_set_.back() is the parent of the returned page at the
+ * time of the descent.
+ * @return : page id on that level (not latched), INVALID_PAGE_ID if the tree is
+ * empty or not tall enough
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindPageAtLevel(const KeyType &key, int level, Context &ctx) -> page_id_t {
+  page_id_t page_id;
+  {
+    ReadPageGuard header_page_guard = bpm_->FetchPageRead(header_page_id_);
+    page_id = header_page_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
   }
-  return is_success;
+  ctx.root_page_id_ = page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    ReadPageGuard page_guard = bpm_->FetchPageRead(page_id);
+    auto *page = page_guard.As<BPlusTreePage>();
+    if (page->GetLevel() < level) {
+      return INVALID_PAGE_ID;
+    }
+    if (page->GetLevel() == level) {
+      return page_id;
+    }
+    auto *internal_page = page_guard.As<BPlusTree::InternalPage>();
+    if (internal_page->NeedMoveRight(key, comparator_)) {
+      page_id = internal_page->GetRightPageId();
+      continue;
+    }
+    ctx.access_set_.push_back(page_id);
+    page_id = internal_page->ChildFor(key, comparator_);
+    if (internal_page->GetLevel() == level + 1) {
+      return page_id;
+    }
+  }
+  return INVALID_PAGE_ID;
 }
 
 /*****************************************************************************
@@ -126,131 +170,67 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
  */
-
-// 得到key所在的叶子节点
-INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetKeyAt(const KeyType &key, const KeyComparator &comparator, Context &ctx) -> page_id_t {
-  ReadPageGuard page_guard = bpm_->FetchPageRead(header_page_id_);
-  auto *p_header_page = page_guard.As<BPlusTreeHeaderPage>();
-  page_id_t root_page_id = p_header_page->root_page_id_;
-  ctx.root_page_id_ = root_page_id;
-  ctx.read_set_.push_back(std::move(page_guard));
-  if (root_page_id == INVALID_PAGE_ID) {
-    return INVALID_PAGE_ID;
-  }
-  ReadPageGuard root_page_guard = bpm_->FetchPageRead(root_page_id);
-  auto *root_page = root_page_guard.As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-  ctx.access_set_.push_back(root_page_id);
-  ctx.read_set_.push_back(std::move(root_page_guard));
-  while (!root_page->IsLeafPage()) {
-    int i = root_page->Lookup(key, comparator);
-    if (i != root_page->GetSize() && comparator(key, root_page->KeyAt(i)) == 0) {
-      root_page_id = root_page->GetValue(i);
-    } else {
-      root_page_id = root_page->GetValue(i - 1);
-    }
-    root_page_guard = bpm_->FetchPageRead(root_page_id);
-    root_page = root_page_guard.As<BPlusTree::InternalPage>();
-    ctx.read_set_.pop_back();
-    ctx.read_set_.push_back(std::move(root_page_guard));
-    ctx.access_set_.push_back(root_page_id);
-  }
-  return root_page_id;
-}
-
-// 得到key所在的叶子节点
-INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::InsertGetKeyAt(const KeyType &key, const KeyComparator &comparator, Context &ctx) -> page_id_t {
-  auto header_page_guard = bpm_->FetchPageWrite(header_page_id_);
-  auto *header_page = header_page_guard.template AsMut<BPlusTreeHeaderPage>();
-  ctx.header_page_ = std::move(header_page_guard);
-  page_id_t root_page_id = header_page->root_page_id_;
-  if (root_page_id == INVALID_PAGE_ID) {
-    bpm_->NewPageGuarded(&root_page_id);
-    auto write_guard = bpm_->FetchPageWrite(root_page_id);
-    auto *p_leaf_page = write_guard.AsMut<BPlusTree::LeafPage>();
-    p_leaf_page->SetPageType(IndexPageType::LEAF_PAGE);
-    p_leaf_page->SetMaxSize(leaf_max_size_);
-    p_leaf_page->SetNextPageId(INVALID_PAGE_ID);
-    p_leaf_page->SetSize(0);
-    SetRootPageId(root_page_id, ctx);
-    ctx.write_set_.push_back(std::move(write_guard));
-    ctx.access_set_.push_back(root_page_id);
-    ctx.root_page_id_ = root_page_id;
-    // std::cout << "header_page_id_ = " << header_page_id_ << " root_page_id " << root_page_id << std::endl;
-    return root_page_id;
-  }
-  ctx.root_page_id_ = root_page_id;
-  WritePageGuard root_page_guard = bpm_->FetchPageWrite(root_page_id);
-  auto *root_page = root_page_guard.AsMut<BPlusTree::InternalPage>();
-  ctx.access_set_.push_back(root_page_id);
-  ctx.write_set_.push_back(std::move(root_page_guard));
-  while (!root_page->IsLeafPage()) {
-    int i = root_page->Lookup(key, comparator);
-    if (i != root_page->GetSize() && comparator(key, root_page->KeyAt(i)) == 0) {
-      root_page_id = root_page->GetValue(i);
-    } else {
-      root_page_id = root_page->GetValue(i - 1);
-    }
-    root_page_guard = bpm_->FetchPageWrite(root_page_id);
-    root_page = root_page_guard.AsMut<BPlusTree::InternalPage>();
-    if (root_page->GetSize() + 1 < root_page->GetMaxSize()) {
-      if (ctx.header_page_ != std::nullopt) {
-        ctx.header_page_.reset();
-      }
-      ctx.write_set_.clear();
-    }
-    ctx.write_set_.push_back(std::move(root_page_guard));
-    ctx.access_set_.push_back(root_page_id);
-  }
-  return root_page_id;
-}
-
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
+  std::shared_lock<std::shared_mutex> structure_guard(structure_latch_);
   Context ctx;
-  (void)ctx;
-  bool is_success;
   // 找到插入key的叶子节点
-  page_id_t leaf_page_id = InsertGetKeyAt(key, comparator_, ctx);
-  WritePageGuard leaf_page_guard = std::move(ctx.write_set_.back());
-  ctx.write_set_.pop_back();
+  page_id_t leaf_page_id = FindPageAtLevel(key, 0, ctx);
+  while (leaf_page_id == INVALID_PAGE_ID) {
+    // 空树，在header page的写锁下建立根节点
+    auto header_page_guard = bpm_->FetchPageWrite(header_page_id_);
+    auto *header_page = header_page_guard.AsMut<BPlusTreeHeaderPage>();
+    if (header_page->root_page_id_ == INVALID_PAGE_ID) {
+      page_id_t root_page_id;
+      bpm_->NewPageGuarded(&root_page_id);
+      auto root_page_guard = bpm_->FetchPageWrite(root_page_id);
+      root_page_guard.AsMut<BPlusTree::LeafPage>()->Init(leaf_max_size_);
+      header_page->root_page_id_ = root_page_id;
+    }
+    header_page_guard.Drop();
+    ctx.access_set_.clear();
+    leaf_page_id = FindPageAtLevel(key, 0, ctx);
+  }
+  WritePageGuard leaf_page_guard = bpm_->FetchPageWrite(leaf_page_id);
   auto *leaf_page = leaf_page_guard.AsMut<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+  while (leaf_page->NeedMoveRight(key, comparator_)) {
+    leaf_page_id = leaf_page->GetNextPageId();
+    leaf_page_guard = bpm_->FetchPageWrite(leaf_page_id);
+    leaf_page = leaf_page_guard.AsMut<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+  }
   // 找到key在叶子节点中的位置
   int index = leaf_page->Lookup(key, comparator_);
-
-  if (index > 0 && index < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(index), key) == 0) {
+  if (index >= 0 && index < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(index), key) == 0) {
     // 已经存在
-    is_success = false;
-  } else {
-    // 如果有足够的空间，直接插入
-    if (leaf_page->GetSize() + 1 < leaf_page->GetMaxSize()) {
-      leaf_page->Insert(key, value, comparator_);
-    } else {
-      // 如果没有足够的空间，则新建一个页面，将原来的页面分成两半，将key插入到合适的位置
-      page_id_t leaf_page_id_new;
-      bpm_->NewPageGuarded(&leaf_page_id_new);
-      auto leaf_page_new_guard = bpm_->FetchPageWrite(leaf_page_id_new);
-      auto *leaf_page_new = leaf_page_new_guard.template AsMut<B_PLUS_TREE_LEAF_PAGE_TYPE>();
-      leaf_page_new->SetMaxSize(leaf_max_size_);
-      leaf_page_new->SetSize(0);
-      leaf_page_new->SetPageType(IndexPageType::LEAF_PAGE);
-      leaf_page_new->SetNextPageId(leaf_page->GetNextPageId());
-      // if(maxsize() == 5 )leaf_page_new.size() = 2;
-      // if(maxsize() == 6 )leaf_page_new.size() = 3;  
-      leaf_page->MoveHalfTo(leaf_page_new);
-      leaf_page->SetNextPageId(leaf_page_id_new);
-      if (index <= (leaf_page->GetMaxSize() - 1) / 2) {
-        leaf_page->Insert(key, value, comparator_);
-      } else {
-        leaf_page_new->Insert(key, value, comparator_);
-      }
-      KeyType mid_key = leaf_page_new->KeyAt(0);
-      InsertInParent(leaf_page_id, mid_key, leaf_page_id_new, ctx);
-    }
-    is_success = true;
+    return false;
   }
-  return is_success;
+  // 如果有足够的空间，直接插入
+  if (leaf_page->GetSize() + 1 < leaf_page->GetMaxSize()) {
+    leaf_page->Insert(key, value, comparator_);
+    return true;
+  }
+  // 如果没有足够的空间，则新建一个页面，将原来的页面分成两半，将key插入到合适的位置
+  page_id_t leaf_page_id_new;
+  bpm_->NewPageGuarded(&leaf_page_id_new);
+  auto leaf_page_new_guard = bpm_->FetchPageWrite(leaf_page_id_new);
+  auto *leaf_page_new = leaf_page_new_guard.template AsMut<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+  leaf_page_new->Init(leaf_max_size_);
+  // 新页面接管原页面的右链和high key
+  leaf_page_new->SetNextPageId(leaf_page->GetNextPageId());
+  leaf_page_new->SetHighKey(leaf_page->GetHighKey());
+  leaf_page->MoveHalfTo(leaf_page_new);
+  if (index <= (leaf_page->GetMaxSize() - 1) / 2) {
+    leaf_page->Insert(key, value, comparator_);
+  } else {
+    leaf_page_new->Insert(key, value, comparator_);
+  }
+  KeyType mid_key = leaf_page_new->KeyAt(0);
+  leaf_page->SetNextPageId(leaf_page_id_new);
+  leaf_page->SetHighKey(mid_key);
+  // 新页面已经可以通过右链访问，不需要再持有
+  leaf_page_new_guard.Drop();
+  InsertInParent(std::move(leaf_page_guard), mid_key, leaf_page_id_new, ctx);
+  return true;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -262,57 +242,91 @@ auto BPLUSTREE_TYPE::GetParentPageId(page_id_t child, Context &ctx) -> page_id_t
   return parent_id;
 }
 
+/*
+ * Insert the separator of a split into the parent level. The split page is
+ * still write latched by left_page_guard; it is released as soon as the parent
+ * is latched, so no latch is held on the ancestors above the parent. The parent
+ * is taken from the path recorded in ctx.access_set_, or found again from the
+ * root when the split page was the root at the time of the descent.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::InsertInParent(page_id_t leaf_page_left_id, KeyType key, page_id_t leaf_page_right_id,
+void BPLUSTREE_TYPE::InsertInParent(WritePageGuard &&left_page_guard, const KeyType &key, page_id_t right_page_id,
                                     Context &ctx) {
-  page_id_t root_page_id = ctx.root_page_id_;
-
-  // 如果当前只有一个节点
-  if (root_page_id == leaf_page_left_id) {
-    page_id_t root_page_new_id;
-    bpm_->NewPageGuarded(&root_page_new_id);
-
-    auto root_page_new_guard = bpm_->FetchPageWrite(root_page_new_id);
-    auto *root_page_new =
-        root_page_new_guard.AsMut<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-    root_page_new->SetPageType(IndexPageType::INTERNAL_PAGE);
-    root_page_new->SetMaxSize(internal_max_size_);
-    root_page_new->SetSize(0);
-    root_page_new->InsertFirstOf(leaf_page_left_id);
-    root_page_new->Insert(key, leaf_page_right_id, comparator_);
-    SetRootPageId(root_page_new_id, ctx);
-  } else {
-    page_id_t parent_page_id = GetParentPageId(leaf_page_left_id, ctx);
-    auto parent_page_guard = std::move(ctx.write_set_.back());
-    ctx.write_set_.pop_back();
-    auto *parent_page = parent_page_guard.AsMut<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-    if (parent_page->GetSize() < parent_page->GetMaxSize()) {
-      // 够就直接插入
-      parent_page->Insert(key, leaf_page_right_id, comparator_);
-    } else {
-      // 内部节点split
-      int index = parent_page->Lookup(key, comparator_);
-      page_id_t parent_page_new_id;
-      bpm_->NewPageGuarded(&parent_page_new_id);
-      auto parent_page_new_guard = bpm_->FetchPageWrite(parent_page_new_id);
-      auto *parent_page_new = parent_page_new_guard.AsMut<BPlusTree::InternalPage>();
-      parent_page_new->SetPageType(IndexPageType::INTERNAL_PAGE);
-      parent_page_new->SetMaxSize(internal_max_size_);
-      parent_page_new->SetSize(0);
-      parent_page->MoveHalfTo(parent_page_new);
-      if (index > parent_page->GetMaxSize() / 2) {
-        parent_page_new->Insert(key, leaf_page_right_id, comparator_);
-      } else {
-        parent_page->Insert(key, leaf_page_right_id, comparator_);
-      }
-      KeyType mid_key = parent_page_new->KeyAt(1);
-      page_id_t mid_page_id = parent_page_new->ValueAt(1);
-      parent_page_new->EraseAt(1);
-      parent_page_new->EraseAt(0);
-      parent_page_new->InsertFirstOf(mid_page_id);
-      InsertInParent(parent_page_id, mid_key, parent_page_new_id, ctx);
+  page_id_t left_page_id = left_page_guard.PageId();
+  int level = left_page_guard.As<BPlusTreePage>()->GetLevel();
+
+  page_id_t parent_page_id = INVALID_PAGE_ID;
+  while (parent_page_id == INVALID_PAGE_ID) {
+    if (!ctx.access_set_.empty()) {
+      parent_page_id = ctx.access_set_.back();
+      ctx.access_set_.pop_back();
+      break;
+    }
+    auto header_page_guard = bpm_->FetchPageWrite(header_page_id_);
+    auto *header_page = header_page_guard.AsMut<BPlusTreeHeaderPage>();
+    if (header_page->root_page_id_ == left_page_id) {
+      // 分裂的是根节点，树长高一层
+      page_id_t root_page_new_id;
+      bpm_->NewPageGuarded(&root_page_new_id);
+      auto root_page_new_guard = bpm_->FetchPageWrite(root_page_new_id);
+      auto *root_page_new = root_page_new_guard.AsMut<BPlusTree::InternalPage>();
+      root_page_new->Init(internal_max_size_);
+      root_page_new->SetLevel(level + 1);
+      root_page_new->InsertFirstOf(left_page_id);
+      root_page_new->Insert(key, right_page_id, comparator_);
+      header_page->root_page_id_ = root_page_new_id;
+      ctx.root_page_id_ = root_page_new_id;
+      return;
     }
+    header_page_guard.Drop();
+    // 下降时它还是根，之后根被其他线程分裂了，从新的根重新找父亲那一层
+    parent_page_id = FindPageAtLevel(key, level + 1, ctx);
+    if (parent_page_id == INVALID_PAGE_ID) {
+      // 新的根还没有挂到header page上
+      std::this_thread::yield();
+    }
+  }
+
+  auto parent_page_guard = bpm_->FetchPageWrite(parent_page_id);
+  auto *parent_page = parent_page_guard.AsMut<BPlusTree::InternalPage>();
+  while (parent_page->NeedMoveRight(key, comparator_)) {
+    parent_page_id = parent_page->GetRightPageId();
+    parent_page_guard = bpm_->FetchPageWrite(parent_page_id);
+    parent_page = parent_page_guard.AsMut<BPlusTree::InternalPage>();
+  }
+  // 已经拿到父亲的写锁，可以放掉孩子
+  left_page_guard.Drop();
+
+  if (parent_page->GetSize() < parent_page->GetMaxSize()) {
+    // 够就直接插入
+    parent_page->Insert(key, right_page_id, comparator_);
+    return;
   }
+  // 内部节点split
+  int index = parent_page->Lookup(key, comparator_);
+  page_id_t parent_page_new_id;
+  bpm_->NewPageGuarded(&parent_page_new_id);
+  auto parent_page_new_guard = bpm_->FetchPageWrite(parent_page_new_id);
+  auto *parent_page_new = parent_page_new_guard.AsMut<BPlusTree::InternalPage>();
+  parent_page_new->Init(internal_max_size_);
+  parent_page_new->SetLevel(parent_page->GetLevel());
+  parent_page_new->SetRightPageId(parent_page->GetRightPageId());
+  parent_page_new->SetHighKey(parent_page->GetHighKey());
+  parent_page->MoveHalfTo(parent_page_new);
+  if (index > parent_page->GetMaxSize() / 2) {
+    parent_page_new->Insert(key, right_page_id, comparator_);
+  } else {
+    parent_page->Insert(key, right_page_id, comparator_);
+  }
+  KeyType mid_key = parent_page_new->KeyAt(1);
+  page_id_t mid_page_id = parent_page_new->ValueAt(1);
+  parent_page_new->EraseAt(1);
+  parent_page_new->EraseAt(0);
+  parent_page_new->InsertFirstOf(mid_page_id);
+  parent_page->SetRightPageId(parent_page_new_id);
+  parent_page->SetHighKey(mid_key);
+  parent_page_new_guard.Drop();
+  InsertInParent(std::move(parent_page_guard), mid_key, parent_page_new_id, ctx);
 }
 
 /*****************************************************************************
@@ -327,8 +341,45 @@ void BPLUSTREE_TYPE::InsertInParent(page_id_t leaf_page_left_id, KeyType key, pa
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
+  {
+    // 乐观删除：只锁叶子，不会引起合并或借节点时直接完成
+    std::shared_lock<std::shared_mutex> structure_guard(structure_latch_);
+    Context ctx;
+    page_id_t leaf_page_id = FindPageAtLevel(key, 0, ctx);
+    if (leaf_page_id == INVALID_PAGE_ID) {
+      return;
+    }
+    WritePageGuard leaf_page_guard = bpm_->FetchPageWrite(leaf_page_id);
+    auto *leaf_page = leaf_page_guard.AsMut<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+    while (leaf_page->NeedMoveRight(key, comparator_)) {
+      leaf_page_id = leaf_page->GetNextPageId();
+      leaf_page_guard = bpm_->FetchPageWrite(leaf_page_id);
+      leaf_page = leaf_page_guard.AsMut<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+    }
+    int index = leaf_page->Lookup(key, comparator_);
+    if (index >= leaf_page->GetSize() || comparator_(leaf_page->KeyAt(index), key) != 0) {
+      // key不存在
+      return;
+    }
+    // 没有右兄弟的根叶子从未分裂过，仍然是根
+    bool is_root = leaf_page_id == ctx.root_page_id_ && leaf_page->GetNextPageId() == INVALID_PAGE_ID;
+    if ((is_root && leaf_page->GetSize() > 1) || (!is_root && leaf_page->GetSize() - 1 >= leaf_page->GetMinSize())) {
+      leaf_page->RemoveAt(index);
+      return;
+    }
+    if (!is_root && enable_lazy_merge_) {
+      // 懒合并：只删除，页面太空时记下来交给后台线程合并
+      leaf_page->RemoveAt(index);
+      if (leaf_page->GetSize() < std::min(merge_threshold_.load(), leaf_page->GetMinSize())) {
+        std::scoped_lock<std::mutex> underfull_guard(underfull_latch_);
+        underfull_keys_.push_back(key);
+      }
+      return;
+    }
+  }
+  // 需要调整树的结构，独占整棵树后按原来的方式删除
+  std::unique_lock<std::shared_mutex> structure_guard(structure_latch_);
   Context ctx;
-  (void)ctx;
   page_id_t leaf_page_id = DeleteGetKeyAt(key, comparator_, ctx);
   if (ctx.root_page_id_ == INVALID_PAGE_ID) {
     return;
@@ -424,6 +475,17 @@ void BPLUSTREE_TYPE::RemoveEntry(page_id_t basic_page_id, const KeyType &key, Co
     // key不存在
     return;
   }
+  RebalancePage(std::move(basic_page_guard), basic_page_id, key, ctx);
+}
+
+/*
+ * Fix up basic page after it lost entries: shrink the root, or merge with / borrow
+ * from a sibling when the page is below its min size. key must route to basic page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RebalancePage(WritePageGuard basic_page_guard, page_id_t basic_page_id, const KeyType &key,
+                                   Context &ctx) {
+  auto *basic_page = basic_page_guard.AsMut<BPlusTreePage>();
   int root_page_id = ctx.root_page_id_;
   if (basic_page_id == root_page_id && basic_page->GetSize() == 0) {
     // 如果根节点为空，那么将根节点删除
@@ -470,11 +532,15 @@ void BPLUSTREE_TYPE::RemoveEntry(page_id_t basic_page_id, const KeyType &key, Co
         page_id_t mid_key_page_id = basic_internal_page->ValueAt(0);
         sibling_internal_page->Insert(mid_key, mid_key_page_id, comparator_);
         basic_internal_page->MoveAllTo(sibling_internal_page);
+        // 左边的页面接管右边页面的右链和high key
+        sibling_internal_page->SetRightPageId(basic_internal_page->GetRightPageId());
+        sibling_internal_page->SetHighKey(basic_internal_page->GetHighKey());
       } else {
         auto *basic_leaf_page = basic_page_guard.AsMut<BPlusTree::LeafPage>();
         auto *sibling_leaf_page = sibling_page_guard.AsMut<BPlusTree::LeafPage>();
         basic_leaf_page->MoveAllTo(sibling_leaf_page);
         sibling_leaf_page->SetNextPageId(basic_leaf_page->GetNextPageId());
+        sibling_leaf_page->SetHighKey(basic_leaf_page->GetHighKey());
       }
       ctx.write_set_.push_back(std::move(parent_page_guard));
       RemoveEntry(parent_page_id, mid_key, ctx);
@@ -494,12 +560,14 @@ void BPLUSTREE_TYPE::RemoveEntry(page_id_t basic_page_id, const KeyType &key, Co
           sibling_internal_page->EraseAt(0);
           sibling_internal_page->SetKeyAt(0, KeyType());
           ReplaceKeyAt(parent_page, mid_key, first_key, ctx);
+          basic_internal_page->SetHighKey(first_key);
         } else {
           auto *basic_leaf_page = basic_page_guard.AsMut<BPlusTree::LeafPage>();
           auto *sibling_leaf_page = sibling_page_guard.AsMut<BPlusTree::LeafPage>();
           sibling_leaf_page->MoveFirstToEndOf(basic_leaf_page);
           KeyType second_key = sibling_leaf_page->KeyAt(0);
           ReplaceKeyAt(parent_page, mid_key, second_key, ctx);
+          basic_leaf_page->SetHighKey(second_key);
         }
       } else {
         // 兄弟节点在自己的左边
@@ -514,6 +582,7 @@ void BPLUSTREE_TYPE::RemoveEntry(page_id_t basic_page_id, const KeyType &key, Co
           basic_internal_page->SetValueAt(0, last_page_id);
           basic_internal_page->Insert(mid_key, basic_pointer_page_id, comparator_);
           ReplaceKeyAt(parent_page, mid_key, last_key, ctx);
+          sibling_internal_page->SetHighKey(last_key);
         } else {
           auto *basic_leaf_page = basic_page_guard.AsMut<BPlusTree::LeafPage>();
           auto *sibling_leaf_page = sibling_page_guard.AsMut<BPlusTree::LeafPage>();
@@ -523,6 +592,7 @@ void BPLUSTREE_TYPE::RemoveEntry(page_id_t basic_page_id, const KeyType &key, Co
           sibling_leaf_page->RemoveAt(m);
           basic_leaf_page->Insert(last_key, last_value, comparator_);
           ReplaceKeyAt(parent_page, mid_key, last_key, ctx);
+          sibling_leaf_page->SetHighKey(last_key);
         }
       }
     }
@@ -537,6 +607,79 @@ void BPLUSTREE_TYPE::SetTreeEmpty(Context &ctx) {
   ctx.header_page_ = std::move(header_page);
 }
 
+/*****************************************************************************
+ * LAZY MERGE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartLazyMerge(int merge_threshold) {
+  if (merge_thread_ != nullptr) {
+    return;
+  }
+  merge_threshold_ = merge_threshold;
+  enable_lazy_merge_ = true;
+  merge_thread_ = new std::thread(&BPlusTree::RunLazyMerge, this);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StopLazyMerge() {
+  {
+    std::scoped_lock<std::mutex> underfull_guard(underfull_latch_);
+    enable_lazy_merge_ = false;
+  }
+  merge_cv_.notify_all();
+  if (merge_thread_ != nullptr) {
+    merge_thread_->join();
+    delete merge_thread_;
+    merge_thread_ = nullptr;
+  }
+  CompactUnderfullPages();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RunLazyMerge() {
+  while (enable_lazy_merge_) {
+    {
+      std::unique_lock<std::mutex> underfull_guard(underfull_latch_);
+      if (merge_cv_.wait_for(underfull_guard, b_plus_tree_merge_interval, [&] { return !enable_lazy_merge_; })) {
+        break;
+      }
+    }
+    CompactUnderfullPages();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CompactUnderfullPages() {
+  std::vector<KeyType> underfull_keys;
+  {
+    std::scoped_lock<std::mutex> underfull_guard(underfull_latch_);
+    underfull_keys.swap(underfull_keys_);
+  }
+  if (underfull_keys.empty()) {
+    return;
+  }
+  std::unique_lock<std::shared_mutex> structure_guard(structure_latch_);
+  for (const auto &key : underfull_keys) {
+    // 重新从根往下找，叶子可能已经被之前的合并处理过或被插入重新填满
+    Context ctx;
+    page_id_t leaf_page_id = DeleteGetKeyAt(key, comparator_, ctx);
+    if (ctx.root_page_id_ == INVALID_PAGE_ID) {
+      return;
+    }
+    WritePageGuard leaf_page_guard = std::move(ctx.write_set_.back());
+    ctx.write_set_.pop_back();
+    const auto *leaf_page = leaf_page_guard.As<LeafPage>();
+    if (leaf_page_id == ctx.root_page_id_) {
+      if (leaf_page->GetSize() > 0) {
+        continue;
+      }
+    } else if (leaf_page->GetSize() >= std::min(merge_threshold_.load(), leaf_page->GetMinSize())) {
+      continue;
+    }
+    RebalancePage(std::move(leaf_page_guard), leaf_page_id, key, ctx);
+  }
+}
+
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -562,7 +705,10 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
     }
   }
   auto *leaf_page = root_page_guard.As<BPlusTree::LeafPage>();
-  return INDEXITERATOR_TYPE(bpm_, leaf_page, 0, std::move(root_page_guard));
+  // 懒合并时最左边的叶子可能是空的，从-1开始前进一步跳过空叶子
+  INDEXITERATOR_TYPE iterator(bpm_, leaf_page, -1, std::move(root_page_guard));
+  ++iterator;
+  return iterator;
 }
 
 /*
@@ -572,18 +718,20 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  std::shared_lock<std::shared_mutex> structure_guard(structure_latch_);
   Context ctx;
-  (void)ctx;
-  auto page_id = GetKeyAt(key, comparator_, ctx);
-  ctx.read_set_.clear();
+  auto page_id = FindPageAtLevel(key, 0, ctx);
   if (page_id == INVALID_PAGE_ID) {
     return INDEXITERATOR_TYPE();
   }
   BasicPageGuard leaf_page_guard = bpm_->FetchPageBasic(page_id);
-  ctx.read_set_.pop_back();
   const auto *leaf_page = leaf_page_guard.As<BPlusTree::LeafPage>();
+  while (leaf_page->NeedMoveRight(key, comparator_)) {
+    leaf_page_guard = bpm_->FetchPageBasic(leaf_page->GetNextPageId());
+    leaf_page = leaf_page_guard.As<BPlusTree::LeafPage>();
+  }
   int index = leaf_page->Lookup(key, comparator_);
-  if (comparator_(leaf_page->KeyAt(index), key) != 0) {
+  if (index >= leaf_page->GetSize() || comparator_(leaf_page->KeyAt(index), key) != 0) {
     return INDEXITERATOR_TYPE();
   }
   return INDEXITERATOR_TYPE(bpm_, leaf_page, index, std::move(leaf_page_guard));
@@ -40,19 +40,20 @@ auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return page_->GetO
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
-  if (index_ + 1 >= page_->GetSize()) {
+  index_++;
+  // 跳过空叶子（懒合并下被删空但还没合并的页面）
+  while (index_ >= page_->GetSize()) {
     page_id_t next_page_id = page_->GetNextPageId();
-    if (next_page_id != INVALID_PAGE_ID) {
-      page_guard_ = bpm_->FetchPageBasic(next_page_id);
-      page_ = page_guard_.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
-      index_ = 0;
-    } else {
+    if (next_page_id == INVALID_PAGE_ID) {
       page_ = nullptr;
       index_ = -1;
       bpm_ = nullptr;
+      page_guard_ = BasicPageGuard();
+      break;
     }
-  } else {
-    index_++;
+    page_guard_ = bpm_->FetchPageBasic(next_page_id);
+    page_ = page_guard_.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+    index_ = 0;
   }
   return *this;
 }
@@ -21,10 +21,17 @@ namespace bustub {
  *****************************************************************************/
 /*
  * Init method after creating a new internal page
- * Including set page type, set current size, and set max page size
+ * Including set page type, set current size, set max page size and clear the right link.
+ * The level defaults to 1 and must be adjusted by the caller for higher pages.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) { SetMaxSize(max_size); }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetMaxSize(max_size);
+  SetSize(0);
+  SetLevel(1);
+  SetRightPageId(INVALID_PAGE_ID);
+}
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
@@ -151,6 +158,32 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyCompara
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetRightPageId() const -> page_id_t { return right_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetRightPageId(page_id_t right_page_id) { right_page_id_ = right_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetHighKey() const -> KeyType { return high_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetHighKey(const KeyType &high_key) { high_key_ = high_key; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::NeedMoveRight(const KeyType &key, const KeyComparator &comparator) const -> bool {
+  return right_page_id_ != INVALID_PAGE_ID && comparator(key, high_key_) >= 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ChildFor(const KeyType &key, const KeyComparator &comparator) const -> ValueType {
+  int i = Lookup(key, comparator);
+  if (i != GetSize() && comparator(key, KeyAt(i)) == 0) {
+    return ValueAt(i);
+  }
+  return ValueAt(i - 1);
+}
+
 // 查找index对应的value
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetValue(int index) const -> page_id_t {
@@ -48,4 +48,10 @@ auto BPlusTreePage::GetMinSize() const -> int {
   return 0;
 }
 
+/*
+ * Helper methods to get/set the level of the page, leaf pages are at level 0
+ */
+auto BPlusTreePage::GetLevel() const -> int { return level_; }
+void BPlusTreePage::SetLevel(int level) { level_ = level; }
+
 }  // namespace bustub
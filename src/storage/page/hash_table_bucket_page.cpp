@@ -10,6 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
 #include "storage/page/hash_table_bucket_page.h"
 #include "common/logger.h"
 #include "common/util/hash_util.h"
@@ -20,62 +27,176 @@
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
-  return false;
+void HASH_TABLE_BUCKET_TYPE::Init() {
+  next_page_id_ = INVALID_PAGE_ID;
+  memset(occupied_, 0, sizeof(occupied_));
+  memset(readable_, 0, sizeof(readable_));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+auto HASH_TABLE_BUCKET_TYPE::NumOccupied() const -> uint32_t {
+  uint32_t num = 0;
+  for (char byte : occupied_) {
+    auto bits = static_cast<unsigned char>(byte);
+    if (bits != 0xFF) {
+      return num + __builtin_ctz(~static_cast<uint32_t>(bits));
+    }
+    num += 8;
+  }
+  return BUCKET_ARRAY_SIZE;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::MatchFingerprint(uint8_t fingerprint, uint32_t base) const -> uint32_t {
+  uint32_t mask = 0;
+#ifdef __SSE2__
+  if (base + 16 <= BUCKET_ARRAY_SIZE) {
+    __m128i needle = _mm_set1_epi8(static_cast<char>(fingerprint));
+    __m128i tags = _mm_loadu_si128(reinterpret_cast<const __m128i *>(fingerprints_ + base));
+    mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(needle, tags)));
+  } else  // NOLINT
+#endif
+  {
+    for (uint32_t i = 0; i < 16 && base + i < BUCKET_ARRAY_SIZE; i++) {
+      mask |= static_cast<uint32_t>(fingerprints_[base + i] == fingerprint) << i;
+    }
+  }
+  // base是16的倍数，对应readable_里的两个字节
+  uint32_t readable = static_cast<unsigned char>(readable_[base / 8]);
+  if (base / 8 + 1 < sizeof(readable_)) {
+    readable |= static_cast<uint32_t>(static_cast<unsigned char>(readable_[base / 8 + 1])) << 8;
+  }
+  return mask & readable;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, uint8_t fingerprint, KeyComparator cmp,
+                                      std::vector<ValueType> *result) -> bool {
+  static_assert(sizeof(HashTableBucketPage) + (BUCKET_ARRAY_SIZE - 1) * sizeof(MappingType) <= BUSTUB_PAGE_SIZE,
+                "bucket page does not fit in a page");
+  bool found = false;
+  uint32_t num_occupied = NumOccupied();
+  for (uint32_t base = 0; base < num_occupied; base += 16) {
+    // 只有指纹相同的槽才去比较完整的key
+    for (uint32_t mask = MatchFingerprint(fingerprint, base); mask != 0; mask &= mask - 1) {
+      uint32_t bucket_idx = base + __builtin_ctz(mask);
+      if (cmp(key, array_[bucket_idx].first) == 0) {
+        result->push_back(array_[bucket_idx].second);
+        found = true;
+      }
+    }
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, uint8_t fingerprint, KeyComparator cmp) -> bool {
+  uint32_t num_occupied = NumOccupied();
+  for (uint32_t base = 0; base < num_occupied; base += 16) {
+    for (uint32_t mask = MatchFingerprint(fingerprint, base); mask != 0; mask &= mask - 1) {
+      uint32_t bucket_idx = base + __builtin_ctz(mask);
+      if (cmp(key, array_[bucket_idx].first) == 0 && array_[bucket_idx].second == value) {
+        // 不允许重复的键值对
+        return false;
+      }
+    }
+  }
+  // 优先复用墓碑，否则用第一个没被占用过的槽
+  uint32_t free_idx = num_occupied;
+  for (uint32_t bucket_idx = 0; bucket_idx < num_occupied; bucket_idx += 8) {
+    auto bits = static_cast<unsigned char>(readable_[bucket_idx / 8]);
+    if (bits != 0xFF) {
+      free_idx = std::min(num_occupied, bucket_idx + __builtin_ctz(~static_cast<uint32_t>(bits)));
+      break;
+    }
+  }
+  if (free_idx == BUCKET_ARRAY_SIZE) {
+    return false;
+  }
+  array_[free_idx] = MappingType(key, value);
+  fingerprints_[free_idx] = fingerprint;
+  SetOccupied(free_idx);
+  SetReadable(free_idx);
   return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, uint8_t fingerprint, KeyComparator cmp) -> bool {
+  uint32_t num_occupied = NumOccupied();
+  for (uint32_t base = 0; base < num_occupied; base += 16) {
+    for (uint32_t mask = MatchFingerprint(fingerprint, base); mask != 0; mask &= mask - 1) {
+      uint32_t bucket_idx = base + __builtin_ctz(mask);
+      if (cmp(key, array_[bucket_idx].first) == 0 && array_[bucket_idx].second == value) {
+        RemoveAt(bucket_idx);
+        return true;
+      }
+    }
+  }
   return false;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::KeyAt(uint32_t bucket_idx) const -> KeyType {
-  return {};
+  return array_[bucket_idx].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::ValueAt(uint32_t bucket_idx) const -> ValueType {
-  return {};
+  return array_[bucket_idx].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {}
+auto HASH_TABLE_BUCKET_TYPE::FingerprintAt(uint32_t bucket_idx) const -> uint8_t {
+  return fingerprints_[bucket_idx];
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] &= ~(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsOccupied(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (occupied_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {
+  occupied_[bucket_idx / 8] |= 1 << (bucket_idx % 8);
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsReadable(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (readable_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] |= 1 << (bucket_idx % 8);
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsFull() -> bool {
-  return false;
+  return NumReadable() == BUCKET_ARRAY_SIZE;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::NumReadable() -> uint32_t {
-  return 0;
+  uint32_t num = 0;
+  for (char byte : readable_) {
+    num += __builtin_popcount(static_cast<unsigned char>(byte));
+  }
+  return num;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsEmpty() -> bool {
-  return false;
+  for (char byte : readable_) {
+    if (byte != 0) {
+      return false;
+    }
+  }
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.cpp
+//
+// Identification: src/storage/page/pax_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/pax_page.h"
+
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+auto PaxPage::SupportsSchema(const Schema &schema) -> bool {
+  // 字典编码的列虽然是定长的，列扫描却读不了编码
+  for (const auto &col : schema.GetColumns()) {
+    if (col.GetDictionary() != nullptr) {
+      return false;
+    }
+  }
+  return schema.GetUnlinedColumns().empty() && schema.GetColumnCount() > 0;
+}
+
+auto PaxPage::Capacity(const Schema &schema) -> uint16_t {
+  return (BUSTUB_PAGE_SIZE - PAX_PAGE_HEADER_SIZE) / (TUPLE_META_SIZE + schema.GetLength());
+}
+
+void PaxPage::Init(const Schema &schema) {
+  next_page_id_ = INVALID_PAGE_ID;
+  num_tuples_ = 0;
+  capacity_ = Capacity(schema);
+}
+
+auto PaxPage::ColumnData(const Schema &schema, uint32_t column_idx) const -> const char * {
+  return data_ + capacity_ * (TUPLE_META_SIZE + schema.GetColumn(column_idx).GetOffset());
+}
+
+auto PaxPage::ColumnData(const Schema &schema, uint32_t column_idx) -> char * {
+  return data_ + capacity_ * (TUPLE_META_SIZE + schema.GetColumn(column_idx).GetOffset());
+}
+
+auto PaxPage::InsertTuple(const Schema &schema, const TupleMeta &meta, const Tuple &tuple)
+    -> std::optional<uint16_t> {
+  if (num_tuples_ == capacity_) {
+    return std::nullopt;
+  }
+  uint16_t tuple_id = num_tuples_++;
+  Metas()[tuple_id] = meta;
+  UpdateTuple(schema, meta, tuple, RID{INVALID_PAGE_ID, tuple_id});
+  return tuple_id;
+}
+
+auto PaxPage::GetTuple(const Schema &schema, const RID &rid) const -> std::pair<TupleMeta, Tuple> {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  // 各列拼回行存格式，定长schema里列的偏移就是它在tuple里的位置
+  Tuple tuple;
+  tuple.data_.Resize(schema.GetLength());
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &col = schema.GetColumn(i);
+    memcpy(tuple.data_.Data() + col.GetOffset(), ColumnData(schema, i) + tuple_id * col.GetFixedLength(),
+           col.GetFixedLength());
+  }
+  tuple.rid_ = rid;
+  return std::make_pair(Metas()[tuple_id], std::move(tuple));
+}
+
+auto PaxPage::GetTupleMeta(const RID &rid) const -> TupleMeta {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  return Metas()[tuple_id];
+}
+
+void PaxPage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  Metas()[tuple_id] = meta;
+}
+
+void PaxPage::UpdateTuple(const Schema &schema, const TupleMeta &meta, const Tuple &tuple, const RID &rid) {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  if (tuple.GetLength() != schema.GetLength()) {
+    throw bustub::Exception("Tuple size mismatch");
+  }
+  Metas()[tuple_id] = meta;
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &col = schema.GetColumn(i);
+    memcpy(ColumnData(schema, i) + tuple_id * col.GetFixedLength(), tuple.GetData() + col.GetOffset(),
+           col.GetFixedLength());
+  }
+}
+
+void PaxPage::ReadColumn(const Schema &schema, uint32_t column_idx, std::vector<Value> *out) const {
+  const auto &col = schema.GetColumn(column_idx);
+  const char *data = ColumnData(schema, column_idx);
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    if (!Metas()[tuple_id].is_deleted_) {
+      out->push_back(Value::DeserializeFrom(data + tuple_id * col.GetFixedLength(), col.GetType()));
+    }
+  }
+}
+
+}  // namespace bustub
@@ -12,12 +12,16 @@
 
 #include "storage/page/table_page.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <optional>
 #include <tuple>
+#include <vector>
+
 #include "common/config.h"
 #include "common/exception.h"
+#include "common/macros.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -26,36 +30,122 @@ void TablePage::Init() {
   next_page_id_ = INVALID_PAGE_ID;
   num_tuples_ = 0;
   num_deleted_tuples_ = 0;
+  tuple_start_ = BUSTUB_PAGE_SIZE;
+  num_free_slots_ = 0;
 }
 
 auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t> {
-  size_t slot_end_offset;
-  if (num_tuples_ > 0) {
-    auto &[offset, size, meta] = tuple_info_[num_tuples_ - 1];
-    slot_end_offset = offset;
-  } else {
-    slot_end_offset = BUSTUB_PAGE_SIZE;
+  if (tuple.GetLength() > tuple_start_) {
+    return std::nullopt;
   }
-  auto tuple_offset = slot_end_offset - tuple.GetLength();
-  auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * (num_tuples_ + 1);
+  auto tuple_offset = tuple_start_ - tuple.GetLength();
+  // 有空闲槽位就复用，不用再占一个TupleInfo
+  auto num_slots = num_free_slots_ > 0 ? num_tuples_ : num_tuples_ + 1;
+  auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * num_slots;
   if (tuple_offset < offset_size) {
     return std::nullopt;
   }
   return tuple_offset;
 }
 
-auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t> {
+auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple, bool is_moved) -> std::optional<uint16_t> {
   auto tuple_offset = GetNextTupleOffset(meta, tuple);
   if (tuple_offset == std::nullopt) {
     return std::nullopt;
   }
-  auto tuple_id = num_tuples_;
-  tuple_info_[tuple_id] = std::make_tuple(*tuple_offset, tuple.GetLength(), meta);
-  num_tuples_++;
-  memcpy(page_start_ + *tuple_offset, tuple.data_.data(), tuple.GetLength());
+  uint16_t tuple_id = num_tuples_;
+  if (num_free_slots_ > 0) {
+    tuple_id = 0;
+    while (!IsFreeSlot(tuple_info_[tuple_id])) {
+      tuple_id++;
+    }
+    num_free_slots_--;
+  } else {
+    num_tuples_++;
+  }
+  uint16_t flags = is_moved ? TUPLE_MOVED : 0;
+  tuple_info_[tuple_id] = std::make_tuple(*tuple_offset, tuple.GetLength() | flags, meta);
+  tuple_start_ = *tuple_offset;
+  memcpy(page_start_ + *tuple_offset, tuple.data_.Data(), tuple.GetLength());
   return tuple_id;
 }
 
+auto TablePage::GetFreeSpace() const -> uint32_t {
+  auto num_slots = num_free_slots_ > 0 ? num_tuples_ : num_tuples_ + 1;
+  auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * num_slots;
+  return tuple_start_ > offset_size ? tuple_start_ - offset_size : 0;
+}
+
+auto TablePage::ContiguousFreeSpace() const -> size_t {
+  return tuple_start_ - (TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * num_tuples_);
+}
+
+auto TablePage::Vacuum() -> uint32_t {
+  uint32_t freed = 0;
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    if (IsFreeSlot(tuple_info_[tuple_id])) {
+      continue;
+    }
+    if (std::get<2>(tuple_info_[tuple_id]).is_deleted_) {
+      // 转发和搬迁标记一起清掉
+      tuple_info_[tuple_id] = std::make_tuple(0, 0, TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true});
+      freed++;
+    }
+  }
+  num_free_slots_ += freed;
+  num_deleted_tuples_ = 0;
+  Compact();
+  return freed;
+}
+
+void TablePage::Compact() {
+  std::vector<uint16_t> live;
+  live.reserve(num_tuples_);
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    if ((std::get<1>(tuple_info_[tuple_id]) & TUPLE_SIZE_MASK) > 0) {
+      live.push_back(tuple_id);
+    }
+  }
+  // 从偏移最大的tuple开始往页尾挪，目标位置只会更靠后，不会覆盖还没挪的数据
+  std::sort(live.begin(), live.end(),
+            [this](uint16_t a, uint16_t b) { return std::get<0>(tuple_info_[a]) > std::get<0>(tuple_info_[b]); });
+  size_t end = BUSTUB_PAGE_SIZE;
+  for (auto tuple_id : live) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    auto len = size & TUPLE_SIZE_MASK;
+    end -= len;
+    if (offset != end) {
+      memmove(page_start_ + end, page_start_ + offset, len);
+      offset = end;
+    }
+  }
+  tuple_start_ = end;
+}
+
+auto TablePage::Allocate(size_t len, std::optional<uint16_t> skip_id) -> std::optional<uint16_t> {
+  if (ContiguousFreeSpace() >= len) {
+    tuple_start_ -= len;
+    return tuple_start_;
+  }
+  // 连续空间不够，看算上碎片够不够，够的话整理一遍
+  size_t used = 0;
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    if (tuple_id != skip_id) {
+      used += std::get<1>(tuple_info_[tuple_id]) & TUPLE_SIZE_MASK;
+    }
+  }
+  if (TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * num_tuples_ + used + len > BUSTUB_PAGE_SIZE) {
+    return std::nullopt;
+  }
+  if (skip_id.has_value()) {
+    auto &size = std::get<1>(tuple_info_[*skip_id]);
+    size &= ~TUPLE_SIZE_MASK;
+  }
+  Compact();
+  tuple_start_ -= len;
+  return tuple_start_;
+}
+
 void TablePage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
   auto tuple_id = rid.GetSlotNum();
   if (tuple_id >= num_tuples_) {
@@ -74,13 +164,22 @@ auto TablePage::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
     throw bustub::Exception("Tuple ID out of range");
   }
   auto &[offset, size, meta] = tuple_info_[tuple_id];
+  auto len = size & TUPLE_SIZE_MASK;
   Tuple tuple;
-  tuple.data_.resize(size);
-  memmove(tuple.data_.data(), page_start_ + offset, size);
+  tuple.data_.Assign(page_start_ + offset, page_start_ + offset + len);
   tuple.rid_ = rid;
   return std::make_pair(meta, std::move(tuple));
 }
 
+auto TablePage::GetTupleView(const RID &rid) const -> std::pair<TupleMeta, TupleView> {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &[offset, size, meta] = tuple_info_[tuple_id];
+  return std::make_pair(meta, TupleView(page_start_ + offset, size & TUPLE_SIZE_MASK, rid));
+}
+
 auto TablePage::GetTupleMeta(const RID &rid) const -> TupleMeta {
   auto tuple_id = rid.GetSlotNum();
   if (tuple_id >= num_tuples_) {
@@ -96,14 +195,73 @@ void TablePage::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tup
     throw bustub::Exception("Tuple ID out of range");
   }
   auto &[offset, size, old_meta] = tuple_info_[tuple_id];
-  if (size != tuple.GetLength()) {
+  if ((size & TUPLE_FORWARDED) != 0) {
+    throw bustub::Exception("Tuple is forwarded");
+  }
+  if ((size & TUPLE_SIZE_MASK) != tuple.GetLength()) {
     throw bustub::Exception("Tuple size mismatch");
   }
   if (!old_meta.is_deleted_ && meta.is_deleted_) {
     num_deleted_tuples_++;
   }
   tuple_info_[tuple_id] = std::make_tuple(offset, size, meta);
-  memcpy(page_start_ + offset, tuple.data_.data(), tuple.GetLength());
+  memcpy(page_start_ + offset, tuple.data_.Data(), tuple.GetLength());
+}
+
+auto TablePage::UpdateTupleInPlace(const TupleMeta &meta, const Tuple &tuple, const RID &rid) -> bool {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &[offset, size, old_meta] = tuple_info_[tuple_id];
+  uint16_t flags = size & TUPLE_MOVED;
+  auto len = tuple.GetLength();
+  // 变短或者等长直接覆盖，变长就在页内另找地方
+  auto new_offset = len <= (size & TUPLE_SIZE_MASK) ? std::make_optional(offset) : Allocate(len, tuple_id);
+  if (new_offset == std::nullopt) {
+    return false;
+  }
+  if (!old_meta.is_deleted_ && meta.is_deleted_) {
+    num_deleted_tuples_++;
+  }
+  tuple_info_[tuple_id] = std::make_tuple(*new_offset, len | flags, meta);
+  memcpy(page_start_ + *new_offset, tuple.data_.Data(), len);
+  return true;
+}
+
+auto TablePage::GetForward(const RID &rid) const -> std::optional<RID> {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &[offset, size, meta] = tuple_info_[tuple_id];
+  if ((size & TUPLE_FORWARDED) == 0) {
+    return std::nullopt;
+  }
+  int64_t target;
+  memcpy(&target, page_start_ + offset, sizeof(target));
+  return RID(target);
+}
+
+void TablePage::SetForward(const TupleMeta &meta, const RID &rid, const RID &target) {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &[offset, size, old_meta] = tuple_info_[tuple_id];
+  int64_t data = target.Get();
+  auto new_offset =
+      (size & TUPLE_SIZE_MASK) >= sizeof(data) ? std::make_optional(offset) : Allocate(sizeof(data), tuple_id);
+  BUSTUB_ENSURE(new_offset.has_value(), "no room for the forwarding pointer");
+  if (!old_meta.is_deleted_ && meta.is_deleted_) {
+    num_deleted_tuples_++;
+  }
+  tuple_info_[tuple_id] = std::make_tuple(*new_offset, sizeof(data) | TUPLE_FORWARDED, meta);
+  memcpy(page_start_ + *new_offset, &data, sizeof(data));
+}
+
+auto TablePage::IsMovedTuple(uint32_t tuple_id) const -> bool {
+  return tuple_id < num_tuples_ && (std::get<1>(tuple_info_[tuple_id]) & TUPLE_MOVED) != 0;
 }
 
 }  // namespace bustub
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// trie_node_page.cpp
+//
+// Identification: src/storage/page/trie_node_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/trie_node_page.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void TrieNodePage::Init(std::string_view prefix, const std::string_view *value,
+                        const std::vector<std::pair<char, page_id_t>> &children) {
+  BUSTUB_ASSERT(prefix.size() <= DISK_TRIE_MAX_KEY_SIZE, "prefix too long");
+  BUSTUB_ASSERT(value == nullptr || value->size() <= DISK_TRIE_MAX_VALUE_SIZE, "value too long");
+  has_value_ = value != nullptr ? 1 : 0;
+  unused_ = 0;
+  num_children_ = children.size();
+  prefix_len_ = prefix.size();
+  value_len_ = value != nullptr ? value->size() : 0;
+  for (size_t i = 0; i < children.size(); i++) {
+    keys_[i] = children[i].first;
+    children_[i] = children[i].second;
+  }
+  memcpy(data_, prefix.data(), prefix_len_);
+  if (value != nullptr) {
+    memcpy(data_ + prefix_len_, value->data(), value_len_);
+  }
+}
+
+auto TrieNodePage::GetPrefix() const -> std::string_view { return {data_, prefix_len_}; }
+
+auto TrieNodePage::HasValue() const -> bool { return has_value_ != 0; }
+
+auto TrieNodePage::GetValue() const -> std::string_view { return {data_ + prefix_len_, value_len_}; }
+
+auto TrieNodePage::GetNumChildren() const -> uint32_t { return num_children_; }
+
+auto TrieNodePage::KeyAt(uint32_t index) const -> char { return keys_[index]; }
+
+auto TrieNodePage::ChildAt(uint32_t index) const -> page_id_t { return children_[index]; }
+
+auto TrieNodePage::FindChild(char c) const -> page_id_t {
+  // keys_按无符号字节有序，二分查找
+  const char *end = keys_ + num_children_;
+  const char *it = std::lower_bound(keys_, end, c, [](char a, char b) {
+    return static_cast<unsigned char>(a) < static_cast<unsigned char>(b);
+  });
+  if (it == end || *it != c) {
+    return INVALID_PAGE_ID;
+  }
+  return children_[it - keys_];
+}
+
+}  // namespace bustub
@@ -0,0 +1,47 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_iterator.cpp
+//
+// Identification: src/storage/table/column_iterator.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/column_iterator.h"
+
+#include "storage/page/pax_page.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+auto ColumnIterator::Next(ColumnBatch *batch) -> bool {
+  if (!started_) {
+    page_id_ = table_heap_->GetFirstPageId();
+    started_ = true;
+  }
+  if (page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  auto page_guard = table_heap_->bpm_->FetchPageRead(page_id_);
+  const auto *page = page_guard.As<PaxPage>();
+  const auto &schema = *table_heap_->schema_;
+
+  batch->rids_.clear();
+  for (uint32_t slot_num = 0; slot_num < page->GetNumTuples(); slot_num++) {
+    RID rid{page_id_, slot_num};
+    if (!page->GetTupleMeta(rid).is_deleted_) {
+      batch->rids_.push_back(rid);
+    }
+  }
+  batch->columns_.resize(column_ids_.size());
+  for (size_t i = 0; i < column_ids_.size(); i++) {
+    batch->columns_[i].clear();
+    batch->columns_[i].reserve(batch->rids_.size());
+    page->ReadColumn(schema, column_ids_[i], &batch->columns_[i]);
+  }
+  page_id_ = page->GetNextPageId();
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void FreeSpaceMap::Update(page_id_t page_id, uint32_t free_bytes) {
+  uint32_t category = std::min(free_bytes / FSM_CATEGORY_SIZE, FSM_NUM_CATEGORIES - 1);
+  auto it = category_.find(page_id);
+  if (it != category_.end()) {
+    if (it->second == category) {
+      return;
+    }
+    pages_[it->second].erase(page_id);
+    it->second = category;
+  } else {
+    category_.emplace(page_id, category);
+  }
+  pages_[category].insert(page_id);
+}
+
+void FreeSpaceMap::Remove(page_id_t page_id) {
+  auto it = category_.find(page_id);
+  if (it != category_.end()) {
+    pages_[it->second].erase(page_id);
+    category_.erase(it);
+  }
+}
+
+auto FreeSpaceMap::Find(uint32_t tuple_size) const -> page_id_t {
+  // 向上取整，保证找到的页面一定放得下
+  uint32_t needed = (tuple_size + FSM_CATEGORY_SIZE - 1) / FSM_CATEGORY_SIZE;
+  page_id_t result = INVALID_PAGE_ID;
+  for (uint32_t category = needed; category < FSM_NUM_CATEGORIES; category++) {
+    if (!pages_[category].empty() && (result == INVALID_PAGE_ID || *pages_[category].begin() < result)) {
+      result = *pages_[category].begin();
+    }
+  }
+  return result;
+}
+
+}  // namespace bustub
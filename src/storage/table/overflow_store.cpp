@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_store.cpp
+//
+// Identification: src/storage/table/overflow_store.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/overflow_store.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/macros.h"
+#include "storage/page/overflow_page.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+auto OverflowStore::Write(const char *data, uint32_t len) const -> page_id_t {
+  // 从最后一段往前写，每页创建时就知道下一页
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  auto num_pages = std::max<uint32_t>(1, (len + OVERFLOW_PAGE_DATA_SIZE - 1) / OVERFLOW_PAGE_DATA_SIZE);
+  for (auto i = num_pages; i > 0; i--) {
+    uint32_t begin = (i - 1) * OVERFLOW_PAGE_DATA_SIZE;
+    uint32_t size = std::min<uint32_t>(len - begin, OVERFLOW_PAGE_DATA_SIZE);
+    page_id_t page_id;
+    auto guard = bpm_->NewPageGuarded(&page_id);
+    BUSTUB_ENSURE(page_id != INVALID_PAGE_ID, "cannot allocate page");
+    auto page = guard.AsMut<OverflowPage>();
+    page->Init(next_page_id, size);
+    memcpy(page->GetData(), data + begin, size);
+    next_page_id = page_id;
+  }
+  return next_page_id;
+}
+
+auto OverflowStore::Read(page_id_t first_page_id, uint32_t len) const -> std::vector<char> {
+  std::vector<char> data(len);
+  uint32_t offset = 0;
+  for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    auto guard = bpm_->FetchPageRead(page_id);
+    auto page = guard.As<OverflowPage>();
+    BUSTUB_ENSURE(offset + page->GetDataSize() <= len, "overflow chain longer than the value");
+    memcpy(data.data() + offset, page->GetData(), page->GetDataSize());
+    offset += page->GetDataSize();
+    page_id = page->GetNextPageId();
+  }
+  BUSTUB_ENSURE(offset == len, "overflow chain shorter than the value");
+  return data;
+}
+
+void OverflowStore::Free(page_id_t first_page_id) const {
+  for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    auto guard = bpm_->FetchPageRead(page_id);
+    auto next_page_id = guard.As<OverflowPage>()->GetNextPageId();
+    guard.Drop();
+    bpm_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+}  // namespace bustub
@@ -11,8 +11,11 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <functional>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -21,86 +24,231 @@
 #include "concurrency/transaction.h"
 #include "fmt/format.h"
 #include "storage/page/page_guard.h"
+#include "storage/page/pax_page.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
-TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
+TableHeap::TableHeap(BufferPoolManager *bpm, const Schema *schema, TableFormat format)
+    : bpm_(bpm), format_(format), overflow_(bpm) {
+  if (schema != nullptr) {
+    schema_.emplace(*schema);
+    zone_map_.emplace(*schema);
+  }
+  if (format_ == TableFormat::Pax && (schema == nullptr || !PaxPage::SupportsSchema(*schema))) {
+    throw NotImplementedException("PAX tables only support fixed-length columns");
+  }
   // Initialize the first table page.
   auto guard = bpm->NewPageGuarded(&first_page_id_);
   last_page_id_ = first_page_id_;
-  auto first_page = guard.AsMut<TablePage>();
-  BUSTUB_ASSERT(first_page != nullptr,
+  BUSTUB_ASSERT(first_page_id_ != INVALID_PAGE_ID,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
+  if (zone_map_.has_value()) {
+    zone_map_->AddPage(first_page_id_, INVALID_PAGE_ID);
+  }
+  if (format_ == TableFormat::Pax) {
+    guard.AsMut<PaxPage>()->Init(*schema_);
+    return;
+  }
+  auto first_page = guard.AsMut<TablePage>();
   first_page->Init();
+  fsm_.Update(first_page_id_, first_page->GetFreeSpace());
 }
 
 auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr, Transaction *txn,
                             table_oid_t oid) -> std::optional<RID> {
-  std::unique_lock<std::mutex> guard(latch_);
-  auto page_guard = bpm_->FetchPageWrite(last_page_id_);
-  while (true) {
-    auto page = page_guard.AsMut<TablePage>();
-    if (page->GetNextTupleOffset(meta, tuple) != std::nullopt) {
-      break;
-    }
-
-    // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
-    BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
+  auto rid =
+      format_ == TableFormat::Pax ? InsertIntoPaxPage(meta, tuple) : InsertIntoSlot(meta, PrepareTuple(tuple), false);
+  if (zone_map_.has_value()) {
+    zone_map_->Update(rid.GetPageId(), tuple);
+  }
 
-    page_id_t next_page_id = INVALID_PAGE_ID;
-    auto npg = bpm_->NewPage(&next_page_id);
-    BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
+  if (lock_mgr != nullptr) {
+    BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, rid),
+                  "failed to lock when inserting new tuple");
+  }
 
-    page->SetNextPageId(next_page_id);
+  return rid;
+}
 
-    auto next_page = reinterpret_cast<TablePage *>(npg->GetData());
-    next_page->Init();
+auto TableHeap::InsertIntoPaxPage(const TupleMeta &meta, const Tuple &tuple) -> RID {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto page_guard = bpm_->FetchPageWrite(last_page_id_);
+  if (auto slot_id = page_guard.AsMut<PaxPage>()->InsertTuple(*schema_, meta, tuple); slot_id.has_value()) {
+    return {last_page_id_, *slot_id};
+  }
+  page_id_t page_id;
+  auto new_page_guard = bpm_->NewPageGuarded(&page_id);
+  BUSTUB_ENSURE(page_id != INVALID_PAGE_ID, "cannot allocate page");
+  auto new_page = new_page_guard.AsMut<PaxPage>();
+  new_page->Init(*schema_);
+  auto slot_id = new_page->InsertTuple(*schema_, meta, tuple);
+  BUSTUB_ENSURE(slot_id.has_value(), "tuple is too large, cannot insert");
+  page_guard.AsMut<PaxPage>()->SetNextPageId(page_id);
+  zone_map_->AddPage(page_id, last_page_id_);
+  last_page_id_ = page_id;
+  return {page_id, *slot_id};
+}
 
-    page_guard.Drop();
+auto TableHeap::PrepareTuple(const Tuple &tuple) -> Tuple {
+  // 从堆里读出来的tuple可能带着溢出页的引用，也要重新写一份，不能和原tuple共用溢出页
+  if (!schema_.has_value() || (tuple.GetLength() <= TABLE_HEAP_OVERFLOW_THRESHOLD && tuple.overflow_ == nullptr)) {
+    return tuple;
+  }
+  auto moved = tuple.MoveToOverflow(&*schema_, &overflow_, TABLE_HEAP_OVERFLOW_THRESHOLD);
+  return moved.has_value() ? std::move(*moved) : tuple;
+}
 
-    // acquire latch here as TSAN complains. Given we only have one insertion thread, this is fine.
-    npg->WLatch();
-    auto next_page_guard = WritePageGuard{bpm_, npg};
+auto TableHeap::InsertIntoSlot(const TupleMeta &meta, const Tuple &tuple, bool is_moved) -> RID {
+  auto &slot = insert_slots_[std::hash<std::thread::id>()(std::this_thread::get_id()) % TABLE_HEAP_INSERT_SLOTS];
+  std::scoped_lock<std::mutex> slot_guard(slot.latch_);
+  while (true) {
+    if (slot.page_id_ != INVALID_PAGE_ID) {
+      page_id_t page_id = slot.page_id_;
+      auto page_guard = bpm_->FetchPageWrite(page_id);
+      auto page = page_guard.AsMut<TablePage>();
+      auto slot_id = page->InsertTuple(meta, tuple, is_moved);
+      if (slot_id.has_value()) {
+        return {page_id, *slot_id};
+      }
+      // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
+      BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
+      auto free_space = page->GetFreeSpace();
+      page_guard.Drop();
 
-    last_page_id_ = next_page_id;
-    page_guard = std::move(next_page_guard);
+      // 当前页满了，放回free space map，换一页
+      std::scoped_lock<std::mutex> guard(latch_);
+      reserved_.erase(page_id);
+      fsm_.Update(page_id, free_space);
+      slot.page_id_ = ReservePage(tuple.GetLength());
+      continue;
+    }
+    std::scoped_lock<std::mutex> guard(latch_);
+    slot.page_id_ = ReservePage(tuple.GetLength());
   }
-  auto last_page_id = last_page_id_;
+}
 
-  auto page = page_guard.AsMut<TablePage>();
-  auto slot_id = *page->InsertTuple(meta, tuple);
+auto TableHeap::ReservePage(uint32_t tuple_size) -> page_id_t {
+  page_id_t page_id = fsm_.Find(tuple_size);
+  if (page_id == INVALID_PAGE_ID) {
+    // 没有页面放得下，在链表末尾接一个新页面
+    auto new_page_guard = bpm_->NewPageGuarded(&page_id);
+    BUSTUB_ENSURE(page_id != INVALID_PAGE_ID, "cannot allocate page");
+    new_page_guard.AsMut<TablePage>()->Init();
+    new_page_guard.Drop();
 
-  // only allow one insertion at a time, otherwise it will deadlock.
-  guard.unlock();
+    auto last_page_guard = bpm_->FetchPageWrite(last_page_id_);
+    last_page_guard.AsMut<TablePage>()->SetNextPageId(page_id);
+    if (zone_map_.has_value()) {
+      zone_map_->AddPage(page_id, last_page_id_);
+    }
+    last_page_id_ = page_id;
+  }
+  fsm_.Remove(page_id);
+  reserved_.insert(page_id);
+  return page_id;
+}
 
-  if (lock_mgr != nullptr) {
-    BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, RID{last_page_id, slot_id}),
-                  "failed to lock when inserting new tuple");
+auto TableHeap::Vacuum() -> uint32_t {
+  if (format_ == TableFormat::Pax) {
+    return 0;
+  }
+  std::unique_lock<std::mutex> guard(latch_);
+  // 已删除tuple转发出去的那份也要删掉，原槽位回收以后就找不到它了
+  std::vector<RID> orphans;
+  for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page_guard = bpm_->FetchPageRead(page_id);
+    const auto *page = page_guard.As<TablePage>();
+    if (page->GetNumDeletedTuples() > 0) {
+      for (uint32_t slot_num = 0; slot_num < page->GetNumTuples(); slot_num++) {
+        RID rid{page_id, slot_num};
+        auto forward = page->GetForward(rid);
+        if (forward.has_value() && page->GetTupleMeta(rid).is_deleted_) {
+          orphans.push_back(*forward);
+        }
+      }
+    }
+    page_id = page->GetNextPageId();
+  }
+  for (const auto &rid : orphans) {
+    UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rid);
   }
 
-  page_guard.Drop();
+  uint32_t freed = 0;
+  std::vector<page_id_t> overflow_pages;
+  overflow_pages.swap(dead_overflow_);
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page_guard = bpm_->FetchPageWrite(page_id);
+    if (page_guard.As<TablePage>()->GetNumDeletedTuples() > 0) {
+      if (schema_.has_value()) {
+        CollectOverflowPages(page_guard.As<TablePage>(), page_id, &overflow_pages);
+      }
+      freed += page_guard.AsMut<TablePage>()->Vacuum();
+    }
+    const auto *page = page_guard.As<TablePage>();
+    if (reserved_.count(page_id) == 0) {
+      fsm_.Update(page_id, page->GetFreeSpace());
+    }
+    page_id = page->GetNextPageId();
+  }
+  for (auto first_page_id : overflow_pages) {
+    overflow_.Free(first_page_id);
+  }
+  return freed;
+}
 
-  return RID(last_page_id, slot_id);
+void TableHeap::CollectOverflowPages(const TablePage *page, page_id_t page_id, std::vector<page_id_t> *pages) {
+  for (uint32_t slot_num = 0; slot_num < page->GetNumTuples(); slot_num++) {
+    RID rid{page_id, slot_num};
+    // 转发槽位里只有RID，溢出页记在搬走的那份上
+    if (!page->GetTupleMeta(rid).is_deleted_ || page->GetForward(rid).has_value()) {
+      continue;
+    }
+    auto [meta, tuple] = page->GetTuple(rid);
+    if (tuple.GetLength() == 0) {
+      continue;
+    }
+    auto tuple_pages = tuple.GetOverflowPages(&*schema_);
+    pages->insert(pages->end(), tuple_pages.begin(), tuple_pages.end());
+  }
 }
 
 void TableHeap::UpdateTupleMeta(const TupleMeta &meta, RID rid) {
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+  if (format_ == TableFormat::Pax) {
+    page_guard.AsMut<PaxPage>()->UpdateTupleMeta(meta, rid);
+    return;
+  }
   auto page = page_guard.AsMut<TablePage>();
   page->UpdateTupleMeta(meta, rid);
 }
 
 auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+  if (format_ == TableFormat::Pax) {
+    return page_guard.As<PaxPage>()->GetTuple(*schema_, rid);
+  }
   auto page = page_guard.As<TablePage>();
   auto [meta, tuple] = page->GetTuple(rid);
+  auto forward = page->GetForward(rid);
+  page_guard.Drop();
+  if (forward.has_value()) {
+    // meta以原槽位为准，只从转发目标取数据
+    auto target_guard = bpm_->FetchPageRead(forward->GetPageId());
+    tuple = target_guard.As<TablePage>()->GetTuple(*forward).second;
+  }
   tuple.rid_ = rid;
+  tuple.overflow_ = &overflow_;
   return std::make_pair(meta, std::move(tuple));
 }
 
 auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+  if (format_ == TableFormat::Pax) {
+    return page_guard.As<PaxPage>()->GetTupleMeta(rid);
+  }
   auto page = page_guard.As<TablePage>();
   return page->GetTupleMeta(rid);
 }
@@ -111,14 +259,64 @@ auto TableHeap::MakeIterator() -> TableIterator {
   guard.unlock();
 
   auto page_guard = bpm_->FetchPageRead(last_page_id);
-  auto page = page_guard.As<TablePage>();
-  return {this, {first_page_id_, 0}, {last_page_id, page->GetNumTuples()}};
+  auto num_tuples = format_ == TableFormat::Pax ? page_guard.As<PaxPage>()->GetNumTuples()
+                                                : page_guard.As<TablePage>()->GetNumTuples();
+  return {this, {first_page_id_, 0}, {last_page_id, num_tuples}};
 }
 
 auto TableHeap::MakeEagerIterator() -> TableIterator { return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}}; }
 
+auto TableHeap::MakeColumnIterator(std::vector<uint32_t> column_ids) -> ColumnIterator {
+  BUSTUB_ENSURE(format_ == TableFormat::Pax, "column iterators need a PAX table");
+  return {this, std::move(column_ids)};
+}
+
+void TableHeap::UpdateTuple(const TupleMeta &meta, const Tuple &new_tuple, RID rid) {
+  if (format_ == TableFormat::Pax) {
+    UpdateTupleInPlaceUnsafe(meta, new_tuple, rid);
+    return;
+  }
+  // 先放宽原槽位所在页的zone，扫描看到新值时zone一定已经包含它
+  if (zone_map_.has_value()) {
+    zone_map_->Update(rid.GetPageId(), new_tuple);
+  }
+  auto tuple = PrepareTuple(new_tuple);
+  auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+  auto page = page_guard.AsMut<TablePage>();
+  auto old_forward = page->GetForward(rid);
+  std::vector<page_id_t> old_overflow;
+  if (schema_.has_value() && !old_forward.has_value()) {
+    // 原tuple会被覆盖，它的溢出页等Vacuum时再释放，读者手里可能还有旧tuple
+    old_overflow = page->GetTuple(rid).second.GetOverflowPages(&*schema_);
+  }
+  bool updated = page->UpdateTupleInPlace(meta, tuple, rid);
+  page_guard.Drop();
+  if (!old_overflow.empty()) {
+    std::scoped_lock<std::mutex> guard(latch_);
+    dead_overflow_.insert(dead_overflow_.end(), old_overflow.begin(), old_overflow.end());
+  }
+
+  if (!updated) {
+    // 本页放不下，存到别的页，原槽位改成转发指针。两个页面的latch不同时持有
+    auto target = InsertIntoSlot(meta, tuple, true);
+    page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+    page_guard.AsMut<TablePage>()->SetForward(meta, rid, target);
+    page_guard.Drop();
+  }
+  if (old_forward.has_value()) {
+    UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, *old_forward);
+  }
+}
+
 void TableHeap::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
+  if (zone_map_.has_value()) {
+    zone_map_->Update(rid.GetPageId(), tuple);
+  }
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+  if (format_ == TableFormat::Pax) {
+    page_guard.AsMut<PaxPage>()->UpdateTuple(*schema_, meta, tuple, rid);
+    return;
+  }
   auto page = page_guard.AsMut<TablePage>();
   page->UpdateTupleInPlaceUnsafe(meta, tuple, rid);
 }
@@ -10,25 +10,54 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
 #include "concurrency/transaction.h"
+#include "storage/page/pax_page.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
+namespace {
+
+/** @return the number of slots and the next page of a page in either table format */
+auto PageLinks(const TableHeap *table_heap, ReadPageGuard &page_guard) -> std::pair<uint32_t, page_id_t> {
+  if (table_heap->GetFormat() == TableFormat::Pax) {
+    const auto *page = page_guard.As<PaxPage>();
+    return {page->GetNumTuples(), page->GetNextPageId()};
+  }
+  const auto *page = page_guard.As<TablePage>();
+  return {page->GetNumTuples(), page->GetNextPageId()};
+}
+
+}  // namespace
+
+void TupleBatch::Release() {
+  metas_.clear();
+  tuples_.clear();
+  copies_.clear();
+  pages_.clear();
+}
+
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
     : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid) {
   // If the rid doesn't correspond to a tuple (i.e., the table has just been initialized), then
   // we set rid_ to invalid.
   auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
-  auto page = page_guard.As<TablePage>();
-  if (rid_.GetSlotNum() >= page->GetNumTuples()) {
+  if (rid_.GetSlotNum() >= PageLinks(table_heap_, page_guard).first) {
     rid_ = RID{INVALID_PAGE_ID, 0};
   }
+  page_guard.Drop();
+  while (!IsEnd() && AtMovedTuple()) {
+    Step();
+  }
 }
 
 auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_); }
@@ -38,8 +67,27 @@ auto TableIterator::GetRID() -> RID { return rid_; }
 auto TableIterator::IsEnd() -> bool { return rid_.GetPageId() == INVALID_PAGE_ID; }
 
 auto TableIterator::operator++() -> TableIterator & {
+  do {
+    Step();
+  } while (!IsEnd() && AtMovedTuple());
+  return *this;
+}
+
+auto TableIterator::AtMovedTuple() -> bool {
+  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+  return AtMovedTuple(page_guard, rid_.GetSlotNum());
+}
+
+auto TableIterator::AtMovedTuple(ReadPageGuard &page_guard, uint32_t slot) -> bool {
+  if (table_heap_->GetFormat() == TableFormat::Pax) {
+    return false;
+  }
+  return page_guard.As<TablePage>()->IsMovedTuple(slot);
+}
+
+void TableIterator::Step() {
   auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
-  auto page = page_guard.As<TablePage>();
+  auto [num_tuples, next_page_id] = PageLinks(table_heap_, page_guard);
   auto next_tuple_id = rid_.GetSlotNum() + 1;
 
   if (stop_at_rid_.GetPageId() != INVALID_PAGE_ID) {
@@ -54,17 +102,87 @@ auto TableIterator::operator++() -> TableIterator & {
 
   if (rid_ == stop_at_rid_) {
     rid_ = RID{INVALID_PAGE_ID, 0};
-  } else if (next_tuple_id < page->GetNumTuples()) {
+  } else if (next_tuple_id < num_tuples) {
     // that's fine
   } else {
-    auto next_page_id = page->GetNextPageId();
     // if next page is invalid, RID is set to invalid page; otherwise, it's the first tuple in that page.
     rid_ = RID{next_page_id, 0};
   }
 
   page_guard.Drop();
+}
 
-  return *this;
+auto TableIterator::NextBatch(TupleBatch *batch, Transaction *txn, LockManager *lock_mgr, table_oid_t oid) -> bool {
+  batch->Release();
+  if (IsEnd()) {
+    return false;
+  }
+  auto page_id = rid_.GetPageId();
+  const auto *zone_map = table_heap_->GetZoneMap();
+  page_id_t zone_next_page_id = INVALID_PAGE_ID;
+  if (!zone_ranges_.empty() && zone_map != nullptr &&
+      !zone_map->MayMatch(page_id, zone_ranges_, &zone_next_page_id)) {
+    // 这一页没有要找的行，不读它，直接跳到下一页
+    rid_ = page_id == stop_at_rid_.GetPageId() ? RID{INVALID_PAGE_ID, 0} : RID{zone_next_page_id, 0};
+    pages_skipped_++;
+    return true;
+  }
+  auto page_guard = table_heap_->bpm_->FetchPageRead(page_id);
+  auto [num_tuples, next_page_id] = PageLinks(table_heap_, page_guard);
+  auto end = num_tuples;
+  if (page_id == stop_at_rid_.GetPageId()) {
+    end = std::min(end, stop_at_rid_.GetSlotNum());
+  }
+  std::vector<RID> rids;
+  for (auto slot = rid_.GetSlotNum(); slot < end; slot++) {
+    if (!AtMovedTuple(page_guard, slot)) {
+      rids.emplace_back(page_id, slot);
+    }
+  }
+  rid_ = page_id == stop_at_rid_.GetPageId() ? RID{INVALID_PAGE_ID, 0} : RID{next_page_id, 0};
+  if (txn != nullptr && !rids.empty()) {
+    // 等行锁时不能拿着页latch，锁完再重新latch这一页
+    page_guard.Drop();
+    for (const auto &rid : rids) {
+      if (!lock_mgr->LockRow(txn, LockManager::LockMode::SHARED, oid, rid)) {
+        throw ExecutionException("lock row share failed");
+      }
+    }
+    page_guard = table_heap_->bpm_->FetchPageRead(page_id);
+  }
+
+  if (table_heap_->GetFormat() == TableFormat::Pax) {
+    // PAX页里一行的各列不连续，只能拷贝出来
+    const auto *page = page_guard.As<PaxPage>();
+    for (const auto &rid : rids) {
+      auto [meta, tuple] = page->GetTuple(*table_heap_->schema_, rid);
+      batch->metas_.push_back(meta);
+      batch->copies_.push_back(std::move(tuple));
+    }
+    for (const auto &tuple : batch->copies_) {
+      batch->tuples_.push_back(tuple.AsView());
+    }
+    return true;
+  }
+  batch->pages_.push_back(std::move(page_guard));
+  const auto *page = batch->pages_[0].As<TablePage>();
+  for (const auto &rid : rids) {
+    auto [meta, view] = page->GetTupleView(rid);
+    auto forward = page->GetForward(rid);
+    if (forward.has_value()) {
+      // 转发的tuple直接在目标页上看。写者任何时候只持有一个页latch，多拿几个读latch不会成环
+      auto target = std::find_if(batch->pages_.begin(), batch->pages_.end(),
+                                 [&](ReadPageGuard &guard) { return guard.PageId() == forward->GetPageId(); });
+      if (target == batch->pages_.end()) {
+        batch->pages_.push_back(table_heap_->bpm_->FetchPageRead(forward->GetPageId()));
+        target = std::prev(batch->pages_.end());
+      }
+      view = target->As<TablePage>()->GetTupleView(*forward).second;
+    }
+    batch->metas_.push_back(meta);
+    batch->tuples_.emplace_back(view.GetData(), view.GetLength(), rid, &table_heap_->overflow_);
+  }
+  return true;
 }
 
 }  // namespace bustub
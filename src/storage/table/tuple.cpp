@@ -16,10 +16,74 @@
 #include <string>
 #include <vector>
 
+#include "common/exception.h"
+#include "storage/table/overflow_store.h"
 #include "storage/table/tuple.h"
+#include "type/dictionary.h"
 
 namespace bustub {
 
+namespace {
+
+auto ColumnDataPtr(const char *data, const Schema *schema, uint32_t column_idx) -> const char * {
+  assert(schema);
+  const auto &col = schema->GetColumn(column_idx);
+  bool is_inlined = col.IsInlined();
+  // For inline type, data is stored where it is.
+  if (is_inlined) {
+    return (data + col.GetOffset());
+  }
+  // We read the relative offset from the tuple data.
+  int32_t offset = *reinterpret_cast<const int32_t *>(data + col.GetOffset());
+  // And return the beginning address of the real data for the VARCHAR type.
+  return (data + offset);
+}
+
+// Read the bytes of a VARCHAR value stored out of line, whose payload starts at data_ptr
+auto ReadOverflowValue(const OverflowStore *overflow, const char *data_ptr) -> std::vector<char> {
+  if (overflow == nullptr) {
+    throw Exception("reading a VARCHAR value stored out of line without its table heap");
+  }
+  auto len = *reinterpret_cast<const uint32_t *>(data_ptr) & ~VARCHAR_OVERFLOW_FLAG;
+  page_id_t page_id;
+  memcpy(&page_id, data_ptr + sizeof(uint32_t), sizeof(page_id_t));
+  return overflow->Read(page_id, len);
+}
+
+}  // namespace
+
+auto TupleView::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
+  const auto &col = schema->GetColumn(column_idx);
+  const TypeId column_type = col.GetType();
+  const char *data_ptr = ColumnDataPtr(data_, schema, column_idx);
+  if (col.GetDictionary() != nullptr) {
+    return col.GetDictionary()->Decode(*reinterpret_cast<const uint32_t *>(data_ptr));
+  }
+  if (column_type == TypeId::VARCHAR) {
+    auto len = *reinterpret_cast<const uint32_t *>(data_ptr);
+    if (len != BUSTUB_VALUE_NULL && (len & VARCHAR_OVERFLOW_FLAG) != 0) {
+      auto data = ReadOverflowValue(overflow_, data_ptr);
+      return {TypeId::VARCHAR, data.data(), static_cast<uint32_t>(data.size()), true};
+    }
+  }
+  // the third parameter "is_inlined" is unused
+  return Value::DeserializeFrom(data_ptr, column_type);
+}
+
+auto TupleView::GetValueRef(const Schema *schema, const uint32_t column_idx) const -> Value {
+  const auto &col = schema->GetColumn(column_idx);
+  if (col.GetType() != TypeId::VARCHAR || col.GetDictionary() != nullptr) {
+    return GetValue(schema, column_idx);
+  }
+  const char *data_ptr = ColumnDataPtr(data_, schema, column_idx);
+  auto len = *reinterpret_cast<const uint32_t *>(data_ptr);
+  // NULL和存在溢出页里的值还是走GetValue
+  if (len == BUSTUB_VALUE_NULL || (len & VARCHAR_OVERFLOW_FLAG) != 0) {
+    return GetValue(schema, column_idx);
+  }
+  return {TypeId::VARCHAR, data_ptr + sizeof(uint32_t), len, false};
+}
+
 // TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
 Tuple::Tuple(std::vector<Value> values, const Schema *schema) {
   assert(values.size() == schema->GetColumnCount());
@@ -35,8 +99,7 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) {
   }
 
   // 2. Allocate memory.
-  data_.resize(tuple_size);
-  std::fill(data_.begin(), data_.end(), 0);
+  data_.Resize(tuple_size);
 
   // 3. Serialize each attribute based on the input value.
   uint32_t column_count = schema->GetColumnCount();
@@ -46,26 +109,122 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) {
     const auto &col = schema->GetColumn(i);
     if (!col.IsInlined()) {
       // Serialize relative offset, where the actual varchar data is stored.
-      *reinterpret_cast<uint32_t *>(data_.data() + col.GetOffset()) = offset;
+      *reinterpret_cast<uint32_t *>(data_.Data() + col.GetOffset()) = offset;
       // Serialize varchar value, in place (size+data).
-      values[i].SerializeTo(data_.data() + offset);
+      values[i].SerializeTo(data_.Data() + offset);
       auto len = values[i].GetLength();
       if (len == BUSTUB_VALUE_NULL) {
         len = 0;
       }
       offset += (len + sizeof(uint32_t));
+    } else if (col.GetDictionary() != nullptr) {
+      *reinterpret_cast<uint32_t *>(data_.Data() + col.GetOffset()) = col.GetDictionary()->Encode(values[i]);
     } else {
-      values[i].SerializeTo(data_.data() + col.GetOffset());
+      values[i].SerializeTo(data_.Data() + col.GetOffset());
     }
   }
 }
 
 auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
-  assert(schema);
-  const TypeId column_type = schema->GetColumn(column_idx).GetType();
-  const char *data_ptr = GetDataPtr(schema, column_idx);
-  // the third parameter "is_inlined" is unused
-  return Value::DeserializeFrom(data_ptr, column_type);
+  return AsView().GetValue(schema, column_idx);
+}
+
+void Tuple::CopyFrom(const TupleView &view) {
+  data_.Assign(view.GetData(), view.GetData() + view.GetLength());
+  rid_ = view.rid_;
+  overflow_ = view.overflow_;
+}
+
+auto Tuple::ReadOverflow(const char *data_ptr) const -> std::vector<char> {
+  return ReadOverflowValue(overflow_, data_ptr);
+}
+
+auto Tuple::MoveToOverflow(const Schema *schema, const OverflowStore *store, uint32_t target) const
+    -> std::optional<Tuple> {
+  const auto &unlined = schema->GetUnlinedColumns();
+  // 每个变长列的实际长度，已经在溢出页里的也要重新写一份
+  std::vector<uint32_t> lens(unlined.size());
+  std::vector<bool> out_of_line(unlined.size(), false);
+  bool changed = false;
+  uint32_t size = schema->GetLength();
+  for (size_t i = 0; i < unlined.size(); i++) {
+    auto len = *reinterpret_cast<const uint32_t *>(GetDataPtr(schema, unlined[i]));
+    if (len == BUSTUB_VALUE_NULL) {
+      len = 0;
+    } else if ((len & VARCHAR_OVERFLOW_FLAG) != 0) {
+      len &= ~VARCHAR_OVERFLOW_FLAG;
+      changed = true;
+    }
+    lens[i] = len;
+    size += sizeof(uint32_t) + len;
+  }
+  // 从最大的值开始往外挪，直到放得下
+  while (size > target) {
+    std::optional<size_t> largest;
+    for (size_t i = 0; i < unlined.size(); i++) {
+      if (!out_of_line[i] && lens[i] > sizeof(page_id_t) && (!largest.has_value() || lens[i] > lens[*largest])) {
+        largest = i;
+      }
+    }
+    if (!largest.has_value()) {
+      break;
+    }
+    out_of_line[*largest] = true;
+    size -= lens[*largest] - sizeof(page_id_t);
+    changed = true;
+  }
+  if (!changed) {
+    return std::nullopt;
+  }
+
+  Tuple result;
+  result.rid_ = rid_;
+  result.data_.Reserve(size);
+  result.data_.Assign(data_.Data(), data_.Data() + schema->GetLength());
+  auto append = [&result](const void *src, size_t len) {
+    const auto *bytes = static_cast<const char *>(src);
+    result.data_.Append(bytes, bytes + len);
+  };
+  for (size_t i = 0; i < unlined.size(); i++) {
+    const char *data_ptr = GetDataPtr(schema, unlined[i]);
+    auto len = *reinterpret_cast<const uint32_t *>(data_ptr);
+    *reinterpret_cast<uint32_t *>(result.data_.Data() + schema->GetColumn(unlined[i]).GetOffset()) =
+        result.data_.Size();
+    if (len == BUSTUB_VALUE_NULL) {
+      append(&len, sizeof(len));
+      continue;
+    }
+    std::vector<char> fetched;
+    const char *bytes = data_ptr + sizeof(uint32_t);
+    if ((len & VARCHAR_OVERFLOW_FLAG) != 0) {
+      fetched = ReadOverflow(data_ptr);
+      bytes = fetched.data();
+    }
+    if (out_of_line[i]) {
+      page_id_t page_id = store->Write(bytes, lens[i]);
+      uint32_t flagged_len = lens[i] | VARCHAR_OVERFLOW_FLAG;
+      append(&flagged_len, sizeof(flagged_len));
+      append(&page_id, sizeof(page_id));
+    } else {
+      append(&lens[i], sizeof(uint32_t));
+      append(bytes, lens[i]);
+    }
+  }
+  return result;
+}
+
+auto Tuple::GetOverflowPages(const Schema *schema) const -> std::vector<page_id_t> {
+  std::vector<page_id_t> pages;
+  for (auto idx : schema->GetUnlinedColumns()) {
+    const char *data_ptr = GetDataPtr(schema, idx);
+    auto len = *reinterpret_cast<const uint32_t *>(data_ptr);
+    if (len != BUSTUB_VALUE_NULL && (len & VARCHAR_OVERFLOW_FLAG) != 0) {
+      page_id_t page_id;
+      memcpy(&page_id, data_ptr + sizeof(uint32_t), sizeof(page_id_t));
+      pages.push_back(page_id);
+    }
+  }
+  return pages;
 }
 
 auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs)
@@ -79,17 +238,7 @@ auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const s
 }
 
 auto Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) const -> const char * {
-  assert(schema);
-  const auto &col = schema->GetColumn(column_idx);
-  bool is_inlined = col.IsInlined();
-  // For inline type, data is stored where it is.
-  if (is_inlined) {
-    return (data_.data() + col.GetOffset());
-  }
-  // We read the relative offset from the tuple data.
-  int32_t offset = *reinterpret_cast<const int32_t *>(data_.data() + col.GetOffset());
-  // And return the beginning address of the real data for the VARCHAR type.
-  return (data_.data() + offset);
+  return ColumnDataPtr(data_.Data(), schema, column_idx);
 }
 
 auto Tuple::ToString(const Schema *schema) const -> std::string {
@@ -112,21 +261,20 @@ auto Tuple::ToString(const Schema *schema) const -> std::string {
     }
   }
   os << ")";
-  os << " Tuple size is " << data_.size();
+  os << " Tuple size is " << data_.Size();
 
   return os.str();
 }
 
 void Tuple::SerializeTo(char *storage) const {
-  int32_t sz = data_.size();
+  int32_t sz = data_.Size();
   memcpy(storage, &sz, sizeof(int32_t));
-  memcpy(storage + sizeof(int32_t), data_.data(), sz);
+  memcpy(storage + sizeof(int32_t), data_.Data(), sz);
 }
 
 void Tuple::DeserializeFrom(const char *storage) {
   uint32_t size = *reinterpret_cast<const uint32_t *>(storage);
-  this->data_.resize(size);
-  memcpy(this->data_.data(), storage + sizeof(int32_t), size);
+  this->data_.Assign(storage + sizeof(int32_t), storage + sizeof(int32_t) + size);
 }
 
 }  // namespace bustub
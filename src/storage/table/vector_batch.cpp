@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vector_batch.cpp
+//
+// Identification: src/storage/table/vector_batch.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/vector_batch.h"
+
+#include <cstring>
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+ColumnVector::ColumnVector(TypeId type) : type_(type), width_(static_cast<uint32_t>(Type::GetTypeSize(type))) {}
+
+auto ColumnVector::GetValue(size_t idx) const -> Value {
+  if (width_ == 0) {
+    return varlens_[idx];
+  }
+  if (nulls_[idx] != 0) {
+    return ValueFactory::GetNullValueByType(type_);
+  }
+  return Value::DeserializeFrom(data_.data() + idx * width_, type_);
+}
+
+void ColumnVector::Append(const Value &value) {
+  if (!value.IsNull() && value.GetTypeId() != type_) {
+    Append(value.CastAs(type_));
+    return;
+  }
+  nulls_.push_back(value.IsNull() ? 1 : 0);
+  if (width_ == 0) {
+    if (value.IsNull()) {
+      varlens_.push_back(ValueFactory::GetNullValueByType(type_));
+    } else if (value.GetDictionaryId() != 0) {
+      // 字典里的字符串和字典活得一样久，不用拷贝，也保留编码
+      varlens_.push_back(value);
+    } else {
+      // 值可能指向页面里的数据，拷贝一份
+      varlens_.emplace_back(type_, value.GetData(), value.GetLength(), true);
+    }
+    return;
+  }
+  auto offset = data_.size();
+  data_.resize(offset + width_);
+  if (value.IsNull()) {
+    ValueFactory::GetNullValueByType(type_).SerializeTo(data_.data() + offset);
+  } else {
+    value.SerializeTo(data_.data() + offset);
+  }
+}
+
+void ColumnVector::AppendFrom(const ColumnVector &other, size_t idx) {
+  nulls_.push_back(other.nulls_[idx]);
+  if (width_ == 0) {
+    varlens_.push_back(other.varlens_[idx]);
+    return;
+  }
+  auto offset = data_.size();
+  data_.resize(offset + width_);
+  memcpy(data_.data() + offset, other.data_.data() + idx * width_, width_);
+}
+
+void ColumnVector::Truncate(size_t size) {
+  if (size >= Size()) {
+    return;
+  }
+  nulls_.resize(size);
+  if (width_ == 0) {
+    varlens_.erase(varlens_.begin() + size, varlens_.end());
+  } else {
+    data_.resize(size * width_);
+  }
+}
+
+void ColumnVector::Clear() {
+  data_.clear();
+  nulls_.clear();
+  varlens_.clear();
+}
+
+void VectorBatch::Reset(const Schema &schema) {
+  rids_.clear();
+  bool same_types = columns_.size() == schema.GetColumnCount();
+  for (uint32_t i = 0; same_types && i < columns_.size(); i++) {
+    same_types = columns_[i].GetType() == schema.GetColumn(i).GetType();
+  }
+  if (same_types) {
+    for (auto &column : columns_) {
+      column.Clear();
+    }
+    return;
+  }
+  columns_.clear();
+  for (const auto &column : schema.GetColumns()) {
+    columns_.emplace_back(column.GetType());
+  }
+}
+
+auto VectorBatch::GetTuple(size_t row, const Schema &schema) const -> Tuple {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column.GetValue(row));
+  }
+  Tuple tuple(std::move(values), &schema);
+  tuple.SetRid(rids_[row]);
+  return tuple;
+}
+
+void VectorBatch::AppendTuple(const Tuple &tuple, const Schema &schema) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].Append(tuple.GetValue(&schema, i));
+  }
+  rids_.push_back(tuple.GetRid());
+}
+
+void VectorBatch::AppendView(const TupleView &tuple, const Schema &schema) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].Append(tuple.GetValueRef(&schema, i));
+  }
+  rids_.push_back(tuple.GetRid());
+}
+
+void VectorBatch::AppendRow(const std::vector<Value> &values, RID rid) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].Append(values[i]);
+  }
+  rids_.push_back(rid);
+}
+
+void VectorBatch::AppendRowFrom(const VectorBatch &other, size_t row) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].AppendFrom(other.columns_[i], row);
+  }
+  rids_.push_back(other.rids_[row]);
+}
+
+void VectorBatch::Truncate(size_t size) {
+  if (size >= rids_.size()) {
+    return;
+  }
+  for (auto &column : columns_) {
+    column.Truncate(size);
+  }
+  rids_.resize(size);
+}
+
+}  // namespace bustub
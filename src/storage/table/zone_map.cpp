@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.cpp
+//
+// Identification: src/storage/table/zone_map.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/zone_map.h"
+
+namespace bustub {
+
+ZoneMap::ZoneMap(const Schema &schema) : schema_(schema) {
+  for (const auto &column : schema_.GetColumns()) {
+    switch (column.GetType()) {
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT:
+      case TypeId::DECIMAL:
+      case TypeId::TIMESTAMP:
+        tracked_.push_back(true);
+        break;
+      default:
+        tracked_.push_back(false);
+    }
+  }
+}
+
+void ZoneMap::AddPage(page_id_t page_id, page_id_t prev_page_id) {
+  std::scoped_lock<std::mutex> guard(latch_);
+  pages_[page_id].zones_.resize(tracked_.size());
+  if (prev_page_id != INVALID_PAGE_ID) {
+    pages_[prev_page_id].next_page_id_ = page_id;
+  }
+}
+
+void ZoneMap::Update(page_id_t page_id, const Tuple &tuple) {
+  // 先把值读出来，不在latch里反序列化
+  std::vector<std::optional<Value>> values(tracked_.size());
+  for (uint32_t i = 0; i < tracked_.size(); i++) {
+    if (tracked_[i]) {
+      auto value = tuple.GetValue(&schema_, i);
+      if (!value.IsNull()) {
+        values[i] = std::move(value);
+      }
+    }
+  }
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto &zones = pages_[page_id].zones_;
+  zones.resize(tracked_.size());
+  for (uint32_t i = 0; i < tracked_.size(); i++) {
+    if (!values[i].has_value()) {
+      continue;
+    }
+    auto &zone = zones[i];
+    if (!zone.has_value_) {
+      zone.min_ = *values[i];
+      zone.max_ = *values[i];
+      zone.has_value_ = true;
+      continue;
+    }
+    if (values[i]->CompareLessThan(zone.min_) == CmpBool::CmpTrue) {
+      zone.min_ = *values[i];
+    }
+    if (values[i]->CompareGreaterThan(zone.max_) == CmpBool::CmpTrue) {
+      zone.max_ = *values[i];
+    }
+  }
+}
+
+auto ZoneMap::MayMatch(page_id_t page_id, const std::vector<ZoneRange> &ranges, page_id_t *next_page_id) const
+    -> bool {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto it = pages_.find(page_id);
+  if (it == pages_.end()) {
+    *next_page_id = INVALID_PAGE_ID;
+    return true;
+  }
+  *next_page_id = it->second.next_page_id_;
+  for (const auto &range : ranges) {
+    const auto &zone = it->second.zones_[range.column_idx_];
+    // 这一列在页里全是NULL，任何比较都不成立
+    if (!zone.has_value_) {
+      return false;
+    }
+    if (range.lower_.has_value()) {
+      auto below = range.lower_inclusive_ ? zone.max_.CompareLessThan(*range.lower_)
+                                          : zone.max_.CompareLessThanEquals(*range.lower_);
+      if (below == CmpBool::CmpTrue) {
+        return false;
+      }
+    }
+    if (range.upper_.has_value()) {
+      auto above = range.upper_inclusive_ ? zone.min_.CompareGreaterThan(*range.upper_)
+                                          : zone.min_.CompareGreaterThanEquals(*range.upper_);
+      if (above == CmpBool::CmpTrue) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace bustub
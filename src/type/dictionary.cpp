@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// dictionary.cpp
+//
+// Identification: src/type/dictionary.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/dictionary.h"
+
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/util/hash_util.h"
+
+namespace bustub {
+
+namespace {
+std::atomic<uint32_t> next_dictionary_id{1};
+}  // namespace
+
+Dictionary::Dictionary() : id_(next_dictionary_id.fetch_add(1)), chunks_(new std::atomic<Entry *>[MAX_CHUNKS]) {
+  for (uint32_t i = 0; i < MAX_CHUNKS; i++) {
+    chunks_[i].store(nullptr);
+  }
+}
+
+Dictionary::~Dictionary() {
+  for (uint32_t i = 0; i < MAX_CHUNKS; i++) {
+    delete[] chunks_[i].load();
+  }
+}
+
+auto Dictionary::Lookup(const Value &value) const -> std::optional<uint32_t> {
+  if (value.GetTypeId() != TypeId::VARCHAR) {
+    throw Exception(ExceptionType::INCOMPATIBLE_TYPE, "dictionary columns only hold VARCHAR values");
+  }
+  if (value.GetDictionaryId() == id_) {
+    return value.GetDictionaryCode();
+  }
+  std::string_view str(value.GetData(), value.GetLength());
+  latch_.RLock();
+  auto it = codes_.find(str);
+  std::optional<uint32_t> code;
+  if (it != codes_.end()) {
+    code = it->second;
+  }
+  latch_.RUnlock();
+  return code;
+}
+
+auto Dictionary::Encode(const Value &value) -> uint32_t {
+  if (value.IsNull()) {
+    return NULL_CODE;
+  }
+  if (auto code = Lookup(value); code.has_value()) {
+    return *code;
+  }
+  uint32_t len = value.GetLength();
+  latch_.WLock();
+  // 拿写锁之前可能已经被别的线程加进来了
+  auto it = codes_.find(std::string_view(value.GetData(), len));
+  if (it != codes_.end()) {
+    auto code = it->second;
+    latch_.WUnlock();
+    return code;
+  }
+  auto code = static_cast<uint32_t>(size_.load());
+  if (code >= CHUNK_SIZE * MAX_CHUNKS) {
+    latch_.WUnlock();
+    throw Exception("dictionary is full");
+  }
+  if (code % CHUNK_SIZE == 0) {
+    chunks_[code / CHUNK_SIZE].store(new Entry[CHUNK_SIZE]);
+  }
+  // 哈希存在字符串前面
+  std::size_t hash = HashUtil::HashBytes(value.GetData(), len);
+  auto bytes = std::make_unique<char[]>(sizeof(hash) + len);
+  memcpy(bytes.get(), &hash, sizeof(hash));
+  memcpy(bytes.get() + sizeof(hash), value.GetData(), len);
+  const char *data = bytes.get() + sizeof(hash);
+  strings_.push_back(std::move(bytes));
+  chunks_[code / CHUNK_SIZE].load()[code % CHUNK_SIZE] = Entry{data, len};
+  codes_.emplace(std::string_view(data, len), code);
+  size_.store(code + 1);
+  latch_.WUnlock();
+  return code;
+}
+
+auto Dictionary::Decode(uint32_t code) const -> Value {
+  if (code == NULL_CODE) {
+    return Value(TypeId::VARCHAR);
+  }
+  const Entry &entry = chunks_[code / CHUNK_SIZE].load()[code % CHUNK_SIZE];
+  Value value(TypeId::VARCHAR, entry.data_, entry.len_, false);
+  value.value_.coded_varlen_.code_ = code;
+  value.value_.coded_varlen_.dictionary_id_ = id_;
+  return value;
+}
+
+auto Dictionary::CachedHash(const Value &value) -> std::size_t {
+  std::size_t hash;
+  memcpy(&hash, value.GetData() - sizeof(hash), sizeof(hash));
+  return hash;
+}
+
+}  // namespace bustub
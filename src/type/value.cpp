@@ -28,11 +28,10 @@ Value::Value(const Value &other) {
       if (size_.len_ == BUSTUB_VALUE_NULL) {
         value_.varlen_ = nullptr;
       } else {
-        if (manage_data_) {
+        // 内联的短字符串和不拥有数据的指针都已经随value_复制过来了
+        if (manage_data_ && size_.len_ > INLINE_VARLEN_SIZE) {
           value_.varlen_ = new char[size_.len_];
           memcpy(value_.varlen_, other.value_.varlen_, size_.len_);
-        } else {
-          value_ = other.value_;
         }
       }
       break;
@@ -219,7 +218,10 @@ Value::Value(TypeId type, const char *data, uint32_t len, bool manage_data) : Va
         size_.len_ = BUSTUB_VALUE_NULL;
       } else {
         manage_data_ = manage_data;
-        if (manage_data_) {
+        if (manage_data_ && len <= INLINE_VARLEN_SIZE) {
+          size_.len_ = len;
+          memcpy(value_.inline_varlen_, data, len);
+        } else if (manage_data_) {
           assert(len < BUSTUB_VARCHAR_MAX_LEN);
           value_.varlen_ = new char[len];
           assert(value_.varlen_ != nullptr);
@@ -228,6 +230,7 @@ Value::Value(TypeId type, const char *data, uint32_t len, bool manage_data) : Va
         } else {
           // FUCK YOU GCC I do what I want.
           value_.const_varlen_ = data;
+          value_.coded_varlen_.dictionary_id_ = 0;
           size_.len_ = len;
         }
       }
@@ -243,9 +246,13 @@ Value::Value(TypeId type, const std::string &data) : Value(type) {
       manage_data_ = true;
       // TODO(TAs): How to represent a null string here?
       uint32_t len = static_cast<uint32_t>(data.length()) + 1;
+      size_.len_ = len;
+      if (len <= INLINE_VARLEN_SIZE) {
+        memcpy(value_.inline_varlen_, data.c_str(), len);
+        break;
+      }
       value_.varlen_ = new char[len];
       assert(value_.varlen_ != nullptr);
-      size_.len_ = len;
       memcpy(value_.varlen_, data.c_str(), len);
       break;
     }
@@ -258,7 +265,7 @@ Value::Value(TypeId type, const std::string &data) : Value(type) {
 Value::~Value() {
   switch (type_id_) {
     case TypeId::VARCHAR:
-      if (manage_data_) {
+      if (manage_data_ && size_.len_ > INLINE_VARLEN_SIZE) {
         delete[] value_.varlen_;
       }
       break;
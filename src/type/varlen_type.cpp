@@ -41,7 +41,7 @@ VarlenType::VarlenType(TypeId type) : Type(type) {}
 VarlenType::~VarlenType() = default;
 
 // Access the raw variable length data
-auto VarlenType::GetData(const Value &val) const -> const char * { return val.value_.varlen_; }
+auto VarlenType::GetData(const Value &val) const -> const char * { return val.VarlenData(); }
 
 // Get the length of the variable length data (including the length field)
 auto VarlenType::GetLength(const Value &val) const -> uint32_t { return val.size_.len_; }
@@ -51,6 +51,9 @@ auto VarlenType::CompareEquals(const Value &left, const Value &right) const -> C
   if (left.IsNull() || right.IsNull()) {
     return CmpBool::CmpNull;
   }
+  if (left.GetDictionaryId() != 0 && left.GetDictionaryId() == right.GetDictionaryId()) {
+    return GetCmpBool(left.GetDictionaryCode() == right.GetDictionaryCode());
+  }
   if (GetLength(left) == BUSTUB_VARCHAR_MAX_LEN || GetLength(right) == BUSTUB_VARCHAR_MAX_LEN) {
     return GetCmpBool(GetLength(left) == GetLength(right));
   }
@@ -63,6 +66,9 @@ auto VarlenType::CompareNotEquals(const Value &left, const Value &right) const -
   if (left.IsNull() || right.IsNull()) {
     return CmpBool::CmpNull;
   }
+  if (left.GetDictionaryId() != 0 && left.GetDictionaryId() == right.GetDictionaryId()) {
+    return GetCmpBool(left.GetDictionaryCode() != right.GetDictionaryCode());
+  }
   if (GetLength(left) == BUSTUB_VARCHAR_MAX_LEN || GetLength(right) == BUSTUB_VARCHAR_MAX_LEN) {
     return GetCmpBool(GetLength(left) != GetLength(right));
   }
@@ -162,7 +168,7 @@ void VarlenType::SerializeTo(const Value &val, char *storage) const {
     return;
   }
   memcpy(storage, &len, sizeof(uint32_t));
-  memcpy(storage + sizeof(uint32_t), val.value_.varlen_, len);
+  memcpy(storage + sizeof(uint32_t), val.VarlenData(), len);
 }
 
 // Deserialize a value of the given type from the given storage space.
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter_test.cpp
+//
+// Identification: test/container/bloom_filter_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "container/hash/bloom_filter.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BloomFilterTest, BlockedBloomFilterTest) {
+  const uint64_t num_keys = 100000;
+  BlockedBloomFilter filter(num_keys);
+  EXPECT_EQ((num_keys * BlockedBloomFilter::BITS_PER_KEY + 511) / 512, filter.GetNumBlocks());
+
+  auto hash_of = [](uint64_t key) { return key * 0x9e3779b97f4a7c15ULL; };
+  for (uint64_t i = 0; i < num_keys; i++) {
+    filter.Insert(hash_of(i));
+  }
+  // 不会有假阴性
+  for (uint64_t i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(filter.MayContain(hash_of(i)));
+  }
+  int false_positives = 0;
+  for (uint64_t i = num_keys; i < 2 * num_keys; i++) {
+    false_positives += filter.MayContain(hash_of(i)) ? 1 : 0;
+  }
+  // 每个键 16 位时约为 0.1%
+  EXPECT_LT(false_positives, num_keys / 200);
+}
+
+// NOLINTNEXTLINE
+TEST(BloomFilterTest, KeyBloomFilterTest) {
+  Schema key_schema({Column{"a", TypeId::INTEGER}});
+  auto key_of = [&](int32_t i) { return Tuple({ValueFactory::GetIntegerValue(i)}, &key_schema); };
+
+  // 插入比预期多得多的键，过滤器要能扩容
+  KeyBloomFilter filter(10);
+  const int num_keys = 20000;
+  for (int32_t i = 0; i < num_keys; i += 2) {
+    filter.Insert(key_of(i), key_schema);
+  }
+  int false_positives = 0;
+  for (int32_t i = 0; i < num_keys; i++) {
+    if (i % 2 == 0) {
+      ASSERT_TRUE(filter.MayContain(key_of(i), key_schema));
+    } else {
+      false_positives += filter.MayContain(key_of(i), key_schema) ? 1 : 0;
+    }
+  }
+  EXPECT_LT(false_positives, num_keys / 2 / 50);
+
+  // 不同宽度的相同整数哈希相同
+  Schema bigint_schema({Column{"a", TypeId::BIGINT}});
+  EXPECT_EQ(KeyBloomFilter::KeyHash(key_of(42), key_schema),
+            KeyBloomFilter::KeyHash(Tuple({ValueFactory::GetBigIntValue(42)}, &bigint_schema), bigint_schema));
+}
+
+}  // namespace bustub
@@ -15,6 +15,7 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/logger.h"
+#include "container/hash/hash_function.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/hash_table_bucket_page.h"
@@ -23,7 +24,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
+TEST(HashTablePageTest, DirectoryPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -56,7 +57,7 @@ TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
+TEST(HashTablePageTest, BucketPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -65,10 +66,13 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
 
   auto bucket_page =
       reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(bpm->NewPage(&bucket_page_id)->GetData());
+  auto fingerprint = [](int key) {
+    return HashTableBucketPage<int, int, IntComparator>::Fingerprint(HashFunction<int>().GetHash(key));
+  };
 
   // insert a few (key, value) pairs
   for (unsigned i = 0; i < 10; i++) {
-    assert(bucket_page->Insert(i, i, IntComparator()));
+    assert(bucket_page->Insert(i, i, fingerprint(i), IntComparator()));
   }
 
   // check for the inserted pairs
@@ -80,7 +84,7 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   // remove a few pairs
   for (unsigned i = 0; i < 10; i++) {
     if (i % 2 == 1) {
-      assert(bucket_page->Remove(i, i, IntComparator()));
+      assert(bucket_page->Remove(i, i, fingerprint(i), IntComparator()));
     }
   }
 
@@ -101,7 +105,7 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   // try to remove the already-removed pairs
   for (unsigned i = 0; i < 10; i++) {
     if (i % 2 == 1) {
-      assert(!bucket_page->Remove(i, i, IntComparator()));
+      assert(!bucket_page->Remove(i, i, fingerprint(i), IntComparator()));
     }
   }
 
@@ -113,4 +117,61 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageFingerprintTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+  using BucketPage = HashTableBucketPage<int, int, IntComparator>;
+  const auto capacity = static_cast<int>(4 * (BUSTUB_PAGE_SIZE - sizeof(page_id_t)) / (4 * sizeof(std::pair<int, int>) + 4 + 1));
+
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  auto bucket_page = reinterpret_cast<BucketPage *>(bpm->NewPage(&bucket_page_id)->GetData());
+  auto fingerprint = [](int key) { return BucketPage::Fingerprint(HashFunction<int>().GetHash(key)); };
+
+  // fill the whole bucket, including the tail that is not a multiple of 16 slots
+  for (int i = 0; i < capacity; i++) {
+    EXPECT_TRUE(bucket_page->Insert(i, i, fingerprint(i), IntComparator()));
+  }
+  EXPECT_TRUE(bucket_page->IsFull());
+  EXPECT_FALSE(bucket_page->Insert(capacity, capacity, fingerprint(capacity), IntComparator()));
+
+  // keys sharing a fingerprint must still be told apart by the full key
+  int colliding = -1;
+  for (int i = 1; i < capacity; i++) {
+    if (fingerprint(i) == fingerprint(0)) {
+      colliding = i;
+      break;
+    }
+  }
+  ASSERT_NE(colliding, -1);
+  std::vector<int> res;
+  EXPECT_TRUE(bucket_page->GetValue(0, fingerprint(0), IntComparator(), &res));
+  EXPECT_EQ(res, std::vector<int>{0});
+
+  for (int i = 0; i < capacity; i += 3) {
+    EXPECT_TRUE(bucket_page->Remove(i, i, fingerprint(i), IntComparator()));
+  }
+  for (int i = 0; i < capacity; i++) {
+    res.clear();
+    EXPECT_EQ(bucket_page->GetValue(i, fingerprint(i), IntComparator(), &res), i % 3 != 0);
+  }
+
+  // tombstones are reused, and a key may hold several values
+  for (int i = 0; i < capacity; i += 3) {
+    EXPECT_TRUE(bucket_page->Insert(colliding, -i, fingerprint(colliding), IntComparator()));
+  }
+  EXPECT_TRUE(bucket_page->IsFull());
+  res.clear();
+  EXPECT_TRUE(bucket_page->GetValue(colliding, fingerprint(colliding), IntComparator(), &res));
+  EXPECT_EQ(res.size(), (capacity + 2) / 3 + (colliding % 3 != 0 ? 1 : 0));
+  res.clear();
+  EXPECT_FALSE(bucket_page->GetValue(0, fingerprint(0), IntComparator(), &res));
+
+  bpm->UnpinPage(bucket_page_id, true);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -18,13 +18,14 @@
 #include "container/disk/hash/disk_extendible_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(50, disk_manager);
   DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
@@ -117,4 +118,120 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, GrowShrinkTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  const int num_keys = 20000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_GT(ht.GetGlobalDepth(), 0);
+  ht.VerifyIntegrity();
+
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // emptied buckets are merged back and the directory shrinks with them
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DuplicateKeyTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // far more values per key than a bucket holds, splitting can never separate them
+  const int num_keys = 3;
+  const int values_per_key = 2500;
+  for (int v = 0; v < values_per_key; v++) {
+    for (int k = 0; k < num_keys; k++) {
+      EXPECT_TRUE(ht.Insert(nullptr, k, v));
+    }
+  }
+  EXPECT_FALSE(ht.Insert(nullptr, 0, 0));
+  ht.VerifyIntegrity();
+
+  for (int k = 0; k < num_keys; k++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, k, &res));
+    EXPECT_EQ(values_per_key, res.size());
+  }
+
+  // other keys still split away from the chained buckets
+  for (int k = num_keys; k < 2000; k++) {
+    EXPECT_TRUE(ht.Insert(nullptr, k, k));
+  }
+  for (int k = num_keys; k < 2000; k++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, k, &res));
+    EXPECT_EQ(std::vector<int>{k}, res);
+  }
+
+  for (int v = 0; v < values_per_key; v += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, 1, v));
+  }
+  std::vector<int> res;
+  EXPECT_TRUE(ht.GetValue(nullptr, 1, &res));
+  EXPECT_EQ(values_per_key / 2, res.size());
+  for (int v = 1; v < values_per_key; v += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, 1, v));
+  }
+  res.clear();
+  EXPECT_FALSE(ht.GetValue(nullptr, 1, &res));
+  ht.VerifyIntegrity();
+
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  const int num_threads = 4;
+  const int keys_per_thread = 5000;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&ht, tid] {
+      for (int i = tid; i < num_threads * keys_per_thread; i += num_threads) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+      }
+      // every thread removes the odd keys it inserted
+      for (int i = tid; i < num_threads * keys_per_thread; i += num_threads) {
+        if (i % 2 == 1) {
+          EXPECT_TRUE(ht.Remove(nullptr, i, i));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ht.VerifyIntegrity();
+
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(ht.GetValue(nullptr, i, &res), i % 2 == 0);
+  }
+
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table_test.cpp
+//
+// Identification: test/container/disk/hash/linear_probe_hash_table_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/disk/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, SampleTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // non-unique keys, but no duplicate key-value pairs
+  for (int i = 0; i < 5; i++) {
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i + 1));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(2, res.size());
+  }
+
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(2 * i + 1, res[0]);
+  }
+
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, IncrementalResizeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+  const int num_keys = 20000;
+
+  size_t size = ht.GetSize();
+  int resizes = 0;
+  bool seen_migration = false;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    if (ht.GetSize() != size) {
+      EXPECT_GE(ht.GetSize(), 2 * size);
+      size = ht.GetSize();
+      resizes++;
+    }
+    // entries still in the old table are visible while a resize is in progress
+    if (ht.IsMigrating()) {
+      seen_migration = true;
+      for (int j = i % 97; j <= i; j += 97) {
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, j, &res)) << "lost " << j << " during migration";
+      }
+    }
+  }
+  EXPECT_GT(resizes, 3);
+  EXPECT_TRUE(seen_migration);
+
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size()) << "missing " << i;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // churn fills the table with tombstones, which a same-size rebuild cleans up
+  for (int round = 0; round < 4; round++) {
+    for (int i = 0; i < num_keys; i += 2) {
+      EXPECT_TRUE(ht.Remove(nullptr, i, i + round));
+      EXPECT_TRUE(ht.Insert(nullptr, i, i + round + 1));
+    }
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size()) << "missing " << i;
+    EXPECT_EQ(i % 2 == 0 ? i + 4 : i, res[0]);
+  }
+
+  // an explicit resize also migrates incrementally
+  ht.Resize(ht.GetSize());
+  EXPECT_TRUE(ht.IsMigrating());
+  for (int i = 1; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  EXPECT_FALSE(ht.IsMigrating());
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(ht.GetValue(nullptr, i, &res), i % 2 == 0);
+  }
+
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, MultiLevelHeaderTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  auto key_schema = ParseCreateStatement("a bigint");
+  using Table = LinearProbeHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+  Table ht("blah", bpm, GenericComparator<64>(key_schema.get()), 1000, HashFunction<GenericKey<64>>());
+  auto key = [](int64_t i) {
+    GenericKey<64> index_key;
+    index_key.SetFromInteger(i);
+    return index_key;
+  };
+
+  // more entries than the blocks listed by a single header page can hold
+  const size_t max_single_level =
+      HashTableHeaderPage::MaxBlocks() * (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(std::pair<GenericKey<64>, RID>) + 1));
+  const auto num_keys = static_cast<int64_t>(max_single_level);
+  for (int64_t i = 0; i < num_keys; i++) {
+    bool was_migrating = ht.IsMigrating();
+    size_t size = ht.GetSize();
+    ASSERT_TRUE(ht.Insert(nullptr, key(i), RID(i))) << "failed to insert " << i;
+    // a resize only starts once the previous migration has finished
+    if (ht.GetSize() != size) {
+      EXPECT_FALSE(was_migrating);
+    }
+  }
+  EXPECT_GT(ht.GetSize(), max_single_level);
+
+  for (int64_t i = 0; i < num_keys; i += 7) {
+    std::vector<RID> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, key(i), &res)) << "missing " << i;
+    EXPECT_EQ(std::vector<RID>{RID(i)}, res);
+  }
+  for (int64_t i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, key(i), RID(i)));
+  }
+  for (int64_t i = 0; i < num_keys; i += 7) {
+    std::vector<RID> res;
+    EXPECT_EQ(ht.GetValue(nullptr, key(i), &res), i % 2 == 1);
+  }
+
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,228 @@
+#include <fmt/format.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "primer/disk_trie.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+TEST(DiskTrieTest, BasicPutGetRemove) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(32, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  DiskTrie trie(bpm.get(), header_page_id);
+
+  ASSERT_EQ(trie.Get("a"), std::nullopt);
+  trie.Put("", "root");
+  trie.Put("test", "1");
+  trie.Put("te", "2");
+  trie.Put("tea", "3");
+  trie.Put("team", "4");
+  ASSERT_EQ(trie.Get(""), "root");
+  ASSERT_EQ(trie.Get("test"), "1");
+  ASSERT_EQ(trie.Get("te"), "2");
+  ASSERT_EQ(trie.Get("tea"), "3");
+  ASSERT_EQ(trie.Get("team"), "4");
+  ASSERT_EQ(trie.Get("t"), std::nullopt);
+  ASSERT_EQ(trie.Get("teams"), std::nullopt);
+
+  trie.Put("tea", "5");
+  ASSERT_EQ(trie.Get("tea"), "5");
+  trie.Remove("te");
+  trie.Remove("tes");
+  ASSERT_EQ(trie.Get("te"), std::nullopt);
+  ASSERT_EQ(trie.Get("test"), "1");
+  trie.Remove("");
+  trie.Remove("test");
+  trie.Remove("tea");
+  trie.Remove("team");
+  ASSERT_EQ(trie.GetRootPageId(), INVALID_PAGE_ID);
+}
+
+TEST(DiskTrieTest, ScanPrefix) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(32, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  DiskTrie trie(bpm.get(), header_page_id);
+
+  std::map<std::string, std::string> expected;
+  DiskTrieWriteBatch batch;
+  for (int i = 0; i < 300; i++) {
+    auto key = fmt::format("user/{}/name", i);
+    batch.Put(key, std::to_string(i));
+    expected[key] = std::to_string(i);
+  }
+  batch.Put("user", "dir");
+  batch.Put(std::string("\xff", 1), "high byte");
+  expected["user"] = "dir";
+  trie.Commit(batch);
+
+  auto all = trie.ScanPrefix("");
+  ASSERT_EQ(all.size(), expected.size() + 1);
+  // 0xff sorts after every ASCII key
+  ASSERT_EQ(all.back().second, "high byte");
+  all.pop_back();
+  std::vector<std::pair<std::string, std::string>> expected_all(expected.begin(), expected.end());
+  ASSERT_EQ(all, expected_all);
+
+  auto ones = trie.ScanPrefix("user/1");
+  std::vector<std::pair<std::string, std::string>> expected_ones;
+  for (const auto &[key, value] : expected) {
+    if (key.rfind("user/1", 0) == 0) {
+      expected_ones.emplace_back(key, value);
+    }
+  }
+  ASSERT_EQ(ones, expected_ones);
+
+  // the prefix ends in the middle of a compressed path
+  auto one_name = trie.ScanPrefix("user/17/na");
+  ASSERT_EQ(one_name.size(), 1);
+  ASSERT_EQ(one_name[0].first, "user/17/name");
+
+  auto limited = trie.ScanPrefix("user/2", 5);
+  ASSERT_EQ(limited.size(), 5);
+  ASSERT_EQ(limited[0].first, "user/2/name");
+  ASSERT_EQ(limited[1].first, "user/20/name");
+
+  ASSERT_TRUE(trie.ScanPrefix("users").empty());
+  ASSERT_TRUE(trie.ScanPrefix("user/1/named").empty());
+}
+
+TEST(DiskTrieTest, SnapshotIsolation) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  DiskTrie trie(bpm.get(), header_page_id);
+
+  for (int i = 0; i < 100; i++) {
+    trie.Put(fmt::format("{:#04}", i), "old");
+  }
+  {
+    auto snapshot = trie.GetSnapshot();
+    DiskTrieWriteBatch batch;
+    for (int i = 0; i < 100; i++) {
+      batch.Put(fmt::format("{:#04}", i), "new");
+      if (i % 2 == 1) {
+        batch.Remove(fmt::format("{:#04}", i));
+      }
+    }
+    trie.Commit(batch);
+    // the old snapshot still sees every key with its old value
+    for (int i = 0; i < 100; i++) {
+      ASSERT_EQ(snapshot.Get(fmt::format("{:#04}", i)), "old");
+    }
+    ASSERT_EQ(snapshot.ScanPrefix("").size(), 100);
+  }
+  ASSERT_EQ(trie.Get("0000"), "new");
+  ASSERT_EQ(trie.Get("0051"), std::nullopt);
+  ASSERT_EQ(trie.ScanPrefix("").size(), 50);
+}
+
+TEST(DiskTrieTest, PagesAreReclaimed) {
+  // Every write replaces a root-to-leaf path, with a small buffer pool the old paths must be deleted to keep the
+  // trie working.
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  DiskTrie trie(bpm.get(), header_page_id);
+
+  std::map<std::string, std::string> expected;
+  std::mt19937 rng(15445);
+  for (int i = 0; i < 5000; i++) {
+    auto key = std::to_string(rng() % 500);
+    if (rng() % 4 == 0) {
+      trie.Remove(key);
+      expected.erase(key);
+    } else {
+      auto value = std::to_string(i);
+      trie.Put(key, value);
+      expected[key] = value;
+    }
+  }
+  for (int k = 0; k < 500; k++) {
+    auto key = std::to_string(k);
+    auto it = expected.find(key);
+    ASSERT_EQ(trie.Get(key), it == expected.end() ? std::nullopt : std::optional<std::string>(it->second));
+  }
+  ASSERT_EQ(trie.ScanPrefix("").size(), expected.size());
+}
+
+TEST(DiskTrieTest, Recovery) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  page_id_t header_page_id;
+  std::string long_key(DISK_TRIE_MAX_KEY_SIZE, 'k');
+  std::string long_value(DISK_TRIE_MAX_VALUE_SIZE, 'v');
+  {
+    auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager.get());
+    bpm->NewPage(&header_page_id);
+    bpm->UnpinPage(header_page_id, true);
+    DiskTrie trie(bpm.get(), header_page_id);
+    for (int i = 0; i < 200; i++) {
+      trie.Put(fmt::format("key{}", i), fmt::format("value{}", i));
+    }
+    trie.Put(long_key, long_value);
+    ASSERT_THROW(trie.Put(long_key + "k", "v"), Exception);
+    ASSERT_THROW(trie.Put("k", long_value + "v"), Exception);
+    // the buffer pool is dropped without flushing, as if the process crashed after the last commit
+  }
+  auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager.get());
+  DiskTrie trie(bpm.get(), header_page_id);
+  for (int i = 0; i < 200; i++) {
+    ASSERT_EQ(trie.Get(fmt::format("key{}", i)), fmt::format("value{}", i));
+  }
+  ASSERT_EQ(trie.Get(long_key), long_value);
+  ASSERT_EQ(trie.ScanPrefix("key1").size(), 111);
+}
+
+TEST(DiskTrieTest, ConcurrentReaders) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  DiskTrie trie(bpm.get(), header_page_id);
+
+  // Each commit writes a whole generation; a reader must never see two generations mixed in one snapshot.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 2; r++) {
+    readers.emplace_back([&trie, &done] {
+      while (!done) {
+        auto snapshot = trie.GetSnapshot();
+        auto pairs = snapshot.ScanPrefix("");
+        for (const auto &[key, value] : pairs) {
+          ASSERT_EQ(value, pairs[0].second);
+        }
+      }
+    });
+  }
+  for (int generation = 0; generation < 50; generation++) {
+    DiskTrieWriteBatch batch;
+    for (int i = 0; i < 20; i++) {
+      batch.Put(fmt::format("k{}", i), std::to_string(generation));
+    }
+    trie.Commit(batch);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+}
+
+}  // namespace bustub
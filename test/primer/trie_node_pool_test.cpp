@@ -0,0 +1,93 @@
+#include <fmt/format.h>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "primer/trie.h"
+#include "primer/trie_node_pool.h"
+#include "primer/trie_store.h"
+
+namespace bustub {
+
+TEST(TrieNodePoolTest, BlocksAreReused) {
+  std::vector<void *> blocks;
+  for (size_t i = 0; i < 1000; i++) {
+    blocks.push_back(TrieNodePool::Allocate(48));
+  }
+  for (auto *block : blocks) {
+    TrieNodePool::Deallocate(block, 48);
+  }
+  auto slabs = TrieNodePool::SlabCount();
+  for (size_t round = 0; round < 10; round++) {
+    blocks.clear();
+    for (size_t i = 0; i < 1000; i++) {
+      blocks.push_back(TrieNodePool::Allocate(48));
+    }
+    for (auto *block : blocks) {
+      TrieNodePool::Deallocate(block, 48);
+    }
+  }
+  ASSERT_EQ(TrieNodePool::SlabCount(), slabs);
+
+  // requests above the largest size class bypass the pool
+  auto *large = TrieNodePool::Allocate(TRIE_POOL_MAX_BLOCK + 1);
+  TrieNodePool::Deallocate(large, TRIE_POOL_MAX_BLOCK + 1);
+  ASSERT_EQ(TrieNodePool::SlabCount(), slabs);
+}
+
+TEST(TrieNodePoolTest, ChurnDoesNotGrow) {
+  // Dropping old versions returns their nodes to the pool, so repeated Put/Remove rounds reach a steady state.
+  auto trie = Trie();
+  size_t slabs = 0;
+  for (size_t round = 0; round < 20; round++) {
+    for (uint32_t i = 0; i < 1000; i++) {
+      trie = trie.Put<uint32_t>(fmt::format("{:#06}", i), i);
+    }
+    for (uint32_t i = 0; i < 1000; i++) {
+      ASSERT_EQ(*trie.Get<uint32_t>(fmt::format("{:#06}", i)), i);
+      trie = trie.Remove(fmt::format("{:#06}", i));
+    }
+    ASSERT_EQ(trie.GetRoot(), nullptr);
+    if (round == 1) {
+      slabs = TrieNodePool::SlabCount();
+    } else if (round > 1) {
+      ASSERT_EQ(TrieNodePool::SlabCount(), slabs);
+    }
+  }
+}
+
+TEST(TrieNodePoolTest, CrossThreadRelease) {
+  // Nodes allocated by writer threads are released by whichever thread drops the last snapshot, including after
+  // the writers have exited.
+  auto store = TrieStore();
+  std::vector<std::thread> threads;
+  for (size_t w = 0; w < 4; w++) {
+    threads.emplace_back([&store, w] {
+      for (uint32_t i = 0; i < 2000; i++) {
+        store.Put<std::string>(fmt::format("{}-{}", w, i), fmt::format("value-{}", i));
+        if (i % 3 == 0) {
+          store.Remove(fmt::format("{}-{}", w, i / 2));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t w = 0; w < 4; w++) {
+    for (uint32_t i = 1000; i < 2000; i++) {
+      auto guard = store.Get<std::string>(fmt::format("{}-{}", w, i));
+      ASSERT_TRUE(guard);
+      ASSERT_EQ(**guard, fmt::format("value-{}", i));
+    }
+  }
+  for (size_t w = 0; w < 4; w++) {
+    for (uint32_t i = 0; i < 2000; i++) {
+      store.Remove(fmt::format("{}-{}", w, i));
+    }
+  }
+  ASSERT_FALSE(store.Get<std::string>("0-1999"));
+}
+
+}  // namespace bustub
@@ -0,0 +1,111 @@
+#include <fmt/format.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "primer/trie_store.h"
+
+namespace bustub {
+
+namespace {
+
+// Run `writers` threads that each put and then remove their own disjoint key range while `readers` threads
+// keep looking up keys, and report the write and read throughput.
+void RunContention(size_t writers, size_t readers, uint32_t keys_per_writer) {
+  auto store = TrieStore();
+  std::atomic<bool> done{false};
+  std::atomic<uint64_t> reads{0};
+  std::vector<std::thread> threads;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t w = 0; w < writers; w++) {
+    threads.emplace_back([&store, w, keys_per_writer] {
+      for (uint32_t i = 0; i < keys_per_writer; i++) {
+        store.Put<uint32_t>(fmt::format("{}-{:#06}", w, i), i);
+      }
+      for (uint32_t i = 0; i < keys_per_writer; i += 2) {
+        store.Remove(fmt::format("{}-{:#06}", w, i));
+      }
+    });
+  }
+  for (size_t r = 0; r < readers; r++) {
+    threads.emplace_back([&store, &done, &reads, writers, keys_per_writer, r] {
+      uint64_t local_reads = 0;
+      uint32_t i = r;
+      while (!done.load()) {
+        auto guard = store.Get<uint32_t>(fmt::format("{}-{:#06}", i % writers, i % keys_per_writer));
+        if (guard != std::nullopt) {
+          EXPECT_EQ(**guard, i % keys_per_writer);
+        }
+        local_reads++;
+        i += 7;
+      }
+      reads += local_reads;
+    });
+  }
+  for (size_t w = 0; w < writers; w++) {
+    threads[w].join();
+  }
+  auto write_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  done = true;
+  for (size_t r = 0; r < readers; r++) {
+    threads[writers + r].join();
+  }
+
+  auto writes = writers * (keys_per_writer + (keys_per_writer + 1) / 2);
+  auto elapsed = std::max<int64_t>(write_ms.count(), 1);
+  fmt::print(stderr, "[contention] writers={} readers={} writes={} reads={} elapsed_ms={} write_ops/s={:.0f}\n",
+             writers, readers, writes, reads.load(), elapsed, static_cast<double>(writes) * 1000 / elapsed);
+
+  // no update may be lost when writers race on the root
+  for (size_t w = 0; w < writers; w++) {
+    for (uint32_t i = 0; i < keys_per_writer; i++) {
+      auto guard = store.Get<uint32_t>(fmt::format("{}-{:#06}", w, i));
+      if (i % 2 == 0) {
+        ASSERT_EQ(guard, std::nullopt);
+      } else {
+        ASSERT_NE(guard, std::nullopt);
+        ASSERT_EQ(**guard, i);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(TrieStoreContentionTest, SingleWriter) { RunContention(1, 2, 4000); }
+
+TEST(TrieStoreContentionTest, DisjointWriters) {
+  RunContention(2, 2, 2000);
+  RunContention(4, 2, 1000);
+  RunContention(8, 2, 500);
+}
+
+TEST(TrieStoreContentionTest, SameKeyWriters) {
+  auto store = TrieStore();
+  std::vector<std::thread> threads;
+  for (uint32_t w = 0; w < 4; w++) {
+    threads.emplace_back([&store, w] {
+      for (uint32_t i = 0; i < 1000; i++) {
+        store.Put<uint32_t>("hot", w * 1000 + i);
+        store.Put<uint32_t>(fmt::format("own-{}", w), i);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto hot = store.Get<uint32_t>("hot");
+  ASSERT_NE(hot, std::nullopt);
+  EXPECT_EQ(**hot % 1000, 999);
+  for (uint32_t w = 0; w < 4; w++) {
+    auto own = store.Get<uint32_t>(fmt::format("own-{}", w));
+    ASSERT_NE(own, std::nullopt);
+    EXPECT_EQ(**own, 999);
+  }
+}
+
+}  // namespace bustub
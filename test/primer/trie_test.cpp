@@ -1,6 +1,7 @@
 #include <fmt/format.h>
 #include <bitset>
 #include <functional>
+#include <map>
 #include <numeric>
 #include <optional>
 #include <random>
@@ -250,4 +251,208 @@ TEST(TrieTest, PointerStability) {
   ASSERT_EQ(reinterpret_cast<uint64_t>(ptr_before), reinterpret_cast<uint64_t>(ptr_after));
 }
 
+TEST(TrieTest, PathCompressionTest) {
+  auto trie = Trie();
+  trie = trie.Put<uint32_t>("hello", 1);
+  // a single key is one leaf below the root holding the rest of the key
+  auto root = trie.GetRoot();
+  ASSERT_EQ(root->children_.Size(), 1);
+  auto leaf = *root->children_.Find('h');
+  ASSERT_EQ(leaf->prefix_, "ello");
+  ASSERT_TRUE(leaf->children_.Empty());
+
+  // splitting the compressed path keeps the old snapshot intact
+  auto split = trie.Put<uint32_t>("help", 2);
+  auto inner = *split.GetRoot()->children_.Find('h');
+  ASSERT_EQ(inner->prefix_, "el");
+  ASSERT_FALSE(inner->is_value_node_);
+  ASSERT_EQ(inner->children_.Size(), 2);
+  ASSERT_EQ((*inner->children_.Find('l'))->prefix_, "o");
+  ASSERT_EQ((*inner->children_.Find('p'))->prefix_, "");
+  ASSERT_EQ(*split.Get<uint32_t>("hello"), 1);
+  ASSERT_EQ(*split.Get<uint32_t>("help"), 2);
+  ASSERT_EQ(split.Get<uint32_t>("hel"), nullptr);
+  ASSERT_EQ(split.Get<uint32_t>("hellos"), nullptr);
+  ASSERT_EQ(trie.Get<uint32_t>("help"), nullptr);
+  ASSERT_EQ((*trie.GetRoot()->children_.Find('h'))->prefix_, "ello");
+
+  // removing a key merges the single remaining child back into its parent
+  auto merged = split.Remove("help");
+  leaf = *merged.GetRoot()->children_.Find('h');
+  ASSERT_EQ(leaf->prefix_, "ello");
+  ASSERT_EQ(*merged.Get<uint32_t>("hello"), 1);
+  ASSERT_EQ(merged.Remove("hello").GetRoot(), nullptr);
+}
+
+TEST(TrieTest, DenseChildrenTest) {
+  auto trie = Trie();
+  for (int c = 0; c < 256; c++) {
+    trie = trie.Put<uint32_t>(std::string(1, static_cast<char>(c)) + "x", c);
+    ASSERT_EQ(trie.GetRoot()->children_.IsDense(), static_cast<size_t>(c) >= TRIE_SPARSE_MAX_CHILDREN);
+  }
+  std::vector<int> order;
+  trie.GetRoot()->children_.ForEach(
+      [&order](char c, const std::shared_ptr<const TrieNode> &child) { order.push_back(static_cast<uint8_t>(c)); });
+  std::vector<int> expected(256);
+  std::iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(order, expected);
+
+  for (int c = 255; c >= 0; c--) {
+    ASSERT_EQ(*trie.Get<uint32_t>(std::string(1, static_cast<char>(c)) + "x"), c);
+    trie = trie.Remove(std::string(1, static_cast<char>(c)) + "x");
+    if (c > 0) {
+      ASSERT_EQ(trie.GetRoot()->children_.IsDense(), static_cast<size_t>(c) > TRIE_DENSE_MIN_CHILDREN);
+    }
+  }
+  ASSERT_EQ(trie.GetRoot(), nullptr);
+}
+
+TEST(TrieTest, RandomModelTest) {
+  std::mt19937 gen(23333);
+  std::map<std::string, uint32_t> model;
+  std::vector<std::pair<Trie, std::map<std::string, uint32_t>>> snapshots;
+  auto trie = Trie();
+  // a small alphabet produces long shared prefixes, splits and merges
+  auto random_key = [&gen]() {
+    std::string key(gen() % 8, 'a');
+    for (auto &c : key) {
+      c = static_cast<char>('a' + gen() % 3);
+    }
+    return key;
+  };
+  for (uint32_t i = 0; i < 20000; i++) {
+    auto key = random_key();
+    if (gen() % 3 == 0) {
+      trie = trie.Remove(key);
+      model.erase(key);
+    } else {
+      trie = trie.Put<uint32_t>(key, i);
+      model[key] = i;
+    }
+    if (i % 2000 == 0) {
+      snapshots.emplace_back(trie, model);
+    }
+  }
+  snapshots.emplace_back(trie, model);
+  for (const auto &[snapshot, expected] : snapshots) {
+    for (uint32_t i = 0; i < 3000; i++) {
+      auto key = random_key();
+      auto it = expected.find(key);
+      const auto *value = snapshot.Get<uint32_t>(key);
+      if (it == expected.end()) {
+        ASSERT_EQ(value, nullptr) << key;
+      } else {
+        ASSERT_NE(value, nullptr) << key;
+        ASSERT_EQ(*value, it->second) << key;
+      }
+    }
+  }
+}
+
+TEST(TrieTest, IteratorTest) {
+  auto trie = Trie();
+  ASSERT_TRUE(trie.Begin().IsEnd());
+  trie = trie.Put<uint32_t>("test", 1);
+  trie = trie.Put<std::string>("te", "2");
+  trie = trie.Put<uint32_t>("", 0);
+  trie = trie.Put<uint32_t>("tea", 3);
+  trie = trie.Put<uint32_t>("b", 4);
+  trie = trie.Put<uint32_t>(std::string("\xff", 1), 5);
+
+  std::vector<std::string> keys;
+  for (auto it = trie.Begin(); it != trie.End(); ++it) {
+    keys.push_back(it.Key());
+  }
+  std::vector<std::string> expected{"", "b", "te", "tea", "test", std::string("\xff", 1)};
+  ASSERT_EQ(keys, expected);
+
+  auto it = trie.PrefixScan("te");
+  ASSERT_EQ(it.Key(), "te");
+  ASSERT_EQ(it.Value<uint32_t>(), nullptr);
+  ASSERT_EQ(*it.Value<std::string>(), "2");
+  ++it;
+  ASSERT_EQ(it.Key(), "tea");
+  ASSERT_EQ(*it.Value<uint32_t>(), 3);
+
+  // the iterator holds its snapshot
+  trie = trie.Remove("tea").Remove("test");
+  ++it;
+  ASSERT_EQ(it.Key(), "test");
+  ++it;
+  ASSERT_TRUE(it.IsEnd());
+  ASSERT_TRUE(trie.PrefixScan("tes").IsEnd());
+}
+
+TEST(TrieTest, PrefixScanTest) {
+  auto trie = Trie();
+  for (uint32_t tenant = 0; tenant < 200; tenant++) {
+    for (uint32_t i = 0; i < 5; i++) {
+      trie = trie.Put<uint32_t>(fmt::format("tenant/{}/{}", tenant, i), tenant * 10 + i);
+    }
+  }
+  std::vector<uint32_t> values;
+  for (auto it = trie.PrefixScan("tenant/12/"); !it.IsEnd(); ++it) {
+    values.push_back(*it.Value<uint32_t>());
+  }
+  ASSERT_EQ(values, std::vector<uint32_t>({120, 121, 122, 123, 124}));
+
+  // the prefix ends inside a compressed path
+  values.clear();
+  for (auto it = trie.PrefixScan("tenant/12"); !it.IsEnd(); ++it) {
+    values.push_back(*it.Value<uint32_t>());
+  }
+  ASSERT_EQ(values.size(), 55);
+  ASSERT_EQ(values.front(), 120);
+
+  values.clear();
+  for (auto it = trie.PrefixScan("tenant/1", 7); !it.IsEnd(); ++it) {
+    values.push_back(*it.Value<uint32_t>());
+  }
+  ASSERT_EQ(values, std::vector<uint32_t>({10, 11, 12, 13, 14, 100, 101}));
+
+  ASSERT_TRUE(trie.PrefixScan("tenant/12/5").IsEnd());
+  ASSERT_TRUE(trie.PrefixScan("tenant/x").IsEnd());
+  ASSERT_TRUE(trie.PrefixScan("tenant/1", 0).IsEnd());
+}
+
+TEST(TrieTest, RandomScanModelTest) {
+  std::mt19937 gen(15445);
+  std::map<std::string, uint32_t> model;
+  auto trie = Trie();
+  auto random_key = [&gen]() {
+    std::string key(gen() % 6, 'a');
+    for (auto &c : key) {
+      c = static_cast<char>(gen() % 2 == 0 ? 'a' + gen() % 3 : 0x80 + gen() % 40);
+    }
+    return key;
+  };
+  for (uint32_t i = 0; i < 5000; i++) {
+    auto key = random_key();
+    if (gen() % 4 == 0) {
+      trie = trie.Remove(key);
+      model.erase(key);
+    } else {
+      trie = trie.Put<uint32_t>(key, i);
+      model[key] = i;
+    }
+  }
+  // std::string compares chars as unsigned bytes, the same order as the trie
+  for (uint32_t i = 0; i < 500; i++) {
+    auto prefix = random_key().substr(0, gen() % 3);
+    size_t limit = gen() % 50;
+    std::vector<std::pair<std::string, uint32_t>> expected;
+    for (auto it = model.lower_bound(prefix); it != model.end() && expected.size() < limit; ++it) {
+      if (it->first.compare(0, prefix.size(), prefix) != 0) {
+        break;
+      }
+      expected.emplace_back(it->first, it->second);
+    }
+    std::vector<std::pair<std::string, uint32_t>> scanned;
+    for (auto it = trie.PrefixScan(prefix, limit); !it.IsEnd(); ++it) {
+      scanned.emplace_back(it.Key(), *it.Value<uint32_t>());
+    }
+    ASSERT_EQ(scanned, expected);
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree_test.cpp
+//
+// Identification: test/storage/adaptive_radix_tree_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <array>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "common/rid.h"
+#include "gtest/gtest.h"
+#include "storage/index/adaptive_radix_tree.h"
+
+namespace bustub {
+
+namespace {
+
+template <size_t KeySize>
+auto MakeKey(uint64_t value) -> std::array<uint8_t, KeySize> {
+  std::array<uint8_t, KeySize> key{};
+  // store big-endian at the end so keys share a long common prefix
+  for (size_t i = 0; i < sizeof(uint64_t); i++) {
+    key[KeySize - 1 - i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+  return key;
+}
+
+template <size_t KeySize>
+void RunRandomWorkload(uint64_t key_range, int rounds) {
+  AdaptiveRadixTree<RID> tree(KeySize);
+  std::map<uint64_t, RID> expected;
+  std::mt19937_64 rng(KeySize);
+
+  for (int i = 0; i < rounds; i++) {
+    uint64_t value = rng() % key_range;
+    auto key = MakeKey<KeySize>(value);
+    if (rng() % 3 == 0) {
+      EXPECT_EQ(tree.Remove(key.data()), expected.erase(value) == 1);
+    } else {
+      RID rid(static_cast<page_id_t>(value >> 16), static_cast<uint32_t>(value & 0xFFFF));
+      bool inserted = expected.emplace(value, rid).second;
+      EXPECT_EQ(tree.Insert(key.data(), rid), inserted);
+    }
+  }
+  ASSERT_EQ(tree.Size(), expected.size());
+
+  for (uint64_t value = 0; value < key_range; value++) {
+    auto key = MakeKey<KeySize>(value);
+    RID rid;
+    auto it = expected.find(value);
+    ASSERT_EQ(tree.GetValue(key.data(), &rid), it != expected.end());
+    if (it != expected.end()) {
+      EXPECT_EQ(rid, it->second);
+    }
+  }
+
+  for (const auto &[value, rid] : expected) {
+    auto key = MakeKey<KeySize>(value);
+    EXPECT_TRUE(tree.Remove(key.data()));
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+}
+
+}  // namespace
+
+TEST(AdaptiveRadixTreeTest, BasicTest) {
+  AdaptiveRadixTree<RID> tree(8);
+  auto key1 = MakeKey<8>(1);
+  auto key2 = MakeKey<8>(2);
+  RID rid;
+
+  EXPECT_FALSE(tree.GetValue(key1.data(), &rid));
+  EXPECT_TRUE(tree.Insert(key1.data(), RID(1, 1)));
+  EXPECT_FALSE(tree.Insert(key1.data(), RID(1, 2)));
+  EXPECT_TRUE(tree.Insert(key2.data(), RID(2, 2)));
+  EXPECT_TRUE(tree.GetValue(key1.data(), &rid));
+  EXPECT_EQ(rid, RID(1, 1));
+  EXPECT_TRUE(tree.GetValue(key2.data(), &rid));
+  EXPECT_EQ(rid, RID(2, 2));
+
+  EXPECT_TRUE(tree.Remove(key1.data()));
+  EXPECT_FALSE(tree.Remove(key1.data()));
+  EXPECT_FALSE(tree.GetValue(key1.data(), &rid));
+  EXPECT_TRUE(tree.GetValue(key2.data(), &rid));
+  EXPECT_TRUE(tree.Remove(key2.data()));
+  EXPECT_TRUE(tree.IsEmpty());
+}
+
+TEST(AdaptiveRadixTreeTest, NodeGrowAndShrinkTest) {
+  // every inner node type on the last byte, then back down
+  AdaptiveRadixTree<RID> tree(8);
+  for (uint64_t value = 0; value < 256; value++) {
+    auto key = MakeKey<8>(value);
+    EXPECT_TRUE(tree.Insert(key.data(), RID(0, value)));
+  }
+  for (uint64_t value = 0; value < 256; value++) {
+    auto key = MakeKey<8>(value);
+    RID rid;
+    EXPECT_TRUE(tree.GetValue(key.data(), &rid));
+    EXPECT_EQ(rid.GetSlotNum(), value);
+  }
+  for (uint64_t value = 0; value < 255; value++) {
+    auto key = MakeKey<8>(value);
+    EXPECT_TRUE(tree.Remove(key.data()));
+    for (uint64_t rest = value + 1; rest < 256; rest += 17) {
+      auto rest_key = MakeKey<8>(rest);
+      EXPECT_TRUE(tree.GetValue(rest_key.data(), nullptr));
+    }
+  }
+  EXPECT_EQ(tree.Size(), 1);
+}
+
+TEST(AdaptiveRadixTreeTest, RandomTest) {
+  RunRandomWorkload<8>(5000, 20000);
+  // long shared prefixes exceed ART_MAX_PREFIX_LEN and need the leaf to compare
+  RunRandomWorkload<32>(5000, 20000);
+  RunRandomWorkload<64>(1 << 20, 20000);
+}
+
+}  // namespace bustub
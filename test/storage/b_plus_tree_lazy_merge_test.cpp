@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_lazy_merge_test.cpp
+//
+// Identification: test/storage/b_plus_tree_lazy_merge_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+namespace {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+// Scan the whole tree and check it holds exactly the expected keys in order.
+void CheckScan(Tree *tree, const std::vector<int64_t> &expected) {
+  std::vector<int64_t> scanned;
+  for (auto iterator = tree->Begin(); iterator != tree->End(); ++iterator) {
+    scanned.push_back((*iterator).second.GetSlotNum());
+  }
+  EXPECT_EQ(scanned, expected);
+
+  GenericKey<8> index_key;
+  std::vector<RID> rids;
+  for (auto key : expected) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree->GetValue(index_key, &rids));
+    ASSERT_EQ(rids.size(), 1);
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+}
+
+}  // namespace
+
+TEST(BPlusTreeLazyMergeTest, DeferredMerge) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4, 5);
+  GenericKey<8> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+
+  // Keep the background thread out of the way so the deferred state can be observed.
+  auto merge_interval = b_plus_tree_merge_interval;
+  b_plus_tree_merge_interval = std::chrono::milliseconds(60000);
+
+  for (int64_t key = 1; key <= 200; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  tree.StartLazyMerge(2);
+  // Starting again keeps the running thread and its threshold.
+  tree.StartLazyMerge(3);
+  // Empty out whole leaves at the front and in the middle, and thin out the rest.
+  std::vector<int64_t> expected;
+  for (int64_t key = 1; key <= 200; key++) {
+    if (key <= 40 || (key > 100 && key <= 140) || key % 5 != 0) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, transaction);
+    } else {
+      expected.push_back(key);
+    }
+  }
+  CheckScan(&tree, expected);
+
+  // Stopping compacts the pages the lazy deletes left behind.
+  tree.StopLazyMerge();
+  CheckScan(&tree, expected);
+
+  for (auto key : expected) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  b_plus_tree_merge_interval = merge_interval;
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(BPlusTreeLazyMergeTest, BackgroundMerge) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4, 5);
+  GenericKey<8> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+
+  auto merge_interval = b_plus_tree_merge_interval;
+  b_plus_tree_merge_interval = std::chrono::milliseconds(1);
+
+  for (int64_t key = 1; key <= 400; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  tree.StartLazyMerge(2);
+  // Delete odd keys from one thread and multiples of four from another while the merge thread runs.
+  std::vector<std::thread> threads;
+  for (int64_t start : {1, 4}) {
+    threads.emplace_back([&tree, start] {
+      GenericKey<8> remove_key;
+      int64_t step = start == 1 ? 2 : 4;
+      for (int64_t key = start; key <= 400; key += step) {
+        remove_key.SetFromInteger(key);
+        tree.Remove(remove_key, nullptr);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  tree.StopLazyMerge();
+
+  std::vector<int64_t> expected;
+  for (int64_t key = 2; key <= 400; key += 4) {
+    expected.push_back(key);
+  }
+  CheckScan(&tree, expected);
+
+  b_plus_tree_merge_interval = merge_interval;
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,482 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/free_space_map.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto MakeTuple(const Schema &schema, int32_t id, size_t payload) -> Tuple {
+  std::vector<Value> values{ValueFactory::GetIntegerValue(id),
+                            ValueFactory::GetVarcharValue(std::string(payload, static_cast<char>('a' + id % 26)))};
+  return {values, &schema};
+}
+
+auto CountPages(BufferPoolManager *bpm, TableHeap *table) -> size_t {
+  size_t pages = 0;
+  for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID; pages++) {
+    auto guard = bpm->FetchPageRead(page_id);
+    page_id = guard.As<TablePage>()->GetNextPageId();
+  }
+  return pages;
+}
+
+}  // namespace
+
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  FreeSpaceMap fsm;
+  ASSERT_EQ(fsm.Find(1), INVALID_PAGE_ID);
+  fsm.Update(3, 100);
+  fsm.Update(5, 1000);
+  fsm.Update(7, 1000);
+  // free space is rounded down to FSM_CATEGORY_SIZE, requests are rounded up
+  ASSERT_EQ(fsm.Find(96), 3);
+  ASSERT_EQ(fsm.Find(97), 5);
+  ASSERT_EQ(fsm.Find(1000), INVALID_PAGE_ID);
+  fsm.Update(5, 0);
+  ASSERT_EQ(fsm.Find(97), 7);
+  fsm.Update(3, 4000);
+  ASSERT_EQ(fsm.Find(2000), 3);
+  ASSERT_EQ(fsm.Size(), 3);
+}
+
+TEST(TableHeapTest, VacuumReusesSpace) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  Schema schema({Column("id", TypeId::INTEGER), Column("payload", TypeId::VARCHAR, 128)});
+  TableHeap table(bpm.get());
+  TupleMeta live_meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  std::vector<RID> rids;
+  for (int32_t id = 0; id < 1000; id++) {
+    rids.push_back(*table.InsertTuple(live_meta, MakeTuple(schema, id, id % 100)));
+  }
+  auto pages = CountPages(bpm.get(), &table);
+
+  // delete two out of every three tuples
+  for (int32_t id = 0; id < 1000; id++) {
+    if (id % 3 != 0) {
+      table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[id]);
+    }
+  }
+  ASSERT_EQ(table.Vacuum(), 666);
+  ASSERT_EQ(table.Vacuum(), 0);
+
+  // live tuples keep their RIDs and contents
+  for (int32_t id = 0; id < 1000; id += 3) {
+    auto [meta, tuple] = table.GetTuple(rids[id]);
+    ASSERT_FALSE(meta.is_deleted_);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), id);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(id % 100, static_cast<char>('a' + id % 26)));
+  }
+
+  // the freed space takes as many new tuples without growing the heap
+  for (int32_t id = 1000; id < 1600; id++) {
+    auto rid = table.InsertTuple(live_meta, MakeTuple(schema, id, id % 100));
+    ASSERT_TRUE(rid.has_value());
+    ASSERT_LT(rid->GetPageId(), rids.back().GetPageId() + 1);
+    auto [meta, tuple] = table.GetTuple(*rid);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), id);
+  }
+  ASSERT_EQ(CountPages(bpm.get(), &table), pages);
+
+  size_t live = 0;
+  for (auto it = table.MakeIterator(); !it.IsEnd(); ++it) {
+    if (!it.GetTuple().first.is_deleted_) {
+      live++;
+    }
+  }
+  ASSERT_EQ(live, 334 + 600);
+}
+
+TEST(TableHeapTest, SmallTuplesFillHoles) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  Schema schema({Column("id", TypeId::INTEGER), Column("payload", TypeId::VARCHAR, 1024)});
+  TableHeap table(bpm.get());
+  TupleMeta live_meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  // large tuples fill pages leaving small holes, which later small tuples use before the heap grows
+  std::vector<RID> rids;
+  for (int32_t id = 0; id < 30; id++) {
+    rids.push_back(*table.InsertTuple(live_meta, MakeTuple(schema, id, 900)));
+  }
+  auto pages = CountPages(bpm.get(), &table);
+  bool used_first_page = false;
+  for (int32_t id = 100; id < 150; id++) {
+    auto rid = table.InsertTuple(live_meta, MakeTuple(schema, id, 10));
+    used_first_page = used_first_page || rid->GetPageId() == rids.front().GetPageId();
+  }
+  ASSERT_TRUE(used_first_page);
+  ASSERT_EQ(CountPages(bpm.get(), &table), pages);
+}
+
+TEST(TableHeapTest, ConcurrentInsert) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(100, disk_manager.get());
+  Schema schema({Column("id", TypeId::INTEGER), Column("payload", TypeId::VARCHAR, 128)});
+  TableHeap table(bpm.get());
+  TupleMeta live_meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  const int32_t threads = 8;
+  const int32_t per_thread = 1000;
+  std::vector<std::vector<RID>> rids(threads);
+  std::vector<std::thread> workers;
+  for (int32_t t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      for (int32_t i = 0; i < per_thread; i++) {
+        int32_t id = t * per_thread + i;
+        rids[t].push_back(*table.InsertTuple(live_meta, MakeTuple(schema, id, id % 64)));
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  std::set<int64_t> unique;
+  for (int32_t t = 0; t < threads; t++) {
+    for (int32_t i = 0; i < per_thread; i++) {
+      int32_t id = t * per_thread + i;
+      ASSERT_TRUE(unique.insert(rids[t][i].Get()).second);
+      auto [meta, tuple] = table.GetTuple(rids[t][i]);
+      ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), id);
+      ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(id % 64, static_cast<char>('a' + id % 26)));
+    }
+  }
+
+  size_t scanned = 0;
+  for (auto it = table.MakeIterator(); !it.IsEnd(); ++it) {
+    ASSERT_EQ(unique.count(it.GetRID().Get()), 1);
+    scanned++;
+  }
+  ASSERT_EQ(scanned, threads * per_thread);
+}
+
+TEST(TableHeapTest, VariableLengthUpdate) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  Schema schema({Column("id", TypeId::INTEGER), Column("payload", TypeId::VARCHAR, 2048)});
+  TableHeap table(bpm.get());
+  TupleMeta live_meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  // four tuples fill the first page
+  std::vector<RID> rids;
+  for (int32_t id = 0; id < 4; id++) {
+    rids.push_back(*table.InsertTuple(live_meta, MakeTuple(schema, id, 900)));
+    ASSERT_EQ(rids.back().GetPageId(), table.GetFirstPageId());
+  }
+  auto check = [&](int32_t id, size_t payload) {
+    auto [meta, tuple] = table.GetTuple(rids[id]);
+    ASSERT_FALSE(meta.is_deleted_);
+    ASSERT_EQ(tuple.GetRid(), rids[id]);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), id);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(payload, static_cast<char>('a' + id % 26)));
+  };
+  auto forward_of = [&](int32_t id) {
+    auto guard = bpm->FetchPageRead(rids[id].GetPageId());
+    return guard.As<TablePage>()->GetForward(rids[id]);
+  };
+
+  // shrinking overwrites the old tuple, growing uses the space it left
+  table.UpdateTuple(live_meta, MakeTuple(schema, 0, 10), rids[0]);
+  table.UpdateTuple(live_meta, MakeTuple(schema, 1, 1200), rids[1]);
+  ASSERT_EQ(forward_of(0), std::nullopt);
+  ASSERT_EQ(forward_of(1), std::nullopt);
+
+  // too large for the page: the slot forwards to a moved tuple
+  table.UpdateTuple(live_meta, MakeTuple(schema, 2, 2000), rids[2]);
+  auto forward = forward_of(2);
+  ASSERT_TRUE(forward.has_value());
+  ASSERT_NE(forward->GetPageId(), table.GetFirstPageId());
+  check(0, 10);
+  check(1, 1200);
+  check(2, 2000);
+  check(3, 900);
+
+  // scans see each tuple once, under its original RID
+  std::vector<RID> scanned;
+  for (auto it = table.MakeIterator(); !it.IsEnd(); ++it) {
+    scanned.push_back(it.GetRID());
+  }
+  ASSERT_EQ(scanned, rids);
+
+  // a moved tuple that fits again goes back home
+  table.UpdateTuple(live_meta, MakeTuple(schema, 2, 20), rids[2]);
+  ASSERT_EQ(forward_of(2), std::nullopt);
+  check(2, 20);
+  ASSERT_TRUE(table.GetTupleMeta(*forward).is_deleted_);
+
+  // deleting a forwarded tuple frees the moved tuple too
+  table.UpdateTuple(live_meta, MakeTuple(schema, 2, 2000), rids[2]);
+  ASSERT_TRUE(forward_of(2).has_value());
+  table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[2]);
+  ASSERT_EQ(table.Vacuum(), 3);
+  scanned.clear();
+  for (auto it = table.MakeIterator(); !it.IsEnd(); ++it) {
+    if (!it.GetTuple().first.is_deleted_) {
+      scanned.push_back(it.GetRID());
+    }
+  }
+  ASSERT_EQ(scanned, std::vector<RID>({rids[0], rids[1], rids[3]}));
+  check(1, 1200);
+  check(3, 900);
+}
+
+TEST(TableHeapTest, OverflowValues) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  Schema schema({Column("id", TypeId::INTEGER), Column("payload", TypeId::VARCHAR, 100000),
+                 Column("note", TypeId::VARCHAR, 100)});
+  TableHeap table(bpm.get(), &schema);
+  TupleMeta live_meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  auto make_tuple = [&](int32_t id, size_t payload) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(id),
+                              ValueFactory::GetVarcharValue(std::string(payload, static_cast<char>('a' + id % 26))),
+                              ValueFactory::GetVarcharValue(std::to_string(id))};
+    return Tuple(values, &schema);
+  };
+
+  // values several pages long, and one that stays in the page
+  std::vector<RID> rids;
+  std::vector<size_t> payloads{20000, 10, 5000, 9000};
+  for (int32_t id = 0; id < 4; id++) {
+    auto rid = table.InsertTuple(live_meta, make_tuple(id, payloads[id]));
+    ASSERT_TRUE(rid.has_value());
+    rids.push_back(*rid);
+  }
+  auto check = [&](int32_t id) {
+    auto [meta, tuple] = table.GetTuple(rids[id]);
+    ASSERT_LE(tuple.GetLength(), TABLE_HEAP_OVERFLOW_THRESHOLD);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), id);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(payloads[id], static_cast<char>('a' + id % 26)));
+    ASSERT_EQ(tuple.GetValue(&schema, 2).ToString(), std::to_string(id));
+  };
+  for (int32_t id = 0; id < 4; id++) {
+    check(id);
+  }
+  ASSERT_EQ(table.GetTuple(rids[0]).second.GetOverflowPages(&schema).size(), 1);
+  ASSERT_TRUE(table.GetTuple(rids[1]).second.GetOverflowPages(&schema).empty());
+
+  // a stored tuple inserted again gets its own copy of the value
+  auto copy = table.InsertTuple(live_meta, table.GetTuple(rids[0]).second);
+  ASSERT_NE(table.GetTuple(*copy).second.GetOverflowPages(&schema),
+            table.GetTuple(rids[0]).second.GetOverflowPages(&schema));
+
+  payloads[0] = 30000;
+  table.UpdateTuple(live_meta, make_tuple(0, payloads[0]), rids[0]);
+  payloads[2] = 50;
+  table.UpdateTuple(live_meta, make_tuple(2, payloads[2]), rids[2]);
+  for (int32_t id = 0; id < 4; id++) {
+    check(id);
+  }
+
+  table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[3]);
+  table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, *copy);
+  ASSERT_EQ(table.Vacuum(), 2);
+  check(0);
+  check(1);
+  check(2);
+
+  // new values do not run into the freed overflow pages
+  for (int32_t id = 4; id < 8; id++) {
+    payloads.push_back(20000);
+    rids.push_back(*table.InsertTuple(live_meta, make_tuple(id, payloads[id])));
+  }
+  for (int32_t id = 0; id < 8; id++) {
+    if (id != 3) {
+      check(id);
+    }
+  }
+
+  // tuples without a table heap cannot read values stored out of line
+  auto [meta, stored] = table.GetTuple(rids[0]);
+  Tuple detached;
+  std::vector<char> buffer(sizeof(uint32_t) + stored.GetLength());
+  stored.SerializeTo(buffer.data());
+  detached.DeserializeFrom(buffer.data());
+  ASSERT_THROW(detached.GetValue(&schema, 1), Exception);
+  ASSERT_EQ(detached.GetValue(&schema, 2).ToString(), "0");
+}
+
+TEST(TableHeapTest, BatchViews) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  Schema schema({Column("id", TypeId::INTEGER), Column("payload", TypeId::VARCHAR, 5000)});
+  TableHeap table(bpm.get(), &schema);
+  TupleMeta live_meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  std::vector<RID> rids;
+  for (int32_t id = 0; id < 500; id++) {
+    rids.push_back(*table.InsertTuple(live_meta, MakeTuple(schema, id, 20)));
+  }
+  table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[3]);
+  // too large for its page, the slot forwards to a moved tuple that the batches must not return twice
+  table.UpdateTuple(live_meta, MakeTuple(schema, 10, 3000), rids[10]);
+
+  auto it = table.MakeIterator();
+  TupleBatch batch;
+  std::vector<RID> seen;
+  size_t deleted = 0;
+  while (it.NextBatch(&batch)) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      const auto &view = batch.GetTuple(i);
+      auto id = view.GetValue(&schema, 0).GetAs<int32_t>();
+      ASSERT_EQ(view.GetRid(), rids[id]);
+      auto payload = std::string(id == 10 ? 3000 : 20, static_cast<char>('a' + id % 26));
+      ASSERT_EQ(view.GetValue(&schema, 1).ToString(), payload);
+      deleted += batch.GetMeta(i).is_deleted_ ? 1 : 0;
+      seen.push_back(view.GetRid());
+    }
+  }
+  ASSERT_EQ(seen, rids);
+  ASSERT_EQ(deleted, 1);
+  batch.Release();
+
+  // a copy made from a view outlives the batch
+  // the rows of a batch are share-locked before the page is latched
+  LockManager lock_mgr{};
+  TransactionManager txn_mgr{&lock_mgr};
+  auto *txn = txn_mgr.Begin();
+  ASSERT_TRUE(lock_mgr.LockTable(txn, LockManager::LockMode::INTENTION_SHARED, 0));
+  auto first_page = table.MakeIterator();
+  ASSERT_TRUE(first_page.NextBatch(&batch, txn, &lock_mgr, 0));
+  ASSERT_EQ(txn->GetSharedRowLockSet()->at(0).size(), batch.Size());
+  for (size_t i = 0; i < batch.Size(); i++) {
+    ASSERT_TRUE(txn->IsRowSharedLocked(0, batch.GetTuple(i).GetRid()));
+  }
+  Tuple copy;
+  copy.CopyFrom(batch.GetTuple(1));
+  batch.Release();
+  ASSERT_EQ(copy.GetValue(&schema, 0).GetAs<int32_t>(), 1);
+  ASSERT_EQ(copy.GetRid(), rids[1]);
+  txn_mgr.Commit(txn);
+  delete txn;
+}
+
+TEST(TableHeapTest, ZoneMapSkipsPages) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  Schema schema({Column("id", TypeId::INTEGER), Column("payload", TypeId::VARCHAR, 5000)});
+  TableHeap table(bpm.get(), &schema);
+  TupleMeta live_meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  // ids grow with the insert order, like timestamps, so every page holds a narrow range
+  std::vector<RID> rids;
+  for (int32_t id = 0; id < 2000; id++) {
+    rids.push_back(*table.InsertTuple(live_meta, MakeTuple(schema, id, 100)));
+  }
+  size_t num_pages = CountPages(bpm.get(), &table);
+  ASSERT_GT(num_pages, 20);
+
+  auto scan = [&](std::vector<ZoneRange> ranges, size_t *pages_skipped) {
+    auto it = table.MakeIterator();
+    it.SetZoneRanges(std::move(ranges));
+    TupleBatch batch;
+    std::multiset<int32_t> ids;
+    while (it.NextBatch(&batch)) {
+      for (size_t i = 0; i < batch.Size(); i++) {
+        ids.insert(batch.GetTuple(i).GetValue(&schema, 0).GetAs<int32_t>());
+      }
+    }
+    *pages_skipped = it.GetPagesSkipped();
+    return ids;
+  };
+
+  // 1000 <= id < 1010 only touches one or two pages
+  ZoneRange range{0, ValueFactory::GetIntegerValue(1000), true, ValueFactory::GetIntegerValue(1010), false};
+  size_t pages_skipped;
+  auto ids = scan({range}, &pages_skipped);
+  for (int32_t id = 1000; id < 1010; id++) {
+    ASSERT_EQ(ids.count(id), 1);
+  }
+  ASSERT_GE(pages_skipped, num_pages - 2);
+  ASSERT_LT(ids.size(), 2000 / (num_pages - 2) * 2 + 1);
+
+  // an update widens the zone of the tuple's original page, even when the tuple has to move
+  table.UpdateTuple(live_meta, MakeTuple(schema, 1005, 20), rids[5]);
+  table.UpdateTuple(live_meta, MakeTuple(schema, 1006, 3000), rids[6]);
+  ids = scan({range}, &pages_skipped);
+  ASSERT_EQ(ids.count(1005), 2);
+  ASSERT_EQ(ids.count(1006), 2);
+  ASSERT_GE(pages_skipped, num_pages - 3);
+
+  // nothing can match an empty range, a scan without ranges skips nothing
+  ZoneRange empty{0, ValueFactory::GetIntegerValue(5000), true, std::nullopt, true};
+  ASSERT_TRUE(scan({empty}, &pages_skipped).empty());
+  ASSERT_EQ(pages_skipped, num_pages);
+  ASSERT_EQ(scan({}, &pages_skipped).size(), 2000);
+  ASSERT_EQ(pages_skipped, 0);
+}
+
+TEST(TableHeapTest, PaxColumnScan) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT), Column("c", TypeId::INTEGER)});
+  TableHeap table(bpm.get(), &schema, TableFormat::Pax);
+  TupleMeta live_meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  std::vector<RID> rids;
+  for (int32_t i = 0; i < 2000; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetBigIntValue(i * 10),
+                              ValueFactory::GetIntegerValue(-i)};
+    rids.push_back(*table.InsertTuple(live_meta, Tuple(values, &schema)));
+  }
+  ASSERT_GT(rids.back().GetPageId(), rids.front().GetPageId());
+  table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[7]);
+  std::vector<Value> updated{ValueFactory::GetIntegerValue(8), ValueFactory::GetBigIntValue(-1),
+                             ValueFactory::GetIntegerValue(0)};
+  table.UpdateTuple(live_meta, Tuple(updated, &schema), rids[8]);
+  ASSERT_EQ(table.GetTuple(rids[8]).second.GetValue(&schema, 1).GetAs<int64_t>(), -1);
+
+  // the row iterator and the column iterator see the same rows
+  size_t rows = 0;
+  for (auto it = table.MakeIterator(); !it.IsEnd(); ++it) {
+    rows += it.GetTuple().first.is_deleted_ ? 0 : 1;
+  }
+  ASSERT_EQ(rows, 1999);
+
+  auto column_it = table.MakeColumnIterator({2, 1});
+  ColumnBatch batch;
+  int64_t sum_b = 0;
+  int64_t sum_c = 0;
+  rows = 0;
+  while (column_it.Next(&batch)) {
+    ASSERT_EQ(batch.columns_.size(), 2);
+    for (size_t i = 0; i < batch.rids_.size(); i++) {
+      sum_c += batch.columns_[0][i].GetAs<int32_t>();
+      sum_b += batch.columns_[1][i].GetAs<int64_t>();
+    }
+    rows += batch.rids_.size();
+  }
+  ASSERT_EQ(rows, 1999);
+  ASSERT_EQ(sum_c, -(1999 * 1000) + 7 + 8);
+  ASSERT_EQ(sum_b, 1999 * 1000 * 10 - 70 - 81);
+
+  Schema varchar_schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 16)});
+  ASSERT_THROW(TableHeap(bpm.get(), &varchar_schema, TableFormat::Pax), Exception);
+}
+
+}  // namespace bustub
@@ -20,7 +20,10 @@
 #include "gtest/gtest.h"
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
+#include "common/util/hash_util.h"
 #include "storage/table/tuple.h"
+#include "type/dictionary.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -61,4 +64,97 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, InlineAndHeapStorageTest) {
+  Schema schema{std::vector<Column>{{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 128}}};
+  auto check = [&schema](const Tuple &tuple, int a, const std::string &b) {
+    EXPECT_EQ(a, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(b, tuple.GetValue(&schema, 1).ToString());
+  };
+  const std::string short_str = "ok";
+  const std::string long_str(100, 'x');
+  Tuple small({ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue(short_str)}, &schema);
+  Tuple large({ValueFactory::GetIntegerValue(2), ValueFactory::GetVarcharValue(long_str)}, &schema);
+  EXPECT_LE(small.GetLength(), TupleData::INLINE_SIZE);
+  EXPECT_GT(large.GetLength(), TupleData::INLINE_SIZE);
+
+  // copies and moves between inline and heap storage in both directions
+  Tuple copy = small;
+  check(copy, 1, short_str);
+  copy = large;
+  check(copy, 2, long_str);
+  Tuple moved = std::move(copy);
+  check(moved, 2, long_str);
+  moved = small;
+  check(moved, 1, short_str);
+  copy = std::move(moved);
+  check(copy, 1, short_str);
+  copy.CopyFrom(large.AsView());
+  check(copy, 2, long_str);
+  copy.CopyFrom(small.AsView());
+  check(copy, 1, short_str);
+
+  std::vector<char> storage(large.GetLength() + sizeof(int32_t));
+  large.SerializeTo(storage.data());
+  Tuple deserialized;
+  deserialized.DeserializeFrom(storage.data());
+  check(deserialized, 2, long_str);
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, DictionaryColumnTest) {
+  auto dictionary = std::make_shared<Dictionary>();
+  Schema schema({Column{"id", TypeId::INTEGER}, Column(Column{"status", TypeId::VARCHAR, 32}, dictionary),
+                 Column{"note", TypeId::VARCHAR, 32}});
+  ASSERT_TRUE(schema.GetColumn(1).IsInlined());
+  ASSERT_EQ(schema.GetUnlinedColumns().size(), 1);
+
+  std::string long_status = "a status longer than the inline values";
+  std::vector<std::string> statuses{"open", "closed", long_status, "open", "closed", "open"};
+  std::vector<Tuple> tuples;
+  for (size_t i = 0; i < statuses.size(); i++) {
+    tuples.emplace_back(std::vector<Value>{ValueFactory::GetIntegerValue(static_cast<int32_t>(i)),
+                                           ValueFactory::GetVarcharValue(statuses[i]),
+                                           ValueFactory::GetVarcharValue("note")},
+                        &schema);
+  }
+  // only distinct strings get a code
+  ASSERT_EQ(dictionary->Size(), 3);
+  ASSERT_EQ(tuples[0].GetLength(), tuples[2].GetLength());
+
+  for (size_t i = 0; i < statuses.size(); i++) {
+    auto value = tuples[i].GetValue(&schema, 1);
+    ASSERT_EQ(value.GetDictionaryId(), dictionary->GetId());
+    ASSERT_EQ(value.ToString(), statuses[i]);
+    ASSERT_EQ(tuples[i].GetValue(&schema, 2).ToString(), "note");
+    // the hash is cached in the dictionary, and it is the hash of the string
+    auto plain = ValueFactory::GetVarcharValue(statuses[i]);
+    ASSERT_EQ(plain.GetDictionaryId(), 0);
+    ASSERT_EQ(HashUtil::HashValue(&value), HashUtil::HashValue(&plain));
+    ASSERT_EQ(value.CompareEquals(plain), CmpBool::CmpTrue);
+  }
+
+  // values of the same dictionary are compared by their codes
+  auto open = tuples[0].GetValue(&schema, 1);
+  ASSERT_EQ(open.CompareEquals(tuples[5].GetValue(&schema, 1)), CmpBool::CmpTrue);
+  ASSERT_EQ(open.CompareEquals(tuples[1].GetValue(&schema, 1)), CmpBool::CmpFalse);
+  ASSERT_EQ(open.CompareNotEquals(tuples[4].GetValue(&schema, 1)), CmpBool::CmpTrue);
+  ASSERT_EQ(open.CompareLessThan(tuples[1].GetValue(&schema, 1)), CmpBool::CmpFalse);
+
+  // encoding a decoded value reuses its code, a copy still points into the dictionary
+  Value copy = open;
+  ASSERT_EQ(dictionary->Encode(copy), open.GetDictionaryCode());
+  ASSERT_EQ(dictionary->Lookup(ValueFactory::GetVarcharValue(long_status)),
+            tuples[2].GetValue(&schema, 1).GetDictionaryCode());
+  ASSERT_FALSE(dictionary->Lookup(ValueFactory::GetVarcharValue("lost")).has_value());
+  ASSERT_EQ(dictionary->Size(), 3);
+
+  // NULLs are stored as a reserved code
+  Tuple null_tuple({ValueFactory::GetIntegerValue(0), ValueFactory::GetNullValueByType(TypeId::VARCHAR),
+                    ValueFactory::GetVarcharValue("note")},
+                   &schema);
+  ASSERT_TRUE(null_tuple.IsNull(&schema, 1));
+  ASSERT_EQ(dictionary->Size(), 3);
+}
+
 }  // namespace bustub
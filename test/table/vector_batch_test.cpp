@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vector_batch_test.cpp
+//
+// Identification: test/table/vector_batch_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/table/vector_batch.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(VectorBatchTest, AppendAndReadTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}, Column{"c", TypeId::DECIMAL}});
+  VectorBatch batch;
+  batch.Reset(schema);
+  for (int32_t i = 0; i < 100; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i),
+                              ValueFactory::GetVarcharValue("row " + std::to_string(i) + " of the batch"),
+                              ValueFactory::GetDecimalValue(i * 0.5)};
+    if (i % 10 == 0) {
+      values[0] = ValueFactory::GetNullValueByType(TypeId::INTEGER);
+      values[1] = ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+    }
+    batch.AppendTuple(Tuple(values, &schema), schema);
+  }
+  ASSERT_EQ(100, batch.Size());
+
+  // 定长列可以直接当数组读
+  const auto &column = batch.GetColumn(0);
+  for (int32_t i = 0; i < 100; i++) {
+    ASSERT_EQ(i % 10 == 0, column.IsNull(i));
+    if (i % 10 != 0) {
+      ASSERT_EQ(i, column.GetData<int32_t>()[i]);
+      ASSERT_EQ(i, batch.GetValue(0, i).GetAs<int32_t>());
+    }
+  }
+  EXPECT_TRUE(batch.GetValue(1, 20).IsNull());
+  EXPECT_EQ("row 21 of the batch", batch.GetValue(1, 21).ToString());
+  EXPECT_DOUBLE_EQ(10.5, batch.GetValue(2, 21).GetAs<double>());
+
+  auto tuple = batch.GetTuple(21, schema);
+  EXPECT_EQ(21, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  EXPECT_EQ("row 21 of the batch", tuple.GetValue(&schema, 1).ToString());
+
+  // 按行挑出来拷到另一个批里
+  VectorBatch selected;
+  selected.Reset(schema);
+  for (size_t i = 0; i < batch.Size(); i += 7) {
+    selected.AppendRowFrom(batch, i);
+  }
+  ASSERT_EQ(15, selected.Size());
+  EXPECT_TRUE(selected.GetValue(0, 10).IsNull());
+  EXPECT_EQ(77, selected.GetValue(0, 11).GetAs<int32_t>());
+  EXPECT_EQ("row 77 of the batch", selected.GetValue(1, 11).ToString());
+
+  selected.Truncate(5);
+  EXPECT_EQ(5, selected.Size());
+  EXPECT_EQ(5, selected.GetColumn(1).Size());
+
+  // 类型相同的时候重置后可以复用
+  selected.Reset(schema);
+  EXPECT_EQ(0, selected.Size());
+  EXPECT_EQ(3, selected.GetColumnCount());
+}
+
+}  // namespace bustub
@@ -95,4 +95,30 @@ TEST(TypeTests, TemplateTest) {
   BPlusTreePage<Value, Value> node;
   node.GetInfo(val1, val2);
 }
+
+// NOLINTNEXTLINE
+TEST(TypeTests, VarcharStorageTest) {
+  // short strings are kept inside the Value, long ones on the heap
+  for (const auto &str : {std::string("abc"), std::string(15, 'a'), std::string(16, 'b'), std::string(200, 'c')}) {
+    Value val(TypeId::VARCHAR, str);
+    Value copy = val;
+    Value assigned(TypeId::INTEGER, 1);
+    assigned = copy;
+    EXPECT_EQ(str, val.ToString());
+    EXPECT_EQ(str, copy.ToString());
+    EXPECT_EQ(str, assigned.ToString());
+    EXPECT_EQ(val.CompareEquals(assigned), CmpBool::CmpTrue);
+
+    std::vector<char> storage(sizeof(uint32_t) + val.GetLength());
+    val.SerializeTo(storage.data());
+    EXPECT_EQ(str, Value::DeserializeFrom(storage.data(), TypeId::VARCHAR).ToString());
+  }
+
+  // a value that does not manage its data points to it even when it is short
+  const char *bytes = "xyz";
+  Value ref(TypeId::VARCHAR, bytes, 4, false);
+  EXPECT_EQ(bytes, ref.GetData());
+  Value ref_copy = ref;
+  EXPECT_EQ(bytes, ref_copy.GetData());
+}
 }  // namespace bustub
@@ -0,0 +1,387 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include <cpp_random_distributions/zipfian_int_distribution.h>
+
+#include "argparse/argparse.hpp"
+#include "binder/binder.h"
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/exception.h"
+#include "common/rid.h"
+#include "common/util/string_util.h"
+#include "fmt/format.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/generic_key.h"
+#include "test_util.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+auto ClockNs() -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static const size_t LRU_K_SIZE = 4;
+// Every worker may pin a root-to-leaf path plus a sibling and a freshly split page at the same time.
+static const size_t BUSTUB_BPM_FRAMES_PER_THREAD = 8;
+
+enum class KeyDistribution { Sequential, Uniform, Zipfian };
+
+auto DistributionName(KeyDistribution dist) -> std::string {
+  switch (dist) {
+    case KeyDistribution::Sequential:
+      return "sequential";
+    case KeyDistribution::Uniform:
+      return "uniform";
+    case KeyDistribution::Zipfian:
+      return "zipfian";
+  }
+  return "unknown";
+}
+
+auto ParseDistribution(const std::string &name) -> KeyDistribution {
+  if (name == "seq" || name == "sequential") {
+    return KeyDistribution::Sequential;
+  }
+  if (name == "uniform") {
+    return KeyDistribution::Uniform;
+  }
+  if (name == "zipf" || name == "zipfian") {
+    return KeyDistribution::Zipfian;
+  }
+  throw std::runtime_error(fmt::format("unknown key distribution: {}", name));
+}
+
+/**
+ * One cell of the benchmark matrix.
+ */
+struct BenchConfig {
+  size_t key_size_;
+  KeyDistribution dist_;
+  size_t read_pct_;
+  size_t threads_;
+  size_t bpm_size_;
+  size_t total_keys_;
+  uint64_t duration_ms_;
+};
+
+/**
+ * Aggregated result of one cell of the benchmark matrix.
+ */
+struct BenchResult {
+  uint64_t read_cnt_{0};
+  uint64_t write_cnt_{0};
+  uint64_t elapsed_ms_{0};
+  uint64_t p50_ns_{0};
+  uint64_t p99_ns_{0};
+  uint64_t p999_ns_{0};
+  uint64_t disk_reads_{0};
+  uint64_t disk_writes_{0};
+  size_t tree_pages_{0};
+};
+
+/**
+ * An unlimited in-memory disk that counts page traffic. The buffer pool only reads from disk on a miss, so the read
+ * counter is the buffer pool miss count, and the write counter is the number of dirty evictions.
+ */
+class CountingDiskManager : public bustub::DiskManagerUnlimitedMemory {
+ public:
+  void WritePage(bustub::page_id_t page_id, const char *page_data) override {
+    writes_.fetch_add(1, std::memory_order_relaxed);
+    auto max_page_id = max_page_id_.load(std::memory_order_relaxed);
+    while (page_id > max_page_id && !max_page_id_.compare_exchange_weak(max_page_id, page_id)) {
+    }
+    DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
+
+  void ReadPage(bustub::page_id_t page_id, char *page_data) override {
+    reads_.fetch_add(1, std::memory_order_relaxed);
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  void ResetCounters() {
+    reads_ = 0;
+    writes_ = 0;
+  }
+
+  std::atomic<uint64_t> reads_{0};
+  std::atomic<uint64_t> writes_{0};
+  std::atomic<bustub::page_id_t> max_page_id_{bustub::INVALID_PAGE_ID};
+};
+
+/**
+ * Per-thread key generator. Sequential workers walk disjoint slices of the key space in order, the other
+ * distributions draw from the whole key space.
+ */
+class KeyGenerator {
+ public:
+  KeyGenerator(KeyDistribution dist, size_t total_keys, size_t thread_id, size_t thread_cnt)
+      : dist_(dist),
+        total_keys_(total_keys),
+        cursor_(total_keys / thread_cnt * thread_id),
+        gen_(std::random_device{}()),
+        uniform_(0, total_keys - 1),
+        zipfian_(0, total_keys - 1, 0.99) {}
+
+  auto Next() -> size_t {
+    switch (dist_) {
+      case KeyDistribution::Sequential:
+        cursor_ = (cursor_ + 1) % total_keys_;
+        return cursor_;
+      case KeyDistribution::Uniform:
+        return uniform_(gen_);
+      case KeyDistribution::Zipfian:
+        return zipfian_(gen_);
+    }
+    return 0;
+  }
+
+  auto Percent() -> size_t { return percent_(gen_); }
+
+ private:
+  KeyDistribution dist_;
+  size_t total_keys_;
+  size_t cursor_;
+  std::default_random_engine gen_;
+  std::uniform_int_distribution<size_t> uniform_;
+  zipfian_int_distribution<size_t> zipfian_;
+  std::uniform_int_distribution<size_t> percent_{0, 99};
+};
+
+auto Percentile(std::vector<uint64_t> *sorted, double pct) -> uint64_t {
+  if (sorted->empty()) {
+    return 0;
+  }
+  auto idx = static_cast<size_t>(pct * static_cast<double>(sorted->size() - 1));
+  return (*sorted)[idx];
+}
+
+template <size_t KeySize>
+auto RunConfig(const BenchConfig &config) -> BenchResult {
+  using bustub::BufferPoolManager;
+  using bustub::page_id_t;
+  using KeyType = bustub::GenericKey<KeySize>;
+  using ComparatorType = bustub::GenericComparator<KeySize>;
+  using TreeType = bustub::BPlusTree<KeyType, bustub::RID, ComparatorType>;
+
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(config.bpm_size_, disk_manager.get(), LRU_K_SIZE);
+
+  auto key_schema = bustub::ParseCreateStatement("a bigint");
+  ComparatorType comparator(key_schema.get());
+
+  page_id_t header_page_id;
+  bpm->NewPageGuarded(&header_page_id);
+  TreeType index("bench_idx", header_page_id, bpm.get(), comparator);
+
+  for (size_t key = 0; key < config.total_keys_; key++) {
+    KeyType index_key;
+    bustub::RID rid(static_cast<page_id_t>(key), static_cast<uint32_t>(key));
+    index_key.SetFromInteger(key);
+    index.Insert(index_key, rid, nullptr);
+  }
+
+  // Flush so that every page allocated by the load phase has reached the disk and the tree size can be reported.
+  bpm->FlushAllPages();
+  BenchResult result;
+  result.tree_pages_ = disk_manager->max_page_id_ + 1;
+  disk_manager->ResetCounters();
+
+  std::mutex mutex;
+  std::vector<uint64_t> latencies;
+  std::vector<std::thread> threads;
+
+  auto start = ClockMs();
+  for (size_t thread_id = 0; thread_id < config.threads_; thread_id++) {
+    threads.emplace_back([thread_id, &config, &index, &mutex, &latencies, &result] {
+      KeyGenerator key_gen(config.dist_, config.total_keys_, thread_id, config.threads_);
+      std::vector<uint64_t> local_latencies;
+      std::vector<bustub::RID> rids;
+      KeyType index_key;
+      uint64_t read_cnt = 0;
+      uint64_t write_cnt = 0;
+      auto deadline = ClockMs() + config.duration_ms_;
+
+      while (ClockMs() < deadline) {
+        auto key = key_gen.Next();
+        index_key.SetFromInteger(key);
+        auto begin = ClockNs();
+        if (key_gen.Percent() < config.read_pct_) {
+          rids.clear();
+          index.GetValue(index_key, &rids);
+          read_cnt++;
+        } else {
+          // Replace the entry so that the tree size stays stable across the run.
+          bustub::RID rid(static_cast<page_id_t>(key), static_cast<uint32_t>(key));
+          index.Remove(index_key, nullptr);
+          index.Insert(index_key, rid, nullptr);
+          write_cnt++;
+        }
+        local_latencies.push_back(ClockNs() - begin);
+      }
+
+      std::unique_lock<std::mutex> l(mutex);
+      latencies.insert(latencies.end(), local_latencies.begin(), local_latencies.end());
+      result.read_cnt_ += read_cnt;
+      result.write_cnt_ += write_cnt;
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  result.elapsed_ms_ = std::max<uint64_t>(ClockMs() - start, 1);
+
+  std::sort(latencies.begin(), latencies.end());
+  result.p50_ns_ = Percentile(&latencies, 0.50);
+  result.p99_ns_ = Percentile(&latencies, 0.99);
+  result.p999_ns_ = Percentile(&latencies, 0.999);
+  result.disk_reads_ = disk_manager->reads_;
+  result.disk_writes_ = disk_manager->writes_;
+  return result;
+}
+
+auto RunConfig(const BenchConfig &config) -> BenchResult {
+  switch (config.key_size_) {
+    case 8:
+      return RunConfig<8>(config);
+    case 16:
+      return RunConfig<16>(config);
+    case 32:
+      return RunConfig<32>(config);
+    case 64:
+      return RunConfig<64>(config);
+    default:
+      throw std::runtime_error(fmt::format("unsupported key size: {}", config.key_size_));
+  }
+}
+
+auto ParseList(const std::string &str) -> std::vector<std::string> {
+  std::vector<std::string> items;
+  for (auto &item : bustub::StringUtil::Split(str, ',')) {
+    auto trimmed = bustub::StringUtil::Strip(item, ' ');
+    if (!trimmed.empty()) {
+      items.push_back(trimmed);
+    }
+  }
+  return items;
+}
+
+auto ParseSizeList(const std::string &str) -> std::vector<size_t> {
+  std::vector<size_t> values;
+  for (auto &item : ParseList(str)) {
+    values.push_back(std::stoul(item));
+  }
+  return values;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-btree-matrix-bench");
+  program.add_argument("--duration").help("run each configuration for n milliseconds");
+  program.add_argument("--total-keys").help("number of keys loaded into the tree before each run");
+  program.add_argument("--key-sizes").help("comma separated GenericKey sizes, e.g. 8,16,32,64");
+  program.add_argument("--dists").help("comma separated key distributions: seq,uniform,zipf");
+  program.add_argument("--read-pcts").help("comma separated read percentages, e.g. 100,95,50,0");
+  program.add_argument("--threads").help("comma separated worker thread counts, e.g. 1,2,4,8");
+  program.add_argument("--bpm-sizes").help("comma separated buffer pool sizes in frames");
+  program.add_argument("--output").help("write the CSV report to this file instead of stdout");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t duration_ms = 2000;
+  if (program.present("--duration")) {
+    duration_ms = std::stoi(program.get("--duration"));
+  }
+  size_t total_keys = 100000;
+  if (program.present("--total-keys")) {
+    total_keys = std::stoul(program.get("--total-keys"));
+  }
+  std::vector<size_t> key_sizes{8, 64};
+  if (program.present("--key-sizes")) {
+    key_sizes = ParseSizeList(program.get("--key-sizes"));
+  }
+  std::vector<KeyDistribution> dists{KeyDistribution::Sequential, KeyDistribution::Uniform, KeyDistribution::Zipfian};
+  if (program.present("--dists")) {
+    dists.clear();
+    for (auto &name : ParseList(program.get("--dists"))) {
+      dists.push_back(ParseDistribution(name));
+    }
+  }
+  std::vector<size_t> read_pcts{100, 95, 50};
+  if (program.present("--read-pcts")) {
+    read_pcts = ParseSizeList(program.get("--read-pcts"));
+  }
+  std::vector<size_t> thread_cnts{1, 4};
+  if (program.present("--threads")) {
+    thread_cnts = ParseSizeList(program.get("--threads"));
+  }
+  std::vector<size_t> bpm_sizes{64, 4096};
+  if (program.present("--bpm-sizes")) {
+    bpm_sizes = ParseSizeList(program.get("--bpm-sizes"));
+  }
+
+  std::ofstream out_file;
+  if (program.present("--output")) {
+    out_file.open(program.get("--output"));
+  }
+  std::ostream &out = out_file.is_open() ? out_file : std::cout;
+
+  out << "key_size,distribution,read_pct,threads,bpm_size,total_keys,duration_ms,reads,writes,throughput,"
+         "p50_ns,p99_ns,p999_ns,bpm_misses,dirty_evictions,tree_pages\n";
+
+  for (auto key_size : key_sizes) {
+    for (auto dist : dists) {
+      for (auto read_pct : read_pcts) {
+        for (auto threads : thread_cnts) {
+          for (auto bpm_size : bpm_sizes) {
+            BenchConfig config{key_size, dist, std::min<size_t>(read_pct, 100), threads, bpm_size, total_keys,
+                               duration_ms};
+            if (bpm_size < threads * BUSTUB_BPM_FRAMES_PER_THREAD) {
+              fmt::print(stderr, "[skip] bpm_size={} is too small for {} threads\n", bpm_size, threads);
+              continue;
+            }
+            fmt::print(stderr, "[info] key_size={} dist={} read_pct={} threads={} bpm_size={}\n", key_size,
+                       DistributionName(dist), config.read_pct_, threads, bpm_size);
+            auto result = RunConfig(config);
+            auto throughput =
+                static_cast<double>(result.read_cnt_ + result.write_cnt_) / static_cast<double>(result.elapsed_ms_) *
+                1000;
+            out << fmt::format("{},{},{},{},{},{},{},{},{},{:.2f},{},{},{},{},{},{}\n", key_size,
+                               DistributionName(dist), config.read_pct_, threads, bpm_size, total_keys,
+                               result.elapsed_ms_, result.read_cnt_, result.write_cnt_, throughput, result.p50_ns_,
+                               result.p99_ns_, result.p999_ns_, result.disk_reads_, result.disk_writes_,
+                               result.tree_pages_);
+            out.flush();
+          }
+        }
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+#include "container/disk/hash/disk_extendible_hash_table.h"
+#include "container/hash/hash_function.h"
+#include "fmt/format.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/generic_key.h"
+#include "test_util.h"
+
+/**
+ * Compares equality lookups on the B+ tree and the extendible hash table with the same keys and buffer pool size.
+ * Both indexes are loaded with keys [0, total_keys) before the timed phase, which only issues point lookups.
+ */
+
+using KeyType = bustub::GenericKey<8>;
+using ComparatorType = bustub::GenericComparator<8>;
+
+static const size_t LRU_K_SIZE = 4;
+
+auto ClockNs() -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct LookupResult {
+  uint64_t lookups_{0};
+  uint64_t hits_{0};
+  uint64_t elapsed_ns_{0};
+  uint64_t p50_ns_{0};
+  uint64_t p99_ns_{0};
+};
+
+auto Percentile(std::vector<uint64_t> *sorted, double pct) -> uint64_t {
+  if (sorted->empty()) {
+    return 0;
+  }
+  auto idx = static_cast<size_t>(pct * static_cast<double>(sorted->size() - 1));
+  return (*sorted)[idx];
+}
+
+template <typename LookupFn>
+auto RunLookups(const std::vector<size_t> &keys, LookupFn &&lookup) -> LookupResult {
+  LookupResult result;
+  std::vector<uint64_t> latencies;
+  latencies.reserve(keys.size());
+  std::vector<bustub::RID> rids;
+  KeyType index_key;
+
+  auto start = ClockNs();
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    rids.clear();
+    auto begin = ClockNs();
+    if (lookup(index_key, &rids)) {
+      result.hits_++;
+    }
+    latencies.push_back(ClockNs() - begin);
+  }
+  result.elapsed_ns_ = std::max<uint64_t>(ClockNs() - start, 1);
+  result.lookups_ = keys.size();
+
+  std::sort(latencies.begin(), latencies.end());
+  result.p50_ns_ = Percentile(&latencies, 0.50);
+  result.p99_ns_ = Percentile(&latencies, 0.99);
+  return result;
+}
+
+auto BenchBPlusTree(size_t total_keys, size_t bpm_size, const std::vector<size_t> &keys) -> LookupResult {
+  auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<bustub::BufferPoolManager>(bpm_size, disk_manager.get(), LRU_K_SIZE);
+  auto key_schema = bustub::ParseCreateStatement("a bigint");
+  ComparatorType comparator(key_schema.get());
+
+  bustub::page_id_t header_page_id;
+  bpm->NewPageGuarded(&header_page_id);
+  bustub::BPlusTree<KeyType, bustub::RID, ComparatorType> index("bench_btree", header_page_id, bpm.get(), comparator);
+
+  KeyType index_key;
+  for (size_t key = 0; key < total_keys; key++) {
+    index_key.SetFromInteger(key);
+    index.Insert(index_key, bustub::RID(static_cast<bustub::page_id_t>(key), static_cast<uint32_t>(key)), nullptr);
+  }
+  return RunLookups(keys, [&index](const KeyType &key, std::vector<bustub::RID> *rids) {
+    return index.GetValue(key, rids);
+  });
+}
+
+auto BenchHashTable(size_t total_keys, size_t bpm_size, const std::vector<size_t> &keys) -> LookupResult {
+  auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<bustub::BufferPoolManager>(bpm_size, disk_manager.get(), LRU_K_SIZE);
+  auto key_schema = bustub::ParseCreateStatement("a bigint");
+  ComparatorType comparator(key_schema.get());
+
+  bustub::DiskExtendibleHashTable<KeyType, bustub::RID, ComparatorType> index(
+      "bench_hash", bpm.get(), comparator, bustub::HashFunction<KeyType>());
+
+  KeyType index_key;
+  for (size_t key = 0; key < total_keys; key++) {
+    index_key.SetFromInteger(key);
+    if (!index.Insert(nullptr, index_key,
+                      bustub::RID(static_cast<bustub::page_id_t>(key), static_cast<uint32_t>(key)))) {
+      throw std::runtime_error(fmt::format("hash table is full after {} keys, lower --total-keys", key));
+    }
+  }
+  return RunLookups(keys, [&index](const KeyType &key, std::vector<bustub::RID> *rids) {
+    return index.GetValue(nullptr, key, rids);
+  });
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-index-lookup-bench");
+  program.add_argument("--total-keys").help("number of keys loaded into each index");
+  program.add_argument("--lookups").help("number of point lookups issued against each index");
+  program.add_argument("--bpm-size").help("buffer pool size in frames");
+  program.add_argument("--miss-pct").help("percentage of lookups for keys that are not in the index");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t total_keys = 50000;
+  if (program.present("--total-keys")) {
+    total_keys = std::stoul(program.get("--total-keys"));
+  }
+  size_t lookups = 1000000;
+  if (program.present("--lookups")) {
+    lookups = std::stoul(program.get("--lookups"));
+  }
+  size_t bpm_size = 4096;
+  if (program.present("--bpm-size")) {
+    bpm_size = std::stoul(program.get("--bpm-size"));
+  }
+  size_t miss_pct = 0;
+  if (program.present("--miss-pct")) {
+    miss_pct = std::min<size_t>(std::stoul(program.get("--miss-pct")), 100);
+  }
+
+  // Both indexes see exactly the same lookup sequence.
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<size_t> hit_dist(0, total_keys - 1);
+  std::uniform_int_distribution<size_t> percent(0, 99);
+  std::vector<size_t> keys;
+  keys.reserve(lookups);
+  for (size_t i = 0; i < lookups; i++) {
+    keys.push_back(percent(gen) < miss_pct ? total_keys + hit_dist(gen) : hit_dist(gen));
+  }
+
+  std::cout << "index,total_keys,bpm_size,lookups,hits,throughput,p50_ns,p99_ns\n";
+  auto report = [&](const std::string &name, const LookupResult &result) {
+    auto throughput = static_cast<double>(result.lookups_) / static_cast<double>(result.elapsed_ns_) * 1e9;
+    std::cout << fmt::format("{},{},{},{},{},{:.2f},{},{}\n", name, total_keys, bpm_size, result.lookups_,
+                             result.hits_, throughput, result.p50_ns_, result.p99_ns_);
+  };
+  report("bplustree", BenchBPlusTree(total_keys, bpm_size, keys));
+  report("extendible_hash", BenchHashTable(total_keys, bpm_size, keys));
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "fmt/format.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+/**
+ * Measures TableHeap insert throughput as the number of inserting threads grows. Every run inserts into a fresh
+ * table; each thread inserts --tuples-per-thread tuples of an integer and a --payload byte varchar.
+ */
+
+static const size_t LRU_K_SIZE = 4;
+
+auto ClockNs() -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+auto RunInserts(size_t threads, size_t tuples_per_thread, size_t payload, size_t bpm_size) -> uint64_t {
+  auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<bustub::BufferPoolManager>(bpm_size, disk_manager.get(), LRU_K_SIZE);
+  bustub::Schema schema(
+      {bustub::Column("id", bustub::TypeId::INTEGER), bustub::Column("payload", bustub::TypeId::VARCHAR, payload)});
+  bustub::TableHeap table(bpm.get());
+  bustub::TupleMeta meta{bustub::INVALID_TXN_ID, bustub::INVALID_TXN_ID, false};
+
+  // tuples are built up front so the timed phase only measures the heap
+  std::vector<std::vector<bustub::Tuple>> tuples(threads);
+  for (size_t t = 0; t < threads; t++) {
+    tuples[t].reserve(tuples_per_thread);
+    for (size_t i = 0; i < tuples_per_thread; i++) {
+      std::vector<bustub::Value> values{bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(i)),
+                                        bustub::ValueFactory::GetVarcharValue(std::string(payload, 'x'))};
+      tuples[t].emplace_back(values, &schema);
+    }
+  }
+
+  auto start = ClockNs();
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; t++) {
+    workers.emplace_back([&table, &meta, &tuples, t] {
+      for (const auto &tuple : tuples[t]) {
+        table.InsertTuple(meta, tuple);
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  return std::max<uint64_t>(ClockNs() - start, 1);
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-insert-bench");
+  program.add_argument("--threads").help("comma separated numbers of inserting threads, e.g. 1,2,4,8");
+  program.add_argument("--tuples-per-thread").help("number of tuples each thread inserts");
+  program.add_argument("--payload").help("size of the varchar column in bytes");
+  program.add_argument("--bpm-size").help("buffer pool size in frames");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  std::vector<size_t> thread_counts{1, 2, 4, 8};
+  if (program.present("--threads")) {
+    thread_counts.clear();
+    std::stringstream ss(program.get("--threads"));
+    std::string count;
+    while (std::getline(ss, count, ',')) {
+      thread_counts.push_back(std::stoul(count));
+    }
+  }
+  size_t tuples_per_thread = 100000;
+  if (program.present("--tuples-per-thread")) {
+    tuples_per_thread = std::stoul(program.get("--tuples-per-thread"));
+  }
+  size_t payload = 64;
+  if (program.present("--payload")) {
+    payload = std::stoul(program.get("--payload"));
+  }
+  size_t bpm_size = 8192;
+  if (program.present("--bpm-size")) {
+    bpm_size = std::stoul(program.get("--bpm-size"));
+  }
+
+  std::cout << "threads,tuples,payload,elapsed_ms,inserts_per_sec\n";
+  for (auto threads : thread_counts) {
+    auto elapsed_ns = RunInserts(threads, tuples_per_thread, payload, bpm_size);
+    auto total = threads * tuples_per_thread;
+    auto throughput = static_cast<double>(total) / static_cast<double>(elapsed_ns) * 1e9;
+    std::cout << fmt::format("{},{},{},{},{:.2f}\n", threads, total, payload, elapsed_ns / 1000000, throughput);
+  }
+
+  return 0;
+}
@@ -110,6 +110,18 @@ auto ProcessExtraOptions(const std::string &sql, bustub::BustubInstance &instanc
           fmt::print("NestedIndexJoin not found\n");
           return false;
         }
+      } else if (opt == "ensure:column_scan") {
+        if (!bustub::StringUtil::Contains(result.str(), "columns=[")) {
+          fmt::print("SeqScan reading only some columns not found\n");
+          return false;
+        }
+      } else if (opt == "ensure:filter_scan") {
+        // the planner output above the optimized plan still has the Filter node
+        auto optimized = result.str().substr(result.str().find("=== OPTIMIZER ==="));
+        if (!bustub::StringUtil::Contains(optimized, "filter=") || bustub::StringUtil::Contains(optimized, "Filter {")) {
+          fmt::print("SeqScan with a merged filter not found\n");
+          return false;
+        }
       } else if (opt == "ensure:nlj_init_check") {
         if (!bustub::StringUtil::Contains(result.str(), "NestedLoopJoin")) {
           fmt::print("NestedLoopJoin not found\n");
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "fmt/format.h"
+#include "primer/trie.h"
+
+/**
+ * Compares prefix scans ("all keys under tenant/123/") on a Trie snapshot with the same scans on a std::map using
+ * lower_bound. Keys are tenant/<t>/<i> for every tenant and item; each scan picks a random tenant and reads at most
+ * --limit of its keys.
+ */
+
+auto ClockNs() -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct ScanResult {
+  uint64_t scans_{0};
+  uint64_t rows_{0};
+  uint64_t checksum_{0};
+  uint64_t elapsed_ns_{0};
+};
+
+template <typename ScanFn>
+auto RunScans(const std::vector<std::string> &prefixes, ScanFn &&scan) -> ScanResult {
+  ScanResult result;
+  auto start = ClockNs();
+  for (const auto &prefix : prefixes) {
+    scan(prefix, &result);
+  }
+  result.elapsed_ns_ = std::max<uint64_t>(ClockNs() - start, 1);
+  result.scans_ = prefixes.size();
+  return result;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-trie-scan-bench");
+  program.add_argument("--tenants").help("number of distinct tenant prefixes");
+  program.add_argument("--keys-per-tenant").help("number of keys under each tenant");
+  program.add_argument("--scans").help("number of prefix scans issued against each structure");
+  program.add_argument("--limit").help("maximum number of keys read by each scan");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t tenants = 1000;
+  if (program.present("--tenants")) {
+    tenants = std::stoul(program.get("--tenants"));
+  }
+  size_t keys_per_tenant = 100;
+  if (program.present("--keys-per-tenant")) {
+    keys_per_tenant = std::stoul(program.get("--keys-per-tenant"));
+  }
+  size_t scans = 100000;
+  if (program.present("--scans")) {
+    scans = std::stoul(program.get("--scans"));
+  }
+  size_t limit = 20;
+  if (program.present("--limit")) {
+    limit = std::stoul(program.get("--limit"));
+  }
+
+  auto trie = bustub::Trie();
+  std::map<std::string, uint32_t> map;
+  uint32_t value = 0;
+  for (size_t tenant = 0; tenant < tenants; tenant++) {
+    for (size_t i = 0; i < keys_per_tenant; i++) {
+      auto key = fmt::format("tenant/{}/item/{}", tenant, i);
+      trie = trie.Put<uint32_t>(key, value);
+      map.emplace(key, value);
+      value++;
+    }
+  }
+
+  // Both structures see exactly the same prefixes.
+  std::mt19937_64 gen(42);
+  std::vector<std::string> prefixes;
+  prefixes.reserve(scans);
+  for (size_t i = 0; i < scans; i++) {
+    prefixes.push_back(fmt::format("tenant/{}/", gen() % tenants));
+  }
+
+  std::cout << "structure,keys,scans,limit,rows,scans_per_sec,checksum\n";
+  auto report = [&](const std::string &name, const ScanResult &result) {
+    auto throughput = static_cast<double>(result.scans_) / static_cast<double>(result.elapsed_ns_) * 1e9;
+    std::cout << fmt::format("{},{},{},{},{},{:.2f},{}\n", name, map.size(), result.scans_, limit, result.rows_,
+                             throughput, result.checksum_);
+  };
+  report("trie", RunScans(prefixes, [&trie, limit](const std::string &prefix, ScanResult *result) {
+           for (auto it = trie.PrefixScan(prefix, limit); !it.IsEnd(); ++it) {
+             result->rows_++;
+             result->checksum_ += *it.Value<uint32_t>() + it.Key().size();
+           }
+         }));
+  report("std_map", RunScans(prefixes, [&map, limit](const std::string &prefix, ScanResult *result) {
+           size_t rows = 0;
+           for (auto it = map.lower_bound(prefix); it != map.end() && rows < limit; ++it, ++rows) {
+             if (it->first.compare(0, prefix.size(), prefix) != 0) {
+               break;
+             }
+             result->rows_++;
+             result->checksum_ += it->second + it->first.size();
+           }
+         }));
+
+  return 0;
+}